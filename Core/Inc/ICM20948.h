@@ -1,6 +1,9 @@
 #ifndef ICM20948_H_
 #define ICM20948_H_
 
+#include "main.h"
+#include <stdbool.h>
+#include <stdint.h>
 
 #define ICM20948_ADDR 				(0x68)
 
@@ -65,7 +68,11 @@
 #define AK09916_CNTL2    			(0x31)  // Normal (0), Reset (1)
 
 // Gyro/Accel Config (Bank 2)
+#define ICM20948_GYRO_SMPLRT_DIV    (0x00)
 #define ICM20948_GYRO_CONFIG_1      (0x01)
+#define ICM20948_ODR_ALIGN_EN       (0x09)
+#define ICM20948_ACCEL_SMPLRT_DIV_1 (0x10)
+#define ICM20948_ACCEL_SMPLRT_DIV_2 (0x11)
 #define ICM20948_ACCEL_CONFIG       (0x14)
 
 #define ICM20948_EXT_SENS_DATA_00   (0x3B)
@@ -135,6 +142,14 @@ typedef struct {
     int16_t z;
 } ICM_Axis3D;
 
+/* Register access counters, for checking how much bus traffic the shadow saves */
+typedef struct {
+    uint32_t transactions;                  /* Blocking I2C transactions issued */
+    uint32_t bank_skipped;                  /* Bank selects already in effect */
+    uint32_t writes_skipped;                /* Writes matching the shadowed value */
+    uint32_t reads_cached;                  /* Config reads served from the shadow */
+} ICM_BusStats;
+
 uint8_t ICM_WHOAMI(void);
 uint8_t ICM_Init(void);
 float ICM_ReadTemperature(void);
@@ -142,5 +157,63 @@ uint8_t ICM_ReadAccel(ICM_Axis3D *accel);
 uint8_t ICM_ReadGyro(ICM_Axis3D *gyro);
 uint8_t ICM_ReadMag(ICM_Axis3D *mag);
 void ICM_DumpRegisters(void);
+void ICM_GetBusStats(ICM_BusStats *stats);
+
+/*
+ * Interrupt-driven sampling at the full 1125 Hz ODR. Each data-ready edge
+ * on INT1 is timestamped and starts one DMA burst read of accel, gyro,
+ * temperature and the magnetometer bytes the ICM's I2C master mirrors into
+ * EXT_SENS_DATA; completed reads land in a sample queue.
+ */
+#define ICM_BURST_REG               ICM20948_ACCEL_XOUT_H
+#define ICM_BURST_LEN               22      /* ACCEL_XOUT_H .. EXT_SENS_DATA_07 */
+#define ICM_SAMPLE_QUEUE            64      /* Samples buffered for the consumer */
+#define ICM_ODR_HZ                  1125    /* Gyro/accel rate with both dividers at 0 */
+
+typedef struct {
+    uint64_t timestamp;                     /* DWT cycles at the data-ready edge */
+    ICM_Axis3D accel;
+    ICM_Axis3D gyro;
+    int16_t temp;
+    ICM_Axis3D mag;
+    uint8_t mag_status;                     /* AK09916 ST2 */
+} ICM_Sample;
+
+typedef struct {
+    uint32_t samples;                       /* Samples read, burst reads or FIFO frames */
+    uint32_t bus_busy;                      /* Data-ready edges skipped, I2C1 in use elsewhere */
+    uint32_t overruns;                      /* Edges arriving while the previous read was in flight */
+    uint32_t queue_full;                    /* Samples dropped, consumer too slow */
+    uint32_t errors;                        /* Failed reads */
+    uint32_t batches;                       /* FIFO drains */
+    uint32_t fifo_overflows;                /* Drains that found the FIFO full */
+} ICM_SamplingStats;
+
+/*
+ * FIFO batching: accel and gyro frames collect in the on-chip FIFO and are
+ * drained in one burst per watermark, trading latency for far fewer I2C
+ * transactions and wake-ups than one read per sample.
+ */
+#define ICM_FIFO_SIZE               4096    /* On-chip FIFO bytes */
+#define ICM_FIFO_FRAME              12      /* ACCEL_XOUT_H .. GYRO_ZOUT_L */
+#define ICM_FIFO_MAX_FRAMES         (ICM_FIFO_SIZE / ICM_FIFO_FRAME)
+
+typedef struct {
+    ICM_Axis3D accel[ICM_FIFO_MAX_FRAMES];
+    ICM_Axis3D gyro[ICM_FIFO_MAX_FRAMES];
+    uint16_t frames;
+    bool overflow;                          /* FIFO filled up, frames after the last one were lost */
+    uint64_t timestamp;                     /* DWT cycles when FIFO_COUNT was read, ~last frame */
+} ICM_FifoBatch;
+
+uint8_t ICM_StartSampling(void);
+void ICM_StopSampling(void);
+uint8_t ICM_StartFifo(uint16_t watermark);
+bool ICM_FifoProcess(ICM_FifoBatch *batch);
+uint16_t ICM_FifoParse(const uint8_t *buf, uint16_t len, uint16_t fifo_count, ICM_FifoBatch *batch);
+bool ICM_GetSample(ICM_Sample *sample);
+void ICM_GetSamplingStats(ICM_SamplingStats *stats);
+void ICM_EXTI_Callback(void);
+void ICM_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
 
 #endif /* ICM20948_H_ */
@@ -0,0 +1,50 @@
+/*
+ * bitstore.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef INC_BITSTORE_H_
+#define INC_BITSTORE_H_
+
+#include "main.h"
+#include "fpga_source.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Bitstream slots in flash bank 2: 4 slots of 2 sectors (256 KB) each.
+ * Every slot starts with one 32-byte flash word header ("XSLT", image
+ * length, CRC16-CCITT of the image) followed by the image, either a raw
+ * Lattice bitstream or an XLZ4 container.
+ */
+#define BITSTORE_BASE             FLASH_BANK2_BASE
+#define BITSTORE_SLOT_SECTORS     2U
+#define BITSTORE_SLOT_SIZE        (BITSTORE_SLOT_SECTORS * FLASH_SECTOR_SIZE)
+#define BITSTORE_NUM_SLOTS        4U
+#define BITSTORE_HDR_SIZE         32U
+#define BITSTORE_MAX_IMAGE        (BITSTORE_SLOT_SIZE - BITSTORE_HDR_SIZE)
+#define BITSTORE_NAME_LEN         32U
+
+typedef struct {
+    bool valid;
+    bool compressed;                    /* XLZ4 container */
+    const uint8_t *image;
+    uint32_t image_len;
+    uint16_t crc;                       /* "Bitstream CRC" from the Lattice header */
+    uint16_t image_crc;                 /* CRC16-CCITT of the raw image, checked while streaming */
+    uint16_t slot_crc;                  /* CRC16-CCITT of the stored bytes (XLZ4 container if compressed) */
+    char name[BITSTORE_NAME_LEN];       /* "Design name" without the .ncd suffix */
+    char part[BITSTORE_NAME_LEN];
+    char date[BITSTORE_NAME_LEN];
+} bitstore_entry_t;
+
+void bitstore_init(void);
+const bitstore_entry_t *bitstore_entry(uint32_t slot);
+int bitstore_find_by_name(const char *name);
+int bitstore_find_by_crc(uint16_t crc);
+fpga_source_t *bitstore_source(uint32_t slot);
+int bitstore_program(uint32_t slot, const uint8_t *image, uint32_t len);
+int bitstore_parse_header(const uint8_t *image, uint32_t len, bitstore_entry_t *entry);
+
+#endif /* INC_BITSTORE_H_ */
@@ -0,0 +1,292 @@
+#ifndef bitstream_lz4_H
+#define bitstream_lz4_H
+
+#include <stdint.h>
+
+/* Generated by Tools/bitpack.py from a 163488 byte bitstream, do not edit */
+#define bitstream_lz4_SIZE 3358
+const uint8_t bitstream_lz4[3358] = {
+0x58, 0x4C, 0x5A, 0x34, 0xA0, 0x7E, 0x02, 0x00, 0x00, 0x10, 0xBE, 0x2D,
+0x7C, 0x01, 0xF4, 0x28, 0xFF, 0x00, 0x4C, 0x61, 0x74, 0x74, 0x69, 0x63,
+0x65, 0x20, 0x53, 0x65, 0x6D, 0x69, 0x63, 0x6F, 0x6E, 0x64, 0x75, 0x63,
+0x74, 0x6F, 0x72, 0x20, 0x43, 0x6F, 0x72, 0x70, 0x6F, 0x72, 0x61, 0x74,
+0x69, 0x6F, 0x6E, 0x20, 0x42, 0x69, 0x74, 0x73, 0x74, 0x72, 0x65, 0x61,
+0x6D, 0x00, 0x56, 0x65, 0x72, 0x73, 0x69, 0x6F, 0x6E, 0x3A, 0x20, 0x01,
+0x00, 0xF5, 0x0E, 0x44, 0x69, 0x61, 0x6D, 0x6F, 0x6E, 0x64, 0x20, 0x28,
+0x36, 0x34, 0x2D, 0x62, 0x69, 0x74, 0x29, 0x20, 0x33, 0x2E, 0x31, 0x33,
+0x2E, 0x30, 0x2E, 0x35, 0x36, 0x2E, 0x32, 0x00, 0x38, 0x00, 0xF3, 0x00,
+0x20, 0x53, 0x74, 0x61, 0x74, 0x75, 0x73, 0x3A, 0x20, 0x46, 0x69, 0x6E,
+0x61, 0x6C, 0x20, 0x46, 0x00, 0xF0, 0x4A, 0x20, 0x34, 0x2E, 0x39, 0x00,
+0x44, 0x65, 0x73, 0x69, 0x67, 0x6E, 0x20, 0x6E, 0x61, 0x6D, 0x65, 0x3A,
+0x20, 0x54, 0x65, 0x73, 0x74, 0x43, 0x75, 0x73, 0x74, 0x6F, 0x6D, 0x5F,
+0x69, 0x6D, 0x70, 0x6C, 0x31, 0x2E, 0x6E, 0x63, 0x64, 0x00, 0x41, 0x72,
+0x63, 0x68, 0x69, 0x74, 0x65, 0x63, 0x74, 0x75, 0x72, 0x65, 0x3A, 0x20,
+0x73, 0x6E, 0x35, 0x77, 0x30, 0x30, 0x00, 0x50, 0x61, 0x72, 0x74, 0x3A,
+0x20, 0x4C, 0x49, 0x46, 0x2D, 0x4D, 0x44, 0x36, 0x30, 0x30, 0x30, 0x2D,
+0x36, 0x57, 0x4C, 0x43, 0x53, 0x50, 0x33, 0x36, 0x00, 0x44, 0x61, 0x74,
+0x4A, 0x00, 0xF1, 0x1D, 0x75, 0x65, 0x20, 0x41, 0x70, 0x72, 0x20, 0x31,
+0x35, 0x20, 0x31, 0x38, 0x3A, 0x32, 0x30, 0x3A, 0x34, 0x36, 0x20, 0x32,
+0x30, 0x32, 0x35, 0x00, 0x52, 0x6F, 0x77, 0x73, 0x3A, 0x20, 0x35, 0x36,
+0x32, 0x34, 0x00, 0x43, 0x6F, 0x6C, 0x73, 0x3A, 0x20, 0x32, 0x30, 0x36,
+0xA9, 0x00, 0xF2, 0x03, 0x3A, 0x20, 0x31, 0x31, 0x35, 0x38, 0x35, 0x34,
+0x34, 0x00, 0x52, 0x65, 0x61, 0x64, 0x62, 0x61, 0x63, 0x6B, 0xE6, 0x00,
+0xC6, 0x4F, 0x66, 0x66, 0x00, 0x53, 0x65, 0x63, 0x75, 0x72, 0x69, 0x74,
+0x79, 0x12, 0x00, 0x06, 0xDB, 0x00, 0xFF, 0x23, 0x43, 0x52, 0x43, 0x3A,
+0x20, 0x30, 0x78, 0x44, 0x43, 0x39, 0x33, 0x00, 0xFF, 0xFF, 0xFF, 0xBD,
+0xB3, 0xFF, 0xFF, 0xFF, 0xFF, 0x3B, 0x00, 0x00, 0x00, 0xE2, 0x00, 0x00,
+0x00, 0x01, 0x2C, 0x00, 0x43, 0x22, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00,
+0x3C, 0x46, 0x00, 0x00, 0x00, 0x82, 0x91, 0x15, 0xF8, 0x00, 0x01, 0x00,
+0x06, 0x3F, 0x8F, 0x1F, 0xFF, 0x1D, 0x00, 0x07, 0x2F, 0xC0, 0xD7, 0x1D,
+0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0x4B, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x26, 0x00,
+0x17, 0x00, 0x01, 0x00, 0x38, 0xC0, 0xD7, 0xFF, 0x0F, 0x00, 0x0A, 0x01,
+0x00, 0x0F, 0x1D, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xCE, 0x50, 0x00, 0x00, 0x00,
+0x00, 0x00, 0x27, 0x00, 0x10, 0x00, 0x01, 0x00, 0x31, 0xC0, 0xD7, 0xFF,
+0x08, 0x00, 0x0F, 0x01, 0x00, 0x02, 0x0F, 0x1D, 0x00, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xD5, 0x50, 0x00, 0x00, 0x00, 0xC0, 0xD7, 0x21, 0x00, 0x2F, 0xFF, 0x00,
+0x01, 0x00, 0x06, 0x2F, 0xC0, 0xD7, 0x1D, 0x00, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xDA,
+0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x25, 0x00, 0x1F, 0x00, 0x01, 0x00,
+0x00, 0x3F, 0xC0, 0xD7, 0xFF, 0x17, 0x00, 0x01, 0x0F, 0x1D, 0x00, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xCC, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x23, 0x00, 0x18,
+0x00, 0x01, 0x00, 0x39, 0xC0, 0xD7, 0xFF, 0x10, 0x00, 0x0F, 0x1D, 0x00,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xDA, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3D, 0x00,
+0x11, 0x00, 0x01, 0x00, 0x32, 0xC0, 0xD7, 0xFF, 0x09, 0x00, 0x0F, 0x01,
+0x00, 0x01, 0x0F, 0x1D, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEC, 0x1F, 0x10, 0x1D, 0x00, 0x06,
+0x2F, 0x93, 0x29, 0x3A, 0x00, 0x28, 0x0F, 0x57, 0x00, 0x44, 0x0F, 0x3A,
+0x00, 0x0A, 0x0F, 0x1D, 0x00, 0xFF, 0x09, 0x50, 0x00, 0x00, 0x00, 0x00,
+0xC0, 0x21, 0x00, 0x3F, 0xD7, 0xFF, 0x00, 0x01, 0x00, 0x06, 0x1F, 0xC0,
+0x1D, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xDA, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00,
+0x25, 0x00, 0x1F, 0x00, 0x01, 0x00, 0x01, 0x3F, 0xC0, 0xD7, 0xFF, 0x18,
+0x00, 0x02, 0x0F, 0x1D, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xCA, 0x50, 0x00, 0x00,
+0x00, 0x00, 0x00, 0x23, 0x00, 0x19, 0x00, 0x01, 0x00, 0x3A, 0xC0, 0xD7,
+0xFF, 0x11, 0x00, 0x0F, 0x1D, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xD8, 0x50, 0x00,
+0x00, 0x00, 0x00, 0x00, 0x27, 0x00, 0x12, 0x00, 0x01, 0x00, 0x33, 0xC0,
+0xD7, 0xFF, 0x0A, 0x00, 0x0F, 0x01, 0x00, 0x00, 0x0F, 0x1D, 0x00, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xD3, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x21, 0x00, 0x4F,
+0xC0, 0xD7, 0xFF, 0x00, 0x01, 0x00, 0x06, 0x0F, 0x1D, 0x00, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xDA, 0x50, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x25, 0x00, 0x1F, 0x00,
+0x01, 0x00, 0x02, 0x3F, 0xC0, 0xD7, 0xFF, 0x19, 0x00, 0x03, 0x0F, 0x1D,
+0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xC8, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x23,
+0x00, 0x1A, 0x00, 0x01, 0x00, 0x3B, 0xC0, 0xD7, 0xFF, 0x12, 0x00, 0x0F,
+0x1D, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xD6, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00,
+0x26, 0x00, 0x13, 0x00, 0x01, 0x00, 0x34, 0xC0, 0xD7, 0xFF, 0x0B, 0x00,
+0x0E, 0x01, 0x00, 0x0F, 0x1D, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xD2, 0x50, 0x00,
+0x00, 0x00, 0x00, 0x00, 0x22, 0x00, 0x5F, 0x00, 0xC0, 0xD7, 0xFF, 0x00,
+0x01, 0x00, 0x06, 0x0F, 0x1D, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xD9, 0x50, 0xD7,
+0xFF, 0x00, 0x00, 0x00, 0x25, 0x00, 0x1F, 0x00, 0x01, 0x00, 0x03, 0x3F,
+0xC0, 0xD7, 0xFF, 0x1A, 0x00, 0x04, 0x0F, 0x1D, 0x00, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xC6, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x23, 0x00, 0x1B, 0x00, 0x01,
+0x00, 0x3C, 0xC0, 0xD7, 0xFF, 0x13, 0x00, 0x0F, 0x1D, 0x00, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xD4, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x26, 0x00, 0x14, 0x00,
+0x01, 0x00, 0x35, 0xC0, 0xD7, 0xFF, 0x0C, 0x00, 0x0D, 0x01, 0x00, 0x0F,
+0x1D, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xD1, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00,
+0x41, 0x00, 0x6F, 0x00, 0x00, 0xC0, 0xD7, 0xFF, 0x00, 0x01, 0x00, 0x06,
+0x0F, 0x1D, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x10, 0x1F, 0x10, 0x1D, 0x00, 0x06,
+0x4F, 0x93, 0x29, 0xFF, 0x04, 0x1D, 0x00, 0x06, 0x2F, 0x14, 0x2A, 0x57,
+0x00, 0x0B, 0x1F, 0x02, 0x1D, 0x00, 0x06, 0x2F, 0x6A, 0xAB, 0xCB, 0x00,
+0x42, 0x50, 0xC0, 0xD7, 0xFF, 0x00, 0x00, 0x33, 0x00, 0x1F, 0x00, 0x01,
+0x00, 0x04, 0x3F, 0xC0, 0xD7, 0xFF, 0x1B, 0x00, 0x05, 0x0F, 0x1D, 0x00,
+0x49, 0x1F, 0x10, 0x1D, 0x00, 0x06, 0x2F, 0x93, 0x29, 0x91, 0x00, 0x62,
+0x0F, 0x1D, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xD6, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00,
+0x2D, 0x00, 0x1C, 0x00, 0x01, 0x00, 0x3D, 0xC0, 0xD7, 0xFF, 0x14, 0x00,
+0x0F, 0x1D, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xD8, 0x1F, 0x10, 0x1D, 0x00, 0x06, 0x2F, 0x93,
+0x29, 0x0A, 0x02, 0xFF, 0xCA, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x26,
+0x00, 0x15, 0x00, 0x01, 0x00, 0x36, 0xC0, 0xD7, 0xFF, 0x0D, 0x00, 0x0C,
+0x01, 0x00, 0x0F, 0x1D, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xD0, 0x50, 0x00, 0x00,
+0x00, 0x00, 0x00, 0x37, 0x00, 0x7F, 0x00, 0x00, 0x00, 0xC0, 0xD7, 0xFF,
+0x00, 0x01, 0x00, 0x06, 0x0F, 0x1D, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x4A, 0x1F,
+0x10, 0x1D, 0x00, 0x06, 0x2F, 0x93, 0x29, 0x1D, 0x00, 0x28, 0x0F, 0x1C,
+0x00, 0x06, 0x0F, 0x91, 0x00, 0x0A, 0x50, 0x00, 0xC0, 0xD7, 0xFF, 0x00,
+0x39, 0x00, 0x1F, 0x00, 0x01, 0x00, 0x05, 0x3F, 0xC0, 0xD7, 0xFF, 0x1C,
+0x00, 0x06, 0x0F, 0x1D, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0x90, 0x19, 0x10, 0x1D, 0x00, 0x2F, 0x50, 0xC4, 0x7E,
+0x02, 0xFF, 0xFF, 0x7A, 0x0F, 0x1D, 0x00, 0x27, 0x0A, 0x01, 0x00, 0x0F,
+0xB8, 0x02, 0xFF, 0xFF, 0x39, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x23,
+0x00, 0x1D, 0x00, 0x01, 0x00, 0x3E, 0xC0, 0xD7, 0xFF, 0x15, 0x00, 0x0F,
+0x1D, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xD0, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00,
+0x26, 0x00, 0x16, 0x00, 0x01, 0x00, 0x37, 0xC0, 0xD7, 0xFF, 0x0E, 0x00,
+0x0B, 0x01, 0x00, 0x0F, 0x1D, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xCF, 0x50, 0x00,
+0x00, 0x00, 0x00, 0x00, 0x8E, 0x00, 0x70, 0x00, 0x00, 0x00, 0x00, 0xC0,
+0xD7, 0xFF, 0x07, 0x00, 0x0F, 0x01, 0x00, 0x03, 0x0F, 0x1D, 0x00, 0xFF,
+0xFF, 0xFF, 0xFF, 0x2A, 0x1F, 0x04, 0x1D, 0x00, 0x01, 0x2F, 0x24, 0x91,
+0x57, 0x00, 0x2D, 0x1F, 0x02, 0x1D, 0x00, 0x01, 0x2F, 0xB2, 0xF4, 0x3A,
+0x00, 0x0B, 0x1F, 0x08, 0x1D, 0x00, 0x06, 0x2F, 0xE9, 0x28, 0x31, 0x04,
+0xFF, 0xFF, 0xFF, 0x5E, 0x1E, 0x20, 0x1D, 0x00, 0x4F, 0x4F, 0xDB, 0xFF,
+0x10, 0x3A, 0x00, 0x06, 0x2F, 0x93, 0x29, 0x1D, 0x00, 0x0B, 0x0F, 0x57,
+0x00, 0x0A, 0x0F, 0x39, 0x00, 0x06, 0x0F, 0x0B, 0x08, 0xFF, 0xFF, 0xFF,
+0x5F, 0x0F, 0x1D, 0x00, 0x79, 0x0F, 0x40, 0x08, 0x02, 0x01, 0x01, 0x00,
+0x2F, 0x6A, 0xAB, 0x3A, 0x00, 0x0B, 0x0F, 0x64, 0x04, 0x00, 0x03, 0x01,
+0x00, 0x2F, 0x67, 0x2B, 0x91, 0x00, 0x28, 0x0F, 0x28, 0x09, 0x02, 0x01,
+0x01, 0x00, 0x2F, 0x14, 0x2A, 0x0F, 0x03, 0xFF, 0xFF, 0x4C, 0x50, 0x00,
+0x00, 0xC0, 0xD7, 0xFF, 0x8F, 0x00, 0x1F, 0x00, 0x01, 0x00, 0x06, 0x3F,
+0xC0, 0xD7, 0xFF, 0x1D, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0x12, 0x1F, 0x40, 0x1D, 0x00, 0x00, 0x2F, 0x5E, 0x90,
+0x57, 0x00, 0x2E, 0x1F, 0x20, 0x1D, 0x00, 0x00, 0x2F, 0x4F, 0xF6, 0xED,
+0x01, 0xFF, 0x68, 0x12, 0x04, 0x0A, 0x00, 0x0F, 0x97, 0x01, 0x00, 0x24,
+0x9B, 0x26, 0x3A, 0x00, 0x0F, 0x0B, 0x02, 0x00, 0x2F, 0x5E, 0xCA, 0x57,
+0x00, 0x0B, 0x1F, 0x02, 0x1D, 0x00, 0x06, 0x2F, 0x6A, 0xAB, 0x22, 0x01,
+0x84, 0x1F, 0x10, 0x1D, 0x00, 0x01, 0x2F, 0x51, 0xC5, 0xED, 0x01, 0xA1,
+0x1F, 0x08, 0x1D, 0x00, 0x01, 0x2F, 0x88, 0x5E, 0x3A, 0x00, 0x10, 0x0F,
+0x9F, 0x03, 0x01, 0x2F, 0x00, 0x62, 0xA0, 0x03, 0x85, 0x0F, 0xA4, 0x04,
+0x01, 0x2F, 0x00, 0x04, 0xA5, 0x04, 0x2F, 0x0F, 0x1D, 0x00, 0x0A, 0x0F,
+0x19, 0x05, 0x27, 0x0F, 0xFC, 0x04, 0x0A, 0x0F, 0x70, 0x05, 0x40, 0x50,
+0x00, 0x00, 0x00, 0x00, 0x00, 0xA6, 0x01, 0x1E, 0x00, 0x01, 0x00, 0x30,
+0xC0, 0xD7, 0xFF, 0x07, 0x00, 0x2F, 0x01, 0x80, 0x1C, 0x00, 0x00, 0x31,
+0x00, 0xD9, 0x4A, 0x1D, 0x00, 0x3F, 0x00, 0x00, 0x40, 0x1D, 0x00, 0x00,
+0x2F, 0x5E, 0x90, 0x3A, 0x00, 0x11, 0x0F, 0x01, 0x00, 0x01, 0x03, 0x74,
+0x00, 0x0F, 0x1D, 0x00, 0x46, 0x1F, 0x20, 0x1D, 0x00, 0x00, 0x2F, 0x4F,
+0xF6, 0xAE, 0x00, 0x0F, 0x0F, 0x1D, 0x00, 0x0C, 0x0F, 0x57, 0x00, 0x01,
+0x2F, 0x56, 0x6B, 0x57, 0x00, 0x2E, 0x0F, 0x1D, 0x00, 0xFF, 0xFF, 0x4F,
+0x0F, 0x1C, 0x00, 0x01, 0x3F, 0x00, 0xD1, 0xC1, 0x1D, 0x00, 0x10, 0x0F,
+0x74, 0x00, 0x9A, 0x0F, 0x01, 0x00, 0x03, 0x0F, 0x14, 0x04, 0x11, 0x0F,
+0x3A, 0x00, 0x0B, 0x1F, 0xA8, 0x1D, 0x00, 0x01, 0x2F, 0x22, 0xF4, 0x19,
+0x05, 0x10, 0x1F, 0xC0, 0x3A, 0x00, 0x01, 0x2F, 0x1D, 0x0D, 0x74, 0x00,
+0x10, 0x1F, 0x10, 0x1D, 0x00, 0x01, 0x2F, 0x51, 0xC5, 0x19, 0x05, 0x2C,
+0x0F, 0x3F, 0x01, 0x28, 0x0F, 0x3A, 0x00, 0x02, 0x2F, 0xC8, 0x5C, 0xD0,
+0x01, 0x0F, 0x0F, 0x57, 0x00, 0x0B, 0x0F, 0x1D, 0x00, 0x09, 0x0F, 0x0A,
+0x02, 0x44, 0x0F, 0xAE, 0x00, 0x0B, 0x0F, 0xE8, 0x00, 0x0A, 0x0F, 0x74,
+0x00, 0x7D, 0x0F, 0x1D, 0x00, 0xFF, 0xDB, 0x0F, 0x83, 0x03, 0x44, 0x0F,
+0x74, 0x00, 0x0B, 0x1F, 0xA2, 0x1D, 0x00, 0x01, 0x23, 0x18, 0x5E, 0x74,
+0x00, 0x0F, 0xFC, 0x04, 0x01, 0x2F, 0x4F, 0x86, 0x74, 0x00, 0x10, 0x1F,
+0xA4, 0x1D, 0x00, 0x01, 0x2F, 0x9F, 0x2D, 0xA5, 0x04, 0x2D, 0x1F, 0x42,
+0x91, 0x00, 0x01, 0x12, 0xE8, 0xAA, 0x05, 0x1F, 0x01, 0x01, 0x06, 0x02,
+0x22, 0x5E, 0xE0, 0x3A, 0x00, 0x1F, 0xC4, 0x57, 0x00, 0x01, 0x2F, 0xE8,
+0x5D, 0xE4, 0x05, 0x10, 0x1F, 0x81, 0x1D, 0x00, 0x01, 0x22, 0xBE, 0x1E,
+0x3A, 0x00, 0x0F, 0x1C, 0x00, 0x01, 0x22, 0x00, 0x04, 0x3A, 0x00, 0x0F,
+0x92, 0x06, 0x0B, 0x1F, 0x20, 0x3C, 0x06, 0x01, 0x22, 0x40, 0x3A, 0x1D,
+0x00, 0x1F, 0x50, 0x57, 0x00, 0x01, 0x2F, 0x95, 0x82, 0x22, 0x01, 0x10,
+0x0F, 0x91, 0x00, 0x09, 0x0F, 0x79, 0x01, 0x0B, 0x1F, 0x08, 0x3B, 0x00,
+0x01, 0x2F, 0x16, 0x19, 0x1E, 0x06, 0x85, 0x0F, 0xAB, 0x0B, 0x08, 0x0F,
+0x57, 0x00, 0x0A, 0x0F, 0x1D, 0x00, 0x0A, 0x0F, 0x02, 0x0C, 0x27, 0x0F,
+0x06, 0x01, 0x03, 0x2F, 0x39, 0xC4, 0x96, 0x01, 0x2C, 0x2F, 0x01, 0xC1,
+0x1D, 0x00, 0x01, 0x12, 0xE4, 0x7E, 0x02, 0x1F, 0x01, 0xB9, 0x08, 0x02,
+0x2F, 0x33, 0xE2, 0x57, 0x00, 0x10, 0x0F, 0xB9, 0x08, 0x09, 0x0F, 0x3A,
+0x00, 0x0B, 0x1F, 0x88, 0x1D, 0x00, 0x01, 0x2F, 0x91, 0xC3, 0x3A, 0x00,
+0x10, 0x1F, 0x90, 0x1D, 0x00, 0x01, 0x2F, 0x48, 0x58, 0x91, 0x00, 0x2D,
+0x0F, 0x05, 0x01, 0x0A, 0x1F, 0xD0, 0x1D, 0x00, 0x01, 0x2F, 0x8C, 0x1F,
+0x22, 0x01, 0x4A, 0x0F, 0xE8, 0x00, 0x0A, 0x0F, 0x3B, 0x06, 0x44, 0x90,
+0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x92, 0x01, 0x17,
+0x00, 0x01, 0x00, 0x38, 0xC0, 0xD7, 0xFF, 0x0F, 0x00, 0x0A, 0x01, 0x00,
+0x03, 0x1D, 0x00, 0x2F, 0x01, 0x80, 0x1D, 0x00, 0x01, 0x2F, 0xD9, 0x4A,
+0x1D, 0x00, 0x0F, 0x0F, 0x57, 0x00, 0x0A, 0x0F, 0x1D, 0x00, 0x0A, 0x0F,
+0x74, 0x00, 0x0B, 0x1F, 0x90, 0x1D, 0x00, 0x01, 0x22, 0x48, 0x58, 0x57,
+0x00, 0x1F, 0x40, 0x1D, 0x00, 0x01, 0x2F, 0x04, 0x90, 0x74, 0x00, 0x10,
+0x1F, 0x50, 0x1D, 0x00, 0x01, 0x22, 0x84, 0x94, 0x3A, 0x00, 0x1F, 0xA8,
+0x1D, 0x00, 0x01, 0x2F, 0x22, 0xF4, 0x57, 0x00, 0x10, 0x1F, 0xC0, 0x1D,
+0x00, 0x01, 0x2F, 0x1D, 0x0D, 0x22, 0x01, 0x10, 0x1F, 0x10, 0x1D, 0x00,
+0x01, 0x2F, 0x51, 0xC5, 0x5C, 0x01, 0x49, 0x0F, 0x57, 0x00, 0x0B, 0x0F,
+0x3A, 0x00, 0x02, 0x22, 0xC8, 0x5C, 0x57, 0x00, 0x0F, 0x3A, 0x00, 0x02,
+0x2F, 0xD1, 0xC1, 0x0A, 0x02, 0x4A, 0x0F, 0xCB, 0x00, 0x26, 0x0F, 0xAE,
+0x00, 0x0B, 0x0F, 0xE8, 0x00, 0x0A, 0x0F, 0x74, 0x00, 0x7D, 0x0F, 0x1D,
+0x00, 0xFF, 0xDB, 0x0F, 0x83, 0x03, 0x44, 0x0F, 0x74, 0x00, 0x0B, 0x1F,
+0xA2, 0x1D, 0x00, 0x01, 0x23, 0x18, 0x5E, 0x74, 0x00, 0x0F, 0x71, 0x05,
+0x01, 0x2F, 0x4F, 0x86, 0x74, 0x00, 0x10, 0x1F, 0xA4, 0x1D, 0x00, 0x01,
+0x2F, 0x9F, 0x2D, 0xA5, 0x04, 0x2D, 0x1F, 0x42, 0x91, 0x00, 0x01, 0x12,
+0xE8, 0xAA, 0x05, 0x3F, 0x01, 0x00, 0x20, 0x1D, 0x00, 0x00, 0x22, 0x5E,
+0xE0, 0x3A, 0x00, 0x1F, 0xC4, 0x57, 0x00, 0x01, 0x23, 0xE8, 0x5D, 0x74,
+0x00, 0x0F, 0x57, 0x00, 0x01, 0x12, 0x5E, 0x58, 0x06, 0x2F, 0x01, 0x81,
+0x1D, 0x00, 0x01, 0x2F, 0xBE, 0x1E, 0x92, 0x06, 0x11, 0x0F, 0x91, 0x00,
+0x01, 0x22, 0x4F, 0xF6, 0x1D, 0x00, 0x1F, 0x20, 0x3C, 0x06, 0x01, 0x22,
+0x40, 0x3A, 0x1D, 0x00, 0x0F, 0xAF, 0x06, 0x02, 0x2F, 0x95, 0x82, 0x22,
+0x01, 0x10, 0x0F, 0x91, 0x00, 0x09, 0x0F, 0x79, 0x01, 0x0B, 0x1F, 0x08,
+0x3B, 0x00, 0x01, 0x2F, 0x16, 0x19, 0x1E, 0x06, 0x85, 0x0F, 0x5C, 0x01,
+0x01, 0x2F, 0x56, 0x6B, 0x74, 0x00, 0x2E, 0x0F, 0x57, 0x00, 0x08, 0x0F,
+0x3F, 0x01, 0x0B, 0x0F, 0x06, 0x01, 0x02, 0x2F, 0x39, 0xC4, 0x96, 0x01,
+0x2C, 0x2F, 0x01, 0xC1, 0x1D, 0x00, 0x01, 0x12, 0xE4, 0x7E, 0x02, 0x1F,
+0x01, 0xB9, 0x08, 0x02, 0x2F, 0x33, 0xE2, 0x57, 0x00, 0x10, 0x0F, 0xB9,
+0x08, 0x09, 0x0F, 0x3A, 0x00, 0x0B, 0x1F, 0x88, 0x1D, 0x00, 0x01, 0x2F,
+0x91, 0xC3, 0x3A, 0x00, 0x10, 0x0F, 0xDB, 0x09, 0x09, 0x0F, 0x91, 0x00,
+0x28, 0x0F, 0x05, 0x01, 0x0A, 0x1F, 0xD0, 0x1D, 0x00, 0x01, 0x2F, 0x8C,
+0x1F, 0x22, 0x01, 0x4A, 0x0F, 0xE8, 0x00, 0x0A, 0x0F, 0x3B, 0x06, 0x44,
+0x0F, 0x01, 0x00, 0x02, 0x0F, 0x02, 0x0C, 0xFF, 0xFF, 0xFF, 0xDD, 0x50,
+0x00, 0x00, 0x00, 0x00, 0x00, 0x9B, 0x01, 0x10, 0x00, 0x01, 0x00, 0x30,
+0xD9, 0x4A, 0xFF, 0x07, 0x00, 0x21, 0x01, 0x80, 0x0E, 0x00, 0x0B, 0x01,
+0x00, 0x0F, 0x1D, 0x00, 0xFF, 0x8B, 0x1F, 0x00, 0x1D, 0x00, 0x02, 0x22,
+0xC8, 0x5C, 0x3A, 0x00, 0x0F, 0x1C, 0x00, 0x01, 0x32, 0x00, 0xD1, 0xC1,
+0x3A, 0x00, 0x0F, 0x01, 0x00, 0x02, 0x2F, 0xC0, 0xD7, 0x74, 0x00, 0x10,
+0x1F, 0x82, 0x1D, 0x00, 0x01, 0x23, 0xBA, 0x7F, 0x74, 0x00, 0x1F, 0x40,
+0x1D, 0x00, 0x00, 0x2F, 0x4F, 0x86, 0x74, 0x00, 0x10, 0x1F, 0xA4, 0x1D,
+0x00, 0x01, 0x2F, 0x9F, 0x2D, 0x91, 0x00, 0x10, 0x0F, 0x57, 0x00, 0x09,
+0x2F, 0x00, 0x02, 0x91, 0x00, 0x01, 0x23, 0x2C, 0xB3, 0xAE, 0x00, 0x1F,
+0x20, 0x1D, 0x00, 0x00, 0x22, 0x5E, 0xE0, 0x3A, 0x00, 0x1F, 0xC4, 0x57,
+0x00, 0x01, 0x23, 0xE8, 0x5D, 0x74, 0x00, 0x0F, 0x57, 0x00, 0x01, 0x22,
+0x5E, 0x90, 0x57, 0x00, 0x1F, 0x81, 0x1D, 0x00, 0x01, 0x22, 0xBE, 0x1E,
+0x3A, 0x00, 0x0F, 0x1C, 0x00, 0x01, 0x22, 0x00, 0x04, 0x3A, 0x00, 0x1F,
+0x00, 0x91, 0x00, 0x02, 0x22, 0x4F, 0xF6, 0x1D, 0x00, 0x2F, 0x20, 0xC0,
+0x1D, 0x00, 0x00, 0x22, 0x40, 0x3A, 0x1D, 0x00, 0x1F, 0x50, 0x57, 0x00,
+0x01, 0x2F, 0x95, 0x82, 0x22, 0x01, 0x10, 0x0F, 0x91, 0x00, 0x09, 0x0F,
+0x79, 0x01, 0x0B, 0x1F, 0x08, 0x3B, 0x00, 0x01, 0x2F, 0x16, 0x19, 0x9B,
+0x02, 0x49, 0x0F, 0x1D, 0x00, 0x0A, 0x0F, 0x49, 0x03, 0x0C, 0x0F, 0x5C,
+0x01, 0x01, 0x2F, 0x56, 0x6B, 0x74, 0x00, 0x2E, 0x0F, 0x57, 0x00, 0x08,
+0x0F, 0x3F, 0x01, 0x0B, 0x0F, 0x06, 0x01, 0x02, 0x2F, 0x39, 0xC4, 0x96,
+0x01, 0x2C, 0x2F, 0x01, 0xC1, 0x1D, 0x00, 0x01, 0x12, 0xE4, 0x7E, 0x02,
+0x2F, 0x01, 0xA8, 0x1D, 0x00, 0x01, 0x2F, 0x33, 0xE2, 0x57, 0x00, 0x10,
+0x0F, 0x7D, 0x02, 0x01, 0x3F, 0x00, 0x1D, 0x0D, 0x3A, 0x00, 0x10, 0x1F,
+0x88, 0x1D, 0x00, 0x01, 0x2F, 0x91, 0xC3, 0x3A, 0x00, 0x10, 0x1F, 0x90,
+0x1D, 0x00, 0x01, 0x2F, 0x48, 0x58, 0x91, 0x00, 0x0F, 0x0F, 0x7E, 0x02,
+0x0A, 0x1F, 0x00, 0x05, 0x01, 0x02, 0x22, 0x22, 0xF4, 0x1D, 0x00, 0x1F,
+0xD0, 0x1D, 0x00, 0x01, 0x2F, 0x9D, 0x09, 0x57, 0x00, 0x10, 0x0F, 0x91,
+0x00, 0x02, 0x2F, 0x0C, 0x1B, 0x3A, 0x00, 0x10, 0x0F, 0xE8, 0x00, 0x02,
+0x2F, 0x59, 0x4E, 0x3A, 0x00, 0x10, 0x0F, 0x1D, 0x00, 0x26, 0x0F, 0x75,
+0x06, 0x44, 0x0F, 0x74, 0x00, 0x44, 0x0F, 0x27, 0x02, 0x27, 0x0F, 0x70,
+0x05, 0x0C, 0x0F, 0x01, 0x00, 0x01, 0x04, 0xDA, 0x03, 0x0F, 0x53, 0x05,
+0x02, 0x2F, 0x84, 0x94, 0x05, 0x01, 0x10, 0x0F, 0x57, 0x00, 0x09, 0x0F,
+0x3A, 0x00, 0x28, 0x0F, 0x1D, 0x00, 0xFF, 0xFF, 0x00, 0x19, 0x10, 0x1D,
+0x00, 0x13, 0x50, 0x3B, 0x06, 0x0F, 0x3A, 0x00, 0x11, 0x0F, 0x1D, 0x00,
+0xFF, 0xFF, 0xFF, 0xF2, 0x50, 0x00, 0x00, 0x00, 0xC0, 0xD7, 0x21, 0x00,
+0x2F, 0xFF, 0x00, 0x01, 0x00, 0x06, 0x2F, 0xC0, 0xD7, 0x1D, 0x00, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xDA, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x25, 0x00, 0x1F,
+0x00, 0x01, 0x00, 0x00, 0x3F, 0xC0, 0xD7, 0xFF, 0x17, 0x00, 0x01, 0x0F,
+0x1D, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xCC, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00,
+0x23, 0x00, 0x18, 0x00, 0x01, 0x00, 0x39, 0xC0, 0xD7, 0xFF, 0x10, 0x00,
+0x0F, 0x1D, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xDA, 0x50, 0x00, 0x00, 0x00, 0x00,
+0x00, 0x27, 0x00, 0x11, 0x00, 0x01, 0x00, 0x32, 0xC0, 0xD7, 0xFF, 0x09,
+0x00, 0x0F, 0x01, 0x00, 0x01, 0x0F, 0x1D, 0x00, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xD4,
+0x50, 0x00, 0x00, 0x00, 0x00, 0xC0, 0x21, 0x00, 0x3F, 0xD7, 0xFF, 0x00,
+0x01, 0x00, 0x06, 0x1F, 0xC0, 0x1D, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xDA, 0x50,
+0x00, 0x00, 0x00, 0x00, 0x00, 0x25, 0x00, 0x1F, 0x00, 0x01, 0x00, 0x01,
+0x3F, 0xC0, 0xD7, 0xFF, 0x18, 0x00, 0x02, 0x0F, 0x1D, 0x00, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xCA, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x23, 0x00, 0x19, 0x00,
+0x01, 0x00, 0x3A, 0xC0, 0xD7, 0xFF, 0x11, 0x00, 0x0F, 0x1D, 0x00, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xD8, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3B, 0x00, 0x12,
+0x00, 0x01, 0x00, 0x33, 0xC0, 0xD7, 0xFF, 0x0A, 0x00, 0x0F, 0x01, 0x00,
+0x00, 0x0F, 0x1D, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x4A, 0x1F, 0x20, 0x1D, 0x00, 0x00,
+0x30, 0x4F, 0xF6, 0xFF, 0x01, 0x00, 0x22, 0xC2, 0x80, 0x0F, 0x00, 0xA0,
+0x88, 0x88, 0x5E, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF
+
+};
+
+#endif
@@ -0,0 +1,38 @@
+/*
+ * console.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef INC_CONSOLE_H_
+#define INC_CONSOLE_H_
+
+#include "main.h"
+#include <stdint.h>
+
+/*
+ * Command console on the debug UART. USART3 receives into a circular DMA
+ * buffer; the IDLE, half and full transfer events hand whatever arrived to
+ * the console ring, so there is no per-byte interrupt. console_process()
+ * splits the ring into lines and dispatches them from the main loop, and
+ * _read() is served from the same ring for getchar()/scanf().
+ */
+#define CONSOLE_DMA_SIZE          64U
+#define CONSOLE_RX_SIZE           256U
+#define CONSOLE_LINE_MAX          80U
+#define CONSOLE_MAX_ARGS          8U
+
+typedef struct {
+    uint32_t received;                  /* Bytes taken from the DMA buffer */
+    uint32_t dropped;                   /* Bytes lost to a full console ring */
+    uint32_t errors;                    /* UART errors (reception restarted) */
+    uint32_t overlong;                  /* Lines discarded for exceeding CONSOLE_LINE_MAX */
+} console_stats_t;
+
+HAL_StatusTypeDef console_init(void);
+void console_process(void);
+void console_get_stats(console_stats_t *stats);
+void console_UART_RxEventCallback(UART_HandleTypeDef *huart, uint16_t size);
+void console_UART_ErrorCallback(UART_HandleTypeDef *huart);
+
+#endif /* INC_CONSOLE_H_ */
@@ -0,0 +1,96 @@
+/*
+ * crc.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef INC_CRC_H_
+#define INC_CRC_H_
+
+#include "main.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Incremental CRC over any 8, 16 or 32-bit polynomial (Rocksoft model:
+ * width, poly, init, refin, refout, xorout), computed either in software
+ * or on the CRC unit (hcrc). Both engines keep the same MSB-first register
+ * in the context, so a checksum can be started on one engine and finished
+ * on the other, chunk by chunk, with identical results.
+ */
+typedef struct {
+    const char *name;
+    uint8_t width;                      /* 8, 16 or 32 */
+    uint32_t poly;                      /* Normal (MSB-first) form, without the top bit */
+    uint32_t init;
+    bool refin;                         /* Bytes enter LSB first */
+    bool refout;                        /* Result is bit-reversed before xorout */
+    uint32_t xorout;
+} crc_params_t;
+
+extern const crc_params_t crc16_ccitt_false;    /* util_crc16, bitstore slots, XLZ4 */
+extern const crc_params_t crc16_modbus;
+extern const crc_params_t crc32_iso_hdlc;       /* Ethernet, zlib */
+
+typedef enum {
+    CRC_ENGINE_SW = 0,
+    CRC_ENGINE_HW,                      /* Falls back to software while the unit is claimed elsewhere */
+} crc_engine_t;
+
+typedef struct {
+    const crc_params_t *params;
+    crc_engine_t engine;
+    uint32_t reg;                       /* Before output reflection and xorout */
+} crc_ctx_t;
+
+void crc_init(crc_ctx_t *ctx, const crc_params_t *params, crc_engine_t engine);
+void crc_update(crc_ctx_t *ctx, const void *data, size_t len);
+uint32_t crc_final(const crc_ctx_t *ctx);
+uint32_t crc_compute(const crc_params_t *params, crc_engine_t engine, const void *data, size_t len);
+
+/*
+ * Hold the CRC unit for one context across DMA-fed updates: claim loads the
+ * context's polynomial and running value, release reads the value back.
+ */
+bool crc_hw_claim(crc_ctx_t *ctx);
+void crc_hw_release(crc_ctx_t *ctx);
+
+/*
+ * Asynchronous CRC jobs: MDMA feeds the buffer to the CRC unit and the
+ * callback runs from the MDMA interrupt with the result. Jobs are owned by
+ * the caller and queue up behind each other; a job continues its context,
+ * so a stream can be checksummed one job per chunk.
+ */
+#define CRC_JOB_MAX_BLOCK       65536U      /* Largest single MDMA block */
+
+struct crc_job;
+typedef void (*crc_job_cb_t)(struct crc_job *job, uint32_t crc);
+
+typedef struct crc_job {
+    crc_ctx_t *ctx;
+    const uint8_t *data;
+    size_t len;
+    crc_job_cb_t cb;
+    void *arg;
+    volatile int status;                /* HAL_BUSY while queued or running */
+    uint32_t cpu_cycles;                /* Spent starting blocks and in the completion interrupt */
+    uint64_t elapsed_cycles;            /* Submit to completion */
+    /* Private */
+    size_t pos;
+    uint64_t submitted;
+    struct crc_job *next;
+} crc_job_t;
+
+typedef struct {
+    uint32_t jobs;
+    uint32_t bytes;
+    uint64_t cpu_cycles;
+    uint64_t elapsed_cycles;
+} crc_job_stats_t;
+
+int crc_job_submit(crc_job_t *job);
+void crc_job_cancel(crc_job_t *job);
+void crc_job_get_stats(crc_job_stats_t *stats);
+
+#endif /* INC_CRC_H_ */
@@ -9,6 +9,88 @@
 #define INC_CROSSLINK_H_
 #include "main.h"
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "fpga_source.h"
+
+/* One piece of a scatter list written back to back as a single I2C transfer */
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+} i2c_segment_t;
+
+/* Completion callback of the DMA sequential transmit engine, runs in interrupt context */
+typedef void (*i2c_seq_cplt_fn)(int status, void *arg);
+
+/* i2c_seq_write_part() flags */
+#define I2C_SEQ_CONTINUE  0x01U   /* Continue the write left open by the previous part */
+#define I2C_SEQ_MORE      0x02U   /* More parts follow, do not end the write */
+
+/* segs (and the data they point to) must stay valid until the callback fires */
+int i2c_seq_write_part(const i2c_segment_t *segs, int nsegs, uint32_t flags,
+                       i2c_seq_cplt_fn cplt_fn, void *arg);
+int i2c_seq_write_start(const i2c_segment_t *segs, int nsegs, i2c_seq_cplt_fn cplt_fn, void *arg);
+bool i2c_seq_busy(void);
+int i2c_write_segments(const i2c_segment_t *segs, int nsegs);
+int fpga_program_stream(const uint8_t *cmd, int cmd_len, fpga_source_t *src);
+
+typedef enum {
+    FPGA_CFG_IDLE = 0,
+    FPGA_CFG_RESET,
+    FPGA_CFG_ACTIVATE,
+    FPGA_CFG_ENABLE,
+    FPGA_CFG_ERASE,
+    FPGA_CFG_PROGRAM_CMD,
+    FPGA_CFG_STREAM,
+    FPGA_CFG_VERIFY,
+    FPGA_CFG_DONE,
+    FPGA_CFG_ERROR,
+} fpga_cfg_state_t;
+
+/* Phases timed and reported by the configuration state machine */
+typedef enum {
+    FPGA_PHASE_RESET = 0,
+    FPGA_PHASE_ACTIVATE,
+    FPGA_PHASE_ERASE,
+    FPGA_PHASE_PROGRAM,
+    FPGA_PHASE_VERIFY,
+    FPGA_PHASE_COUNT,
+} fpga_cfg_phase_t;
+
+/* Loader metrics of the last bitstream stream, for benchmarking on target */
+typedef struct {
+    uint32_t bytes;             /* Bitstream bytes sent (excluding the command) */
+    uint32_t parts;             /* I2C write parts issued */
+    uint32_t irqs;              /* I2C1 and I2C1 TX DMA interrupts taken */
+    uint32_t starved;           /* Polls with the bus idle and no chunk ready */
+    uint32_t ms;                /* Wall time of the stream */
+} fpga_stream_stats_t;
+
+/* Incremented by the I2C1 interrupt handlers */
+extern volatile uint32_t i2c1_irq_count;
+
+/*
+ * I2C1 is shared by FPGA configuration and the IMU sampler. A user claims
+ * the bus for as long as it needs it; FPGA configuration holds it from
+ * start to DONE/ERROR, the IMU for one burst read.
+ */
+typedef enum {
+    I2C_BUS_FREE = 0,
+    I2C_BUS_FPGA,
+    I2C_BUS_IMU,
+} i2c_bus_owner_t;
+
+bool i2c_bus_claim(i2c_bus_owner_t owner);
+void i2c_bus_release(i2c_bus_owner_t owner);
+i2c_bus_owner_t i2c_bus_owner(void);
+
+/* src == NULL programs the built-in image */
+int fpga_configure_start(fpga_source_t *src);
+bool fpga_configure_process(void);
+bool fpga_configure_busy(void);
+fpga_cfg_state_t fpga_configure_state(void);
+uint32_t fpga_configure_phase_ms(fpga_cfg_phase_t phase);
+const fpga_stream_stats_t *fpga_configure_stream_stats(void);
 
 void fpga_configure();
 
@@ -0,0 +1,52 @@
+/*
+ * fpga_source.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef INC_FPGA_SOURCE_H_
+#define INC_FPGA_SOURCE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define FPGA_RAW_CHUNK_SIZE   8192
+#define FPGA_LZ4_BLOCK_MAX    4096
+
+/*
+ * Bitstream producer feeding fpga_program_stream() one chunk at a time.
+ * At most two chunks are outstanding (one on the wire, one being prepared);
+ * a chunk stays valid until release() is called for it.
+ */
+typedef struct fpga_source fpga_source_t;
+struct fpga_source {
+    size_t total;                                               /* Bytes produced in total */
+    bool has_crc;
+    uint16_t crc16;                                             /* Expected CRC16-CCITT of everything produced */
+    int (*acquire)(fpga_source_t *src, const uint8_t **chunk);  /* Chunk length, 0 = not ready yet, -1 = error */
+    void (*release)(fpga_source_t *src);                        /* Oldest outstanding chunk was sent */
+};
+
+/* Uncompressed image in memory-mapped flash or RAM, sent in place */
+typedef struct {
+    fpga_source_t base;
+    const uint8_t *data;
+    size_t pos;
+} fpga_raw_source_t;
+
+/* Block-compressed image produced by Tools/bitpack.py */
+typedef struct {
+    fpga_source_t base;
+    const uint8_t *next;            /* Next block header in the image */
+    const uint8_t *end;
+    size_t produced;
+    uint16_t block_size;
+    uint8_t head;                   /* Buffer the next block is decoded into */
+    uint8_t buf[2][FPGA_LZ4_BLOCK_MAX];
+} fpga_lz4_source_t;
+
+int fpga_source_init_raw(fpga_raw_source_t *src, const uint8_t *data, size_t len);
+int fpga_source_init_lz4(fpga_lz4_source_t *src, const uint8_t *image, size_t image_len);
+
+#endif /* INC_FPGA_SOURCE_H_ */
@@ -12,8 +12,114 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include "lwrb_mr.h"
+
+ /* What a producer does when the log ring is short on space */
+ typedef enum {
+     LOG_POLICY_DROP_NEWEST = 0,    /* Discard the new message */
+     LOG_POLICY_DROP_OLDEST,        /* Discard the queued backlog not yet on the wire */
+     LOG_POLICY_TRUNCATE,           /* Queue as much of the message as fits */
+     LOG_POLICY_BLOCK,              /* Wait for the UART to drain (thread mode only) */
+     LOG_POLICY_COUNT,
+ } log_policy_t;
+
+ typedef enum {
+     LOG_LEVEL_DEBUG = 0,
+     LOG_LEVEL_INFO,                /* Plain printf and LOGB() */
+     LOG_LEVEL_WARN,
+     LOG_LEVEL_ERROR,
+     LOG_LEVEL_COUNT,
+ } log_level_t;
+
+ typedef struct {
+     uint32_t messages;             /* Messages submitted under this policy */
+     uint32_t dropped;              /* Messages lost, truncated, or backlog flushes (drop oldest) */
+     uint32_t dropped_bytes;
+ } logging_policy_stats_t;
+
+ /*
+  * Output for the log ring. send() starts an asynchronous transfer of a span
+  * of the ring and returns HAL_OK, or anything else to be retried later; the
+  * sink calls logging_sink_done() once the transfer has completed, or
+  * logging_sink_error() if it was aborted. The span stays valid until then.
+  */
+ typedef struct log_sink log_sink_t;
+ struct log_sink {
+     const char *name;
+     int (*send)(log_sink_t *sink, const uint8_t *data, size_t len);
+     size_t max_burst;              /* Largest single transfer, 0 = no limit */
+
+     /* Owned by logging.c */
+     lwrb_mr_reader_t reader;       /* Start of the span being sent */
+     volatile bool attached;
+     volatile uint32_t busy;        /* Transfer claimed or in flight */
+     volatile size_t pos;           /* Next byte to send, free running */
+     volatile size_t inflight;
+     uint32_t lapped_bytes;         /* Skipped because the sink fell behind */
+     uint32_t errors;               /* Transfers aborted by the sink */
+     uint32_t error_bytes;          /* Dropped with them */
+ };
+
+ typedef struct {
+     uint32_t written;              /* Bytes queued in the log ring */
+     logging_policy_stats_t policy[LOG_POLICY_COUNT];
+ } logging_stats_t;
+
+ /*
+  * Binary logging with deferred formatting. LOGB() places its format string
+  * in the non-loaded .log_fmt section and logs only the string's offset
+  * there plus up to LOGB_MAX_ARGS raw 32-bit arguments; Tools/logdecode.py
+  * formats the records on the host from the ELF. Arguments must be integers
+  * of at most 32 bits or pointers to constant strings (%s).
+  *
+  * Records share the UART stream with printf text. Timestamps are 64-bit
+  * DWT cycle counts (util_cycles()); the timebase record gives their rate.
+  *   0xA5, nargs, u16 format offset, u64 time, nargs x u32
+  *   0xA6, len, u32 label address, u64 time, len bytes      (hex dump)
+  *   0xA7, u32 cycles per second                            (timebase)
+  *   0xA9, u64 time                                         (stamps the text that follows)
+  *
+  * The stream is only readable through logdecode.py in this mode, so it is
+  * opt-in: build with -DLOGGING_BINARY=1. By default LOGB() is plain printf
+  * and the UART carries unframed text.
+  */
+#ifndef LOGGING_BINARY
+#define LOGGING_BINARY 0
+#endif
+
+#define LOGB_SYNC               0xA5
+#define LOGB_SYNC_HEX           0xA6
+#define LOGB_SYNC_TIMEBASE      0xA7
+#define LOGB_SYNC_TIME          0xA9
+#define LOGB_TIME_SIZE          8
+#define LOGB_MAX_ARGS           8
+#define LOGB_MAX_HEX            64
+
+#define LOGB_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+#define LOGB_NARGS(...)         LOGB_NARGS_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+
+#if LOGGING_BINARY
+#define LOGB(fmt, ...) do { \
+        static const char logb_fmt_[] __attribute__((section(".log_fmt"), used)) = fmt; \
+        logging_bin((uint16_t)(uintptr_t)logb_fmt_, LOGB_NARGS(__VA_ARGS__), ##__VA_ARGS__); \
+    } while (0)
+#else
+#define LOGB(fmt, ...)          printf(fmt, ##__VA_ARGS__)
+#endif
 
  void init_dma_logging();
+ void logging_bin(uint16_t fmt_id, uint32_t nargs, ...);
+ void logging_bin_hex(const char *label, const uint8_t *buf, size_t len);
+ void logging_timebase(void);
+ void logging_get_stats(logging_stats_t *stats);
+ void logging_print_stats(void);
+ bool logging_sink_attach(log_sink_t *sink);
+ void logging_sink_detach(log_sink_t *sink);
+ void logging_sink_done(log_sink_t *sink);
+ void logging_sink_error(log_sink_t *sink);
+ void logging_set_policy(log_level_t level, log_policy_t policy);
+ int log_printf(log_level_t level, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+ int log_printf_policy(log_policy_t policy, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
  bool is_using_dma();
  void logging_UART_TxCpltCallback(UART_HandleTypeDef *huart);
  void logging_UART_TxHalfCpltCallback(UART_HandleTypeDef *huart);
@@ -59,6 +59,16 @@ extern "C" {
  */
 #define LWRB_USE_MAGIC                      1
 
+/**
+ * \brief           Copy data in and out of the buffer with aligned word accesses.
+ * Ring offsets are arbitrary, so the copy runs bytes up to a word boundary,
+ * then 16-byte blocks as 64-bit load/store pairs (LDRD/STRD on Cortex-M7),
+ * then the tail. Set to `0` to use plain `memcpy`
+ */
+#ifndef LWRB_USE_WORD_COPY
+#define LWRB_USE_WORD_COPY                  1
+#endif /* LWRB_USE_WORD_COPY */
+
 /**
  * \brief           Event type for buffer operations
  */
@@ -99,6 +109,16 @@ typedef struct lwrb {
 #endif /* LWRB_USE_MAGIC */
 } lwrb_t;
 
+/**
+ * \brief           Write space handed out by \ref lwrb_reserve.
+ * Free space that wraps past the end of the buffer comes back as two spans;
+ * unused spans have zero length
+ */
+typedef struct {
+    uint8_t* data[2];                           /*!< Span start: at the write pointer, then at the buffer start */
+    size_t len[2];                              /*!< Span lengths in units of bytes */
+} lwrb_span_t;
+
 uint8_t     lwrb_init(LWRB_VOLATILE lwrb_t* buff, void* buffdata, size_t size);
 uint8_t     lwrb_is_ready(LWRB_VOLATILE lwrb_t* buff);
 void        lwrb_free(LWRB_VOLATILE lwrb_t* buff);
@@ -123,6 +143,8 @@ size_t      lwrb_skip(LWRB_VOLATILE lwrb_t* buff, size_t len);
 void*       lwrb_get_linear_block_write_address(LWRB_VOLATILE lwrb_t* buff);
 size_t      lwrb_get_linear_block_write_length(LWRB_VOLATILE lwrb_t* buff);
 size_t      lwrb_advance(LWRB_VOLATILE lwrb_t* buff, size_t len);
+size_t      lwrb_reserve(LWRB_VOLATILE lwrb_t* buff, size_t btw, lwrb_span_t* span);
+size_t      lwrb_commit(LWRB_VOLATILE lwrb_t* buff, size_t len);
 
 /**
  * \}
@@ -0,0 +1,61 @@
+/**
+ * \file            lwrb_mq.h
+ * \brief           Framed message queue on top of LwRB
+ */
+
+#ifndef LWRB_MQ_HDR_H
+#define LWRB_MQ_HDR_H
+
+#include "lwrb.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \defgroup        LWRB_MQ Message queue
+ * \brief           Whole variable-length messages between one producer and one consumer
+ *
+ * Every record is a 16-bit length followed by the payload. A record is
+ * published with a single write pointer update once it is completely in
+ * the ring, so the consumer never sees a torn message; a record that does
+ * not fit is dropped whole and counted. Records may wrap, which is why a
+ * peeked record comes back as up to two spans.
+ * \{
+ */
+
+#define LWRB_MQ_HDR_SIZE                    2   /*!< Length prefix in front of every record */
+#define LWRB_MQ_MAX_LEN                     0xFFFF
+
+/**
+ * \brief           Message queue handle
+ */
+typedef struct {
+    lwrb_t rb;                                  /*!< Underlying byte ring */
+    uint32_t dropped;                           /*!< Records that did not fit */
+} lwrb_mq_t;
+
+uint8_t     lwrb_mq_init(lwrb_mq_t* mq, void* buffdata, size_t size);
+void        lwrb_mq_reset(lwrb_mq_t* mq);
+
+/* Producer */
+uint8_t     lwrb_mq_put(lwrb_mq_t* mq, const void* data, size_t len);
+size_t      lwrb_mq_reserve(lwrb_mq_t* mq, size_t len, lwrb_span_t* span);
+uint8_t     lwrb_mq_commit(lwrb_mq_t* mq, size_t len);
+
+/* Consumer */
+size_t      lwrb_mq_get(lwrb_mq_t* mq, void* data, size_t max_len);
+size_t      lwrb_mq_peek(lwrb_mq_t* mq, size_t index, lwrb_span_t* span);
+size_t      lwrb_mq_peek_batch(lwrb_mq_t* mq, lwrb_span_t* spans, size_t max_count);
+size_t      lwrb_mq_release(lwrb_mq_t* mq, size_t count);
+size_t      lwrb_mq_count(lwrb_mq_t* mq);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWRB_MQ_HDR_H */
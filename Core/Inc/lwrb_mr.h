@@ -0,0 +1,87 @@
+/**
+ * \file            lwrb_mr.h
+ * \brief           Multi-reader ring buffer
+ */
+
+#ifndef LWRB_MR_HDR_H
+#define LWRB_MR_HDR_H
+
+#include <string.h>
+#include <stdint.h>
+#include "lwrb.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \defgroup        LWRB_MR Multi-reader ring buffer
+ * \brief           One byte stream fanned out to several readers without copying
+ *
+ * The write position and every read cursor are free-running byte counters;
+ * only their difference matters, and the buffer index is the counter modulo
+ * the (power of two) size. Writers see as free space what the slowest
+ * normal reader leaves them. A lossy reader never holds the writers back:
+ * when it falls more than a buffer behind, it skips ahead to the oldest
+ * data still in the buffer and counts what it lost.
+ *
+ * Any number of writers, thread code or ISRs, may write at once: each
+ * claims its span by CAS on `w_claim`, fills it and commits it. The commit
+ * that completes every claimed span publishes `w`, which only moves forward.
+ * \{
+ */
+
+#define LWRB_MR_MAX_READERS                 4
+
+/**
+ * \brief           Memory barrier between a lossy reader's copy and its check for being overwritten
+ */
+#define LWRB_MR_BARRIER()                   __sync_synchronize()
+
+/**
+ * \brief           Reader cursor
+ */
+typedef struct {
+    volatile size_t r;                          /*!< Bytes consumed, free running */
+    uint8_t lossy;                              /*!< Skip ahead instead of stalling the writer */
+    size_t lost;                                /*!< Bytes skipped by a lossy reader */
+} lwrb_mr_reader_t;
+
+/**
+ * \brief           Buffer structure
+ */
+typedef struct {
+    uint8_t* buff;                              /*!< Buffer data */
+    size_t size;                                /*!< Size of buffer data, a power of two; all of it is usable */
+    volatile size_t w;                          /*!< Bytes written and visible to readers, free running */
+    volatile size_t w_claim;                    /*!< Bytes claimed by writers, ahead of `w` while copying */
+    volatile size_t w_done;                     /*!< Bytes committed by writers */
+    lwrb_mr_reader_t* volatile readers[LWRB_MR_MAX_READERS];    /*!< Attached readers */
+} lwrb_mr_t;
+
+uint8_t     lwrb_mr_init(lwrb_mr_t* buff, void* buffdata, size_t size);
+uint8_t     lwrb_mr_attach(lwrb_mr_t* buff, lwrb_mr_reader_t* reader, uint8_t lossy);
+void        lwrb_mr_detach(lwrb_mr_t* buff, lwrb_mr_reader_t* reader);
+
+/* Writers */
+size_t      lwrb_mr_write(lwrb_mr_t* buff, const void* data, size_t btw);
+size_t      lwrb_mr_claim(lwrb_mr_t* buff, size_t btw, size_t min, lwrb_span_t* span);
+void        lwrb_mr_commit(lwrb_mr_t* buff, size_t len);
+size_t      lwrb_mr_get_free(lwrb_mr_t* buff);
+
+/* Readers */
+size_t      lwrb_mr_read(lwrb_mr_t* buff, lwrb_mr_reader_t* reader, void* data, size_t btr);
+size_t      lwrb_mr_get_full(lwrb_mr_t* buff, lwrb_mr_reader_t* reader);
+void*       lwrb_mr_get_linear_block_read_address(lwrb_mr_t* buff, lwrb_mr_reader_t* reader);
+size_t      lwrb_mr_get_linear_block_read_length(lwrb_mr_t* buff, lwrb_mr_reader_t* reader);
+size_t      lwrb_mr_skip(lwrb_mr_t* buff, lwrb_mr_reader_t* reader, size_t len);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWRB_MR_HDR_H */
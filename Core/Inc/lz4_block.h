@@ -0,0 +1,15 @@
+/*
+ * lz4_block.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef INC_LZ4_BLOCK_H_
+#define INC_LZ4_BLOCK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+int lz4_block_decompress(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_cap);
+
+#endif /* INC_LZ4_BLOCK_H_ */
@@ -63,6 +63,9 @@ void Error_Handler(void);
 /* USER CODE END EFP */
 
 /* Private defines -----------------------------------------------------------*/
+#define ICM_INT_Pin GPIO_PIN_3
+#define ICM_INT_GPIO_Port GPIOG
+#define ICM_INT_EXTI_IRQn EXTI3_IRQn
 #define CRESET_Pin GPIO_PIN_9
 #define CRESET_GPIO_Port GPIOC
 #define TMS_Pin GPIO_PIN_13
@@ -83,6 +86,7 @@ extern I2C_HandleTypeDef hi2c1;
 #define ICM_I2C hi2c1
 
 
+
 /* USER CODE END Private defines */
 
 #ifdef __cplusplus
@@ -12,6 +12,10 @@
 #include <stdint.h>
 
 uint16_t util_crc16(const uint8_t* buf, uint32_t size);
-uint16_t util_hw_crc16(uint8_t* buf, uint32_t size);
+uint16_t util_crc16_update(uint16_t crc, const uint8_t* buf, uint32_t size);
+uint16_t util_crc16_bytewise(const uint8_t* buf, uint32_t size);
+uint16_t util_hw_crc16(const uint8_t* buf, uint32_t size);
 void printBuffer(const uint8_t* buffer, uint32_t size);
+void util_cycles_init(void);
+uint64_t util_cycles(void);
 #endif /* INC_UTILS_H_ */
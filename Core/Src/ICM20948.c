@@ -7,50 +7,152 @@
 
 #include "main.h"
 #include "ICM20948.h"
+#include "logging.h"
+#include "crosslink.h"
+#include "lwrb_mq.h"
+#include "utils.h"
 
 #include <string.h>
 #include <stdio.h>
 
-static HAL_StatusTypeDef ICM_readBytes(uint8_t reg, uint8_t *pData, uint16_t size)
+/*
+ * Bank-aware register access. The selected bank and every register written
+ * through ICM_RegWrite() are shadowed: bank switches and writes that would
+ * not change anything are skipped, and ICM_RegRead() serves written
+ * configuration registers without touching the bus. Sensor data always
+ * goes through ICM_DataRead(), one combined address+read transaction.
+ */
+#define ICM_BANK_UNKNOWN            (0xFF)
+#define ICM_BANK_INDEX(bank)        (((bank) >> 4) & 0x03)
+#define ICM_PWR_MGMT_1_RESET        (0x80)  // DEVICE_RESET, self-clearing
+#define ICM_USER_CTRL_RST_BITS      (0x0E)  // DMP_RST, SRAM_RST, I2C_MST_RST, self-clearing
+#define ICM_I2C_TIMEOUT_MS          (100)
+
+static uint8_t icm_bank = ICM_BANK_UNKNOWN;
+static uint8_t icm_shadow[4][128];
+static uint32_t icm_shadow_valid[4][4];
+static ICM_BusStats icm_bus_stats;
+
+static void ICM_ShadowInvalidate(void)
+{
+    memset(icm_shadow_valid, 0, sizeof(icm_shadow_valid));
+    icm_bank = ICM_BANK_UNKNOWN;
+}
+
+static bool ICM_ShadowGet(uint8_t bank, uint8_t reg, uint8_t *val)
+{
+    uint8_t b = ICM_BANK_INDEX(bank);
+
+    reg &= 0x7F;
+    if ((icm_shadow_valid[b][reg >> 5] & (1UL << (reg & 31))) == 0)
+    {
+        return false;
+    }
+    *val = icm_shadow[b][reg];
+    return true;
+}
+
+static void ICM_ShadowSet(uint8_t bank, uint8_t reg, uint8_t val, bool valid)
+{
+    uint8_t b = ICM_BANK_INDEX(bank);
+
+    reg &= 0x7F;
+    icm_shadow[b][reg] = val;
+    if (valid)
+    {
+        icm_shadow_valid[b][reg >> 5] |= 1UL << (reg & 31);
+    }
+    else
+    {
+        icm_shadow_valid[b][reg >> 5] &= ~(1UL << (reg & 31));
+    }
+}
+
+static HAL_StatusTypeDef ICM_SelectBank(uint8_t bank)
 {
-	HAL_StatusTypeDef result = HAL_OK;
+    HAL_StatusTypeDef status;
 
-    // Send the register address to read from
-    result = HAL_I2C_Master_Transmit(&ICM_I2C, ICM20948_ADDR << 1, &reg, 1, 100);
-    if (result != HAL_OK)
+    if (bank == icm_bank)
     {
-        return result;  // Return if there's an error transmitting the register address
+        icm_bus_stats.bank_skipped++;
+        return HAL_OK;
     }
 
-    // Read bytes
-    result = HAL_I2C_Master_Receive(&ICM_I2C, ICM20948_ADDR << 1, pData, size, 50*size);
-    return result;
+    status = HAL_I2C_Mem_Write(&ICM_I2C, ICM20948_ADDR << 1, ICM20948_REG_BANK_SEL, I2C_MEMADD_SIZE_8BIT,
+                               &bank, 1, ICM_I2C_TIMEOUT_MS);
+    icm_bus_stats.transactions++;
+    icm_bank = (status == HAL_OK) ? bank : ICM_BANK_UNKNOWN;
+    return status;
 }
 
-static HAL_StatusTypeDef ICM_WriteBytes(uint8_t reg, uint8_t *pData, uint16_t size)
+static HAL_StatusTypeDef ICM_RegWrite(uint8_t bank, uint8_t reg, uint8_t val)
 {
-    HAL_StatusTypeDef result = HAL_OK;
-    uint8_t buffer[16];
+    HAL_StatusTypeDef status;
+    uint8_t cur;
 
-    if (size > sizeof(buffer) - 1) return HAL_ERROR; // prevent buffer overflow
+    if (ICM_ShadowGet(bank, reg, &cur) && cur == val)
+    {
+        icm_bus_stats.writes_skipped++;
+        return HAL_OK;
+    }
 
-    buffer[0] = reg;
-    memcpy(&buffer[1], pData, size);
+    status = ICM_SelectBank(bank);
+    if (status != HAL_OK)
+    {
+        return status;
+    }
+    status = HAL_I2C_Mem_Write(&ICM_I2C, ICM20948_ADDR << 1, reg, I2C_MEMADD_SIZE_8BIT, &val, 1, ICM_I2C_TIMEOUT_MS);
+    icm_bus_stats.transactions++;
 
-    result = HAL_I2C_Master_Transmit(&ICM_I2C, ICM20948_ADDR << 1, buffer, size + 1, 100);
-    return result;
+    if (status == HAL_OK && bank == ICM20948_USER_BANK_0 && reg == ICM20948_PWR_MGMT_1 && (val & ICM_PWR_MGMT_1_RESET))
+    {
+        // Every register, the bank select included, goes back to its default
+        ICM_ShadowInvalidate();
+    }
+    else if (bank == ICM20948_USER_BANK_0 && reg == ICM20948_USER_CTRL)
+    {
+        ICM_ShadowSet(bank, reg, val & ~ICM_USER_CTRL_RST_BITS, status == HAL_OK);
+    }
+    else
+    {
+        ICM_ShadowSet(bank, reg, val, status == HAL_OK);
+    }
+    return status;
+}
+
+static HAL_StatusTypeDef ICM_DataRead(uint8_t bank, uint8_t reg, uint8_t *pData, uint16_t size)
+{
+    HAL_StatusTypeDef status;
+
+    status = ICM_SelectBank(bank);
+    if (status != HAL_OK)
+    {
+        return status;
+    }
+    status = HAL_I2C_Mem_Read(&ICM_I2C, ICM20948_ADDR << 1, reg, I2C_MEMADD_SIZE_8BIT, pData, size, 50*size);
+    icm_bus_stats.transactions++;
+    return status;
 }
 
+/* Configuration register read, from the shadow when this driver wrote it */
+static HAL_StatusTypeDef ICM_RegRead(uint8_t bank, uint8_t reg, uint8_t *val)
+{
+    if (ICM_ShadowGet(bank, reg, val))
+    {
+        icm_bus_stats.reads_cached++;
+        return HAL_OK;
+    }
+    return ICM_DataRead(bank, reg, val, 1);
+}
 
-static void ICM_SelectBank(uint8_t bank)
+void ICM_GetBusStats(ICM_BusStats *stats)
 {
-    uint8_t val = bank;
-    HAL_I2C_Mem_Write(&ICM_I2C, ICM20948_ADDR << 1, ICM20948_REG_BANK_SEL, I2C_MEMADD_SIZE_8BIT, &val, 1, 100);
+    *stats = icm_bus_stats;
 }
 
 uint8_t ICM_WHOAMI(void) {
 	uint8_t data = 0x01;
-	if(ICM_readBytes(ICM20948_WHO_AM_I_REG, &data, 1) != HAL_OK)
+	if(ICM_DataRead(ICM20948_USER_BANK_0, ICM20948_WHO_AM_I_REG, &data, 1) != HAL_OK)
 	{
 		return 0x00;
 	}
@@ -62,9 +164,11 @@ uint8_t ICM_Init(void)
     HAL_StatusTypeDef status;
     uint8_t whoami = 0;
 
+    // The part may have kept its bank and settings across an MCU reset
+    ICM_ShadowInvalidate();
+
     // 1. Read WHO_AM_I
-    ICM_SelectBank(ICM20948_USER_BANK_0);
-    status = ICM_readBytes(ICM20948_WHO_AM_I_REG, &whoami, 1);
+    status = ICM_DataRead(ICM20948_USER_BANK_0, ICM20948_WHO_AM_I_REG, &whoami, 1);
     if (status != HAL_OK || whoami != 0xEA)
     {
         printf("ICM20948 not found. WHOAMI: 0x%02X\r\n", whoami);
@@ -73,69 +177,52 @@ uint8_t ICM_Init(void)
     printf("ICM20948 WHOAMI OK: 0x%02X\r\n", whoami);
 
     // 2. Reset device (set DEVICE_RESET bit in PWR_MGMT_1)
-    uint8_t reset_cmd = 0x80;
-    status = ICM_WriteBytes(ICM20948_PWR_MGMT_1, &reset_cmd, 1);
+    status = ICM_RegWrite(ICM20948_USER_BANK_0, ICM20948_PWR_MGMT_1, ICM_PWR_MGMT_1_RESET);
     HAL_Delay(100);  // Wait for reset
     if (status != HAL_OK) return status;
 
     // 3. Wake up and set clock source
-    uint8_t pwr_mgmt_1 = 0x01;  // sleep=0, clock=auto
-    status = ICM_WriteBytes(ICM20948_PWR_MGMT_1, &pwr_mgmt_1, 1);
+    status = ICM_RegWrite(ICM20948_USER_BANK_0, ICM20948_PWR_MGMT_1, 0x01);  // sleep=0, clock=auto
     if (status != HAL_OK) return status;
     HAL_Delay(10);
 
     // 4. Enable all sensors (Accel, Gyro, Temp)
-    uint8_t pwr_mgmt_2 = 0x00; // All on
-    status = ICM_WriteBytes(ICM20948_PWR_MGMT_2, &pwr_mgmt_2, 1);
+    status = ICM_RegWrite(ICM20948_USER_BANK_0, ICM20948_PWR_MGMT_2, 0x00); // All on
     if (status != HAL_OK) return status;
 
     // 4.5 Disable Low Power Mode (LP_EN = 0)
-    uint8_t lp_config = 0x00;
-    status = ICM_WriteBytes(ICM20948_LP_CONFIG, &lp_config, 1);  // LP_CONFIG register (bank 0)
+    status = ICM_RegWrite(ICM20948_USER_BANK_0, ICM20948_LP_CONFIG, 0x00);
     if (status != HAL_OK) return status;
 
     // 5. Enable I2C master interface (to use I2C slave interface)
-    uint8_t user_ctrl = 0x20;
-    status = ICM_WriteBytes(ICM20948_USER_CTRL, &user_ctrl, 1);
+    status = ICM_RegWrite(ICM20948_USER_BANK_0, ICM20948_USER_CTRL, 0x20);
     if (status != HAL_OK) return status;
 
-    // Switch to USER BANK 3
-    ICM_SelectBank(ICM20948_USER_BANK_3);
-
     // Set I2C Master Clock Speed (400kHz)
-    uint8_t i2c_mst_ctrl = 0x07;  // I2C_MST_CLK = 7 = 345.6 kHz (closest to 400kHz)
-    status = ICM_WriteBytes(0x01, &i2c_mst_ctrl, 1);
+    // I2C_MST_CLK = 7 = 345.6 kHz (closest to 400kHz)
+    status = ICM_RegWrite(ICM20948_USER_BANK_3, ICM20948_I2C_MST_CTRL, 0x07);
     if (status != HAL_OK) return status;
 
-    // 6. Select USER BANK 2 for gyro and accel config
-    ICM_SelectBank(ICM20948_USER_BANK_2);
-
     // 7. Configure gyroscope (±2000 dps, 17Hz BW)
-    uint8_t gyro_config_1 = 0x06; // FCHOICE=0, DLPFCFG=6 (17Hz), FS_SEL=3 (±2000dps)
-    status = ICM_WriteBytes(ICM20948_GYRO_CONFIG_1, &gyro_config_1, 1);
+    // FCHOICE=0, DLPFCFG=6 (17Hz), FS_SEL=3 (±2000dps)
+    status = ICM_RegWrite(ICM20948_USER_BANK_2, ICM20948_GYRO_CONFIG_1, 0x06);
     if (status != HAL_OK) return status;
 
     // 8. Configure accelerometer (±16g, 17Hz BW)
-    uint8_t accel_config = 0x06; // FCHOICE=1, DLPFCFG=6, FS_SEL=3 (±16g)
-    status = ICM_WriteBytes(ICM20948_ACCEL_CONFIG, &accel_config, 1);
+    // FCHOICE=1, DLPFCFG=6, FS_SEL=3 (±16g)
+    status = ICM_RegWrite(ICM20948_USER_BANK_2, ICM20948_ACCEL_CONFIG, 0x06);
     if (status != HAL_OK) return status;
 
     // Set I2C_SLV0 to write to AK09916 CNTL2 (0x31) to set continuous mode 2 (100Hz)
-    uint8_t slv0_addr = 0x0C;  // AK09916 I2C addr (write)
-    uint8_t reg = 0x31;
-    uint8_t data = 0x08; // Continuous measurement mode 2 (100Hz)
-
-    // Set register to write to (CNTL2)
-    status = ICM_WriteBytes(ICM20948_I2C_SLV0_ADDR, &slv0_addr, 1);
+    status = ICM_RegWrite(ICM20948_USER_BANK_3, ICM20948_I2C_SLV0_ADDR, AK09916_ADDRESS);  // AK09916 I2C addr (write)
     if (status != HAL_OK) return status;
-    status = ICM_WriteBytes(ICM20948_I2C_SLV0_REG, &reg, 1);
+    status = ICM_RegWrite(ICM20948_USER_BANK_3, ICM20948_I2C_SLV0_REG, AK09916_CNTL2);
     if (status != HAL_OK) return status;
-    status = ICM_WriteBytes(ICM20948_I2C_SLV0_DO, &data, 1);
+    status = ICM_RegWrite(ICM20948_USER_BANK_3, ICM20948_I2C_SLV0_DO, 0x08);  // Continuous measurement mode 2 (100Hz)
     if (status != HAL_OK) return status;
 
     // Enable I2C_SLV0 for one write
-    uint8_t ctrl = 0x81;  // Enable, 1 byte
-    status = ICM_WriteBytes(ICM20948_I2C_SLV0_CTRL, &ctrl, 1);
+    status = ICM_RegWrite(ICM20948_USER_BANK_3, ICM20948_I2C_SLV0_CTRL, 0x81);  // Enable, 1 byte
     if (status != HAL_OK) return status;
 
     HAL_Delay(10);  // Let mag config complete
@@ -154,9 +241,7 @@ float ICM_ReadTemperature(void) {
     uint8_t rawData[2];
     float temperatureC = 0.0;
 
-    ICM_SelectBank(ICM20948_USER_BANK_0);  // Ensure correct register bank!
-
-    if (ICM_readBytes(ICM20948_TEMP_OUT_H, rawData, 2) != HAL_OK)
+    if (ICM_DataRead(ICM20948_USER_BANK_0, ICM20948_TEMP_OUT_H, rawData, 2) != HAL_OK)
     {
         printf("Failed to read temperature registers.\r\n");
         return temperatureC;
@@ -171,9 +256,8 @@ float ICM_ReadTemperature(void) {
 uint8_t ICM_ReadAccel(ICM_Axis3D *accel)
 {
     uint8_t rawData[6];
-    ICM_SelectBank(ICM20948_USER_BANK_0);
 
-    if (ICM_readBytes(ICM20948_ACCEL_XOUT_H, rawData, 6) != HAL_OK)
+    if (ICM_DataRead(ICM20948_USER_BANK_0, ICM20948_ACCEL_XOUT_H, rawData, 6) != HAL_OK)
         return HAL_ERROR;
 
     accel->x = (int16_t)((rawData[0] << 8) | rawData[1]);
@@ -186,9 +270,8 @@ uint8_t ICM_ReadAccel(ICM_Axis3D *accel)
 uint8_t ICM_ReadGyro(ICM_Axis3D *gyro)
 {
     uint8_t rawData[6];
-    ICM_SelectBank(ICM20948_USER_BANK_0);
 
-    if (ICM_readBytes(ICM20948_GYRO_XOUT_H, rawData, 6) != HAL_OK)
+    if (ICM_DataRead(ICM20948_USER_BANK_0, ICM20948_GYRO_XOUT_H, rawData, 6) != HAL_OK)
         return HAL_ERROR;
 
     gyro->x = (int16_t)((rawData[0] << 8) | rawData[1]);
@@ -202,27 +285,29 @@ uint8_t ICM_ReadMag(ICM_Axis3D *mag)
 {
 	HAL_StatusTypeDef status;
     uint8_t mag_raw[6];
+    uint8_t addr, start_reg, ctrl;
 
+    // Configure I2C_SLV0 to auto-read at least 6 bytes from AK09916 starting at 0x11 (HXL),
+    // unless the shadow shows it already does
+    if (ICM_ShadowGet(ICM20948_USER_BANK_3, ICM20948_I2C_SLV0_ADDR, &addr) && addr == (0x80 | AK09916_ADDRESS) &&
+        ICM_ShadowGet(ICM20948_USER_BANK_3, ICM20948_I2C_SLV0_REG, &start_reg) && start_reg == AK09916_XOUT_L &&
+        ICM_ShadowGet(ICM20948_USER_BANK_3, ICM20948_I2C_SLV0_CTRL, &ctrl) && (ctrl & 0x80) && (ctrl & 0x0F) >= 6)
+    {
+        status = HAL_OK;
+    }
+    else
+    {
+        status = ICM_RegWrite(ICM20948_USER_BANK_3, ICM20948_I2C_SLV0_ADDR, 0x80 | AK09916_ADDRESS); // AK09916 read address
+        if (status != HAL_OK) return status;
+        status = ICM_RegWrite(ICM20948_USER_BANK_3, ICM20948_I2C_SLV0_REG, AK09916_XOUT_L); // HXL
+        if (status != HAL_OK) return status;
+        status = ICM_RegWrite(ICM20948_USER_BANK_3, ICM20948_I2C_SLV0_CTRL, 0x86); // Enable, read 6 bytes
+        if (status != HAL_OK) return status;
+
+        HAL_Delay(10);  // Wait for data to populate
+    }
 
-    // Configure I2C_SLV0 to auto-read 6 bytes from AK09916 starting at 0x11 (HXL)
-    ICM_SelectBank(ICM20948_USER_BANK_3);
-
-    uint8_t slv0_addr = 0x8C; // AK09916 read address (0x0C << 1 | 1)
-    uint8_t start_reg = 0x11; // HXL
-    uint8_t ctrl = 0x86;      // Enable, read 6 bytes
-
-    status = ICM_WriteBytes(ICM20948_I2C_SLV0_ADDR, &slv0_addr, 1);
-    if (status != HAL_OK) return status;
-    status = ICM_WriteBytes(ICM20948_I2C_SLV0_REG, &start_reg, 1);
-    if (status != HAL_OK) return status;
-    status = ICM_WriteBytes(ICM20948_I2C_SLV0_CTRL, &ctrl, 1);
-    if (status != HAL_OK) return status;
-
-    HAL_Delay(10);  // Wait for data to populate
-
-    ICM_SelectBank(ICM20948_USER_BANK_0);
-
-    if (ICM_readBytes(ICM20948_EXT_SENS_DATA_00, mag_raw, 6) != HAL_OK)
+    if (ICM_DataRead(ICM20948_USER_BANK_0, ICM20948_EXT_SENS_DATA_00, mag_raw, 6) != HAL_OK)
         return HAL_ERROR;
 
     mag->x = (int16_t)((mag_raw[1] << 8) | mag_raw[0]);
@@ -236,44 +321,477 @@ void ICM_DumpRegisters(void)
 {
     uint8_t val;
 
-    printf("\r\n=== ICM20948 REGISTER DUMP ===\r\n");
+    LOGB("\r\n=== ICM20948 REGISTER DUMP ===\r\n");
 
     // --- USER BANK 0 ---
-    ICM_SelectBank(ICM20948_USER_BANK_0);
-    printf("USER BANK 0:\r\n");
+    LOGB("USER BANK 0:\r\n");
 
-    ICM_readBytes(ICM20948_WHO_AM_I_REG, &val, 1);
-    printf("WHO_AM_I        (0x00): 0x%02X\r\n", val);
+    ICM_RegRead(ICM20948_USER_BANK_0, ICM20948_WHO_AM_I_REG, &val);
+    LOGB("WHO_AM_I        (0x00): 0x%02X\r\n", val);
 
-    ICM_readBytes(ICM20948_PWR_MGMT_1, &val, 1);
-    printf("PWR_MGMT_1      (0x06): 0x%02X\r\n", val);
+    ICM_RegRead(ICM20948_USER_BANK_0, ICM20948_PWR_MGMT_1, &val);
+    LOGB("PWR_MGMT_1      (0x06): 0x%02X\r\n", val);
 
-    ICM_readBytes(ICM20948_PWR_MGMT_2, &val, 1);
-    printf("PWR_MGMT_2      (0x07): 0x%02X\r\n", val);
+    ICM_RegRead(ICM20948_USER_BANK_0, ICM20948_PWR_MGMT_2, &val);
+    LOGB("PWR_MGMT_2      (0x07): 0x%02X\r\n", val);
 
-    ICM_readBytes(0x03, &val, 1);
-    printf("USER_CTRL       (0x03): 0x%02X\r\n", val);
+    ICM_RegRead(ICM20948_USER_BANK_0, ICM20948_USER_CTRL, &val);
+    LOGB("USER_CTRL       (0x03): 0x%02X\r\n", val);
 
-    ICM_readBytes(0x05, &val, 1);
-    printf("LP_CONFIG       (0x05): 0x%02X\r\n", val);
+    ICM_RegRead(ICM20948_USER_BANK_0, ICM20948_LP_CONFIG, &val);
+    LOGB("LP_CONFIG       (0x05): 0x%02X\r\n", val);
 
-    ICM_readBytes(ICM20948_TEMP_OUT_H, &val, 1);
-    printf("TEMP_OUT_H      (0x39): 0x%02X\r\n", val);
-    ICM_readBytes(ICM20948_TEMP_OUT_L, &val, 1);
-    printf("TEMP_OUT_L      (0x3A): 0x%02X\r\n", val);
+    ICM_DataRead(ICM20948_USER_BANK_0, ICM20948_TEMP_OUT_H, &val, 1);
+    LOGB("TEMP_OUT_H      (0x39): 0x%02X\r\n", val);
+    ICM_DataRead(ICM20948_USER_BANK_0, ICM20948_TEMP_OUT_L, &val, 1);
+    LOGB("TEMP_OUT_L      (0x3A): 0x%02X\r\n", val);
 
     // --- USER BANK 2 ---
-    ICM_SelectBank(ICM20948_USER_BANK_2);
-    printf("\r\nUSER BANK 2:\r\n");
+    LOGB("\r\nUSER BANK 2:\r\n");
 
-    ICM_readBytes(0x01, &val, 1);
-    printf("GYRO_CONFIG_1   (0x01): 0x%02X\r\n", val);
+    ICM_RegRead(ICM20948_USER_BANK_2, ICM20948_GYRO_CONFIG_1, &val);
+    LOGB("GYRO_CONFIG_1   (0x01): 0x%02X\r\n", val);
 
-    ICM_readBytes(0x14, &val, 1);
-    printf("ACCEL_CONFIG    (0x14): 0x%02X\r\n", val);
+    ICM_RegRead(ICM20948_USER_BANK_2, ICM20948_ACCEL_CONFIG, &val);
+    LOGB("ACCEL_CONFIG    (0x14): 0x%02X\r\n", val);
 
     // Return to bank 0
     ICM_SelectBank(ICM20948_USER_BANK_0);
-    printf("=== END DUMP ===\r\n\r\n");
+    LOGB("=== END DUMP ===\r\n\r\n");
+}
+
+/* ---- Interrupt-driven sampling ---- */
+
+#define ICM_INT_RAW_DATA_RDY        (0x01)  // INT_ENABLE_1: RAW_DATA_0_RDY_EN
+#define ICM_SLV0_MAG_LEN            (8)     // HXL..ST2, reading ST2 releases the data latch
+#define ICM_USER_CTRL_I2C_MST_EN    (0x20)
+#define ICM_USER_CTRL_FIFO_EN       (0x40)
+#define ICM_FIFO_EN_ACCEL_GYRO      (0x1E)  // FIFO_EN_2: ACCEL, GYRO_Z, GYRO_Y, GYRO_X
+#define ICM_FIFO_RST_ALL            (0x1F)
+#define ICM_FIFO_MODE_SNAPSHOT      (0x01)  // Stop writing when full, keeps frames aligned
+#define ICM_XFER_TIMEOUT_MS         (100)   // A full FIFO drain at 400 kHz takes ~95 ms
+
+typedef enum {
+    ICM_MODE_OFF = 0,
+    ICM_MODE_DRDY,                          /* One burst per data-ready edge */
+    ICM_MODE_FIFO,                          /* Batched FIFO drains */
+} ICM_Mode;
+
+typedef enum {
+    ICM_XFER_IDLE = 0,
+    ICM_XFER_SAMPLE,                        /* Data-ready burst */
+    ICM_XFER_FIFO_COUNT,                    /* FIFO_COUNTH/L */
+    ICM_XFER_FIFO_DATA,                     /* FIFO_R_W drain */
+} ICM_Xfer;
+
+typedef struct {
+    uint64_t timestamp;
+    uint8_t raw[ICM_BURST_LEN];
+} ICM_RawSample;
+
+static uint8_t icm_burst_buf[ICM_BURST_LEN];
+static uint8_t icm_queue_buf[ICM_SAMPLE_QUEUE * (LWRB_MQ_HDR_SIZE + sizeof(ICM_RawSample)) + 1];
+static lwrb_mq_t icm_queue;
+static volatile ICM_SamplingStats icm_stats;
+static volatile uint64_t icm_edge_time;
+static volatile ICM_Xfer icm_xfer = ICM_XFER_IDLE;
+static volatile ICM_Mode icm_mode = ICM_MODE_OFF;
+
+static uint8_t icm_fifo_buf[ICM_FIFO_SIZE];
+static uint8_t icm_fifo_count_buf[2];
+static volatile uint16_t icm_fifo_count;
+static volatile uint16_t icm_fifo_len;
+static volatile uint64_t icm_fifo_time;
+static volatile bool icm_fifo_ready = false;
+static bool icm_fifo_reset_pending = false;
+static uint16_t icm_fifo_watermark;
+static uint64_t icm_fifo_last;
+
+/* Full-rate ODR and magnetometer mirroring; leaves bank 0 selected */
+static HAL_StatusTypeDef ICM_ConfigureOdr(void)
+{
+    HAL_StatusTypeDef status;
+
+    // Gyro and accel at the full 1125 Hz ODR with DLPF on (FCHOICE=1, DLPFCFG=1, FS_SEL=3)
+    status = ICM_RegWrite(ICM20948_USER_BANK_2, ICM20948_GYRO_SMPLRT_DIV, 0x00);
+    if (status == HAL_OK) status = ICM_RegWrite(ICM20948_USER_BANK_2, ICM20948_GYRO_CONFIG_1, 0x0F);
+    if (status == HAL_OK) status = ICM_RegWrite(ICM20948_USER_BANK_2, ICM20948_ACCEL_SMPLRT_DIV_1, 0x00);
+    if (status == HAL_OK) status = ICM_RegWrite(ICM20948_USER_BANK_2, ICM20948_ACCEL_SMPLRT_DIV_2, 0x00);
+    if (status == HAL_OK) status = ICM_RegWrite(ICM20948_USER_BANK_2, ICM20948_ACCEL_CONFIG, 0x0F);
+    if (status == HAL_OK) status = ICM_RegWrite(ICM20948_USER_BANK_2, ICM20948_ODR_ALIGN_EN, 0x01);
+
+    // SLV0 mirrors the AK09916 output and ST2 into EXT_SENS_DATA_00..07 every sample
+    if (status == HAL_OK) status = ICM_RegWrite(ICM20948_USER_BANK_3, ICM20948_I2C_SLV0_ADDR, 0x80 | AK09916_ADDRESS);
+    if (status == HAL_OK) status = ICM_RegWrite(ICM20948_USER_BANK_3, ICM20948_I2C_SLV0_REG, AK09916_XOUT_L);
+    if (status == HAL_OK) status = ICM_RegWrite(ICM20948_USER_BANK_3, ICM20948_I2C_SLV0_CTRL, 0x80 | ICM_SLV0_MAG_LEN);
+
+    // The DMA reads address bank 0 registers directly
+    if (status == HAL_OK) status = ICM_SelectBank(ICM20948_USER_BANK_0);
+    return status;
 }
 
+static HAL_StatusTypeDef ICM_FifoReset(void)
+{
+    HAL_StatusTypeDef status;
+
+    status = ICM_RegWrite(ICM20948_USER_BANK_0, ICM20948_FIFO_RST, ICM_FIFO_RST_ALL);
+    if (status == HAL_OK) status = ICM_RegWrite(ICM20948_USER_BANK_0, ICM20948_FIFO_RST, 0x00);
+    return status;
+}
+
+static void ICM_ResetStats(void)
+{
+    lwrb_mq_init(&icm_queue, icm_queue_buf, sizeof(icm_queue_buf));
+    memset((void *)&icm_stats, 0, sizeof(icm_stats));
+    icm_fifo_ready = false;
+    icm_fifo_reset_pending = false;
+}
+
+uint8_t ICM_StartSampling(void)
+{
+    HAL_StatusTypeDef status;
+
+    if (icm_mode == ICM_MODE_DRDY)
+    {
+        return HAL_OK;
+    }
+    ICM_StopSampling();
+    if (!i2c_bus_claim(I2C_BUS_IMU))
+    {
+        return HAL_BUSY;
+    }
+
+    status = ICM_ConfigureOdr();
+
+    // INT1 push-pull, active high, 50 us pulse on raw data ready
+    if (status == HAL_OK) status = ICM_RegWrite(ICM20948_USER_BANK_0, ICM20948_INT_PIN_CFG, 0x00);
+    if (status == HAL_OK) status = ICM_RegWrite(ICM20948_USER_BANK_0, ICM20948_INT_ENABLE_1, ICM_INT_RAW_DATA_RDY);
+
+    i2c_bus_release(I2C_BUS_IMU);
+    if (status != HAL_OK)
+    {
+        printf("ICM20948 sampling setup failed\r\n");
+        return status;
+    }
+
+    ICM_ResetStats();
+    icm_mode = ICM_MODE_DRDY;
+
+    // ICM_INT (PG3) and its EXTI line are configured by MX_GPIO_Init()
+    __HAL_GPIO_EXTI_CLEAR_IT(ICM_INT_Pin);
+    HAL_NVIC_EnableIRQ(ICM_INT_EXTI_IRQn);
+
+    printf("ICM20948 sampling started\r\n");
+    return HAL_OK;
+}
+
+/*
+ * Accel and gyro go through the on-chip FIFO instead, and ICM_FifoProcess()
+ * drains it in one burst once about `watermark` frames have accumulated.
+ * The part has no programmable watermark interrupt, so the fill level is
+ * estimated from the ODR and checked against FIFO_COUNT when draining.
+ */
+uint8_t ICM_StartFifo(uint16_t watermark)
+{
+    HAL_StatusTypeDef status;
+
+    if (watermark == 0 || watermark >= ICM_FIFO_MAX_FRAMES)
+    {
+        return HAL_ERROR;
+    }
+    ICM_StopSampling();
+    if (!i2c_bus_claim(I2C_BUS_IMU))
+    {
+        return HAL_BUSY;
+    }
+
+    status = ICM_ConfigureOdr();
+    if (status == HAL_OK) status = ICM_RegWrite(ICM20948_USER_BANK_0, ICM20948_FIFO_MODE, ICM_FIFO_MODE_SNAPSHOT);
+    if (status == HAL_OK) status = ICM_RegWrite(ICM20948_USER_BANK_0, ICM20948_FIFO_EN_1, 0x00);
+    if (status == HAL_OK) status = ICM_RegWrite(ICM20948_USER_BANK_0, ICM20948_FIFO_EN_2, ICM_FIFO_EN_ACCEL_GYRO);
+    if (status == HAL_OK) status = ICM_RegWrite(ICM20948_USER_BANK_0, ICM20948_USER_CTRL, ICM_USER_CTRL_I2C_MST_EN | ICM_USER_CTRL_FIFO_EN);
+    if (status == HAL_OK) status = ICM_FifoReset();
+
+    i2c_bus_release(I2C_BUS_IMU);
+    if (status != HAL_OK)
+    {
+        printf("ICM20948 FIFO setup failed\r\n");
+        return status;
+    }
+
+    ICM_ResetStats();
+    icm_fifo_watermark = watermark;
+    icm_fifo_last = util_cycles();
+    icm_mode = ICM_MODE_FIFO;
+
+    printf("ICM20948 FIFO batching started, %u frame watermark\r\n", watermark);
+    return HAL_OK;
+}
+
+void ICM_StopSampling(void)
+{
+    uint32_t start;
+
+    if (icm_mode == ICM_MODE_OFF)
+    {
+        return;
+    }
+
+    HAL_NVIC_DisableIRQ(ICM_INT_EXTI_IRQn);
+    icm_mode = ICM_MODE_OFF;
+
+    // Let a read in flight land before touching the bus again
+    start = HAL_GetTick();
+    while (icm_xfer != ICM_XFER_IDLE && HAL_GetTick() - start < ICM_XFER_TIMEOUT_MS)
+    {
+    }
+
+    if (i2c_bus_claim(I2C_BUS_IMU))
+    {
+        ICM_RegWrite(ICM20948_USER_BANK_0, ICM20948_INT_ENABLE_1, 0x00);
+        ICM_RegWrite(ICM20948_USER_BANK_0, ICM20948_FIFO_EN_2, 0x00);
+        ICM_RegWrite(ICM20948_USER_BANK_0, ICM20948_USER_CTRL, ICM_USER_CTRL_I2C_MST_EN);
+        i2c_bus_release(I2C_BUS_IMU);
+    }
+}
+
+static void ICM_XferEnd(void)
+{
+    icm_xfer = ICM_XFER_IDLE;
+    i2c_bus_release(I2C_BUS_IMU);
+}
+
+/* Data-ready edge: timestamp it and start the burst read */
+void ICM_EXTI_Callback(void)
+{
+    uint64_t now = util_cycles();
+
+    if (icm_mode != ICM_MODE_DRDY)
+    {
+        return;
+    }
+    if (icm_xfer != ICM_XFER_IDLE)
+    {
+        icm_stats.overruns++;
+        return;
+    }
+    if (!i2c_bus_claim(I2C_BUS_IMU))
+    {
+        icm_stats.bus_busy++;
+        return;
+    }
+
+    icm_edge_time = now;
+    icm_xfer = ICM_XFER_SAMPLE;
+    if (HAL_I2C_Mem_Read_DMA(&ICM_I2C, ICM20948_ADDR << 1, ICM_BURST_REG, I2C_MEMADD_SIZE_8BIT,
+                             icm_burst_buf, ICM_BURST_LEN) != HAL_OK)
+    {
+        icm_stats.errors++;
+        ICM_XferEnd();
+    }
+}
+
+static void ICM_QueueSample(void)
+{
+    ICM_RawSample rec;
+
+    rec.timestamp = icm_edge_time;
+    memcpy(rec.raw, icm_burst_buf, sizeof(rec.raw));
+    if (lwrb_mq_put(&icm_queue, &rec, sizeof(rec)))
+    {
+        icm_stats.samples++;
+    }
+    else
+    {
+        icm_stats.queue_full++;
+    }
+}
+
+/* FIFO_COUNT is in: drain the whole frames it reports. Returns true if a read was started */
+static bool ICM_FifoStartDrain(void)
+{
+    uint16_t count = (uint16_t)(((icm_fifo_count_buf[0] & 0x1F) << 8) | icm_fifo_count_buf[1]);
+    uint16_t len = (count > ICM_FIFO_SIZE) ? ICM_FIFO_SIZE : count;
+
+    icm_fifo_count = count;
+    icm_fifo_time = util_cycles();
+    icm_fifo_len = len - len % ICM_FIFO_FRAME;
+    if (icm_mode != ICM_MODE_FIFO || icm_fifo_len == 0)
+    {
+        return false;
+    }
+
+    icm_xfer = ICM_XFER_FIFO_DATA;
+    if (HAL_I2C_Mem_Read_DMA(&ICM_I2C, ICM20948_ADDR << 1, ICM20948_FIFO_R_W, I2C_MEMADD_SIZE_8BIT,
+                             icm_fifo_buf, icm_fifo_len) != HAL_OK)
+    {
+        icm_stats.errors++;
+        return false;
+    }
+    return true;
+}
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    if (hi2c->Instance != ICM_I2C.Instance)
+    {
+        return;
+    }
+
+    switch (icm_xfer)
+    {
+    case ICM_XFER_SAMPLE:
+        ICM_QueueSample();
+        break;
+    case ICM_XFER_FIFO_COUNT:
+        if (ICM_FifoStartDrain())
+        {
+            return;
+        }
+        break;
+    case ICM_XFER_FIFO_DATA:
+        icm_fifo_ready = true;
+        break;
+    default:
+        return;
+    }
+
+    ICM_XferEnd();
+}
+
+void ICM_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+    (void)hi2c;
+
+    icm_stats.errors++;
+    ICM_XferEnd();
+}
+
+/* Pop the oldest sample, main loop only */
+bool ICM_GetSample(ICM_Sample *sample)
+{
+    ICM_RawSample rec;
+    const uint8_t *r = rec.raw;
+
+    if (lwrb_mq_get(&icm_queue, &rec, sizeof(rec)) != sizeof(rec))
+    {
+        return false;
+    }
+
+    sample->timestamp = rec.timestamp;
+    sample->accel.x = (int16_t)((r[0] << 8) | r[1]);
+    sample->accel.y = (int16_t)((r[2] << 8) | r[3]);
+    sample->accel.z = (int16_t)((r[4] << 8) | r[5]);
+    sample->gyro.x = (int16_t)((r[6] << 8) | r[7]);
+    sample->gyro.y = (int16_t)((r[8] << 8) | r[9]);
+    sample->gyro.z = (int16_t)((r[10] << 8) | r[11]);
+    sample->temp = (int16_t)((r[12] << 8) | r[13]);
+    sample->mag.x = (int16_t)((r[15] << 8) | r[14]);
+    sample->mag.y = (int16_t)((r[17] << 8) | r[16]);
+    sample->mag.z = (int16_t)((r[19] << 8) | r[18]);
+    sample->mag_status = r[21];
+
+    return true;
+}
+
+/*
+ * Decode a FIFO dump of accel+gyro frames read against `fifo_count`. In
+ * snapshot mode the FIFO stops writing once it has no room for another
+ * frame, so a count in that range, or one that is not a whole number of
+ * frames, means frames were lost. A trailing partial frame is ignored.
+ */
+uint16_t ICM_FifoParse(const uint8_t *buf, uint16_t len, uint16_t fifo_count, ICM_FifoBatch *batch)
+{
+    uint16_t frames = (len < fifo_count ? len : fifo_count) / ICM_FIFO_FRAME;
+
+    if (frames > ICM_FIFO_MAX_FRAMES)
+    {
+        frames = ICM_FIFO_MAX_FRAMES;
+    }
+
+    for (uint16_t i = 0; i < frames; i++, buf += ICM_FIFO_FRAME)
+    {
+        batch->accel[i].x = (int16_t)((buf[0] << 8) | buf[1]);
+        batch->accel[i].y = (int16_t)((buf[2] << 8) | buf[3]);
+        batch->accel[i].z = (int16_t)((buf[4] << 8) | buf[5]);
+        batch->gyro[i].x = (int16_t)((buf[6] << 8) | buf[7]);
+        batch->gyro[i].y = (int16_t)((buf[8] << 8) | buf[9]);
+        batch->gyro[i].z = (int16_t)((buf[10] << 8) | buf[11]);
+    }
+
+    batch->frames = frames;
+    batch->overflow = fifo_count > ICM_FIFO_SIZE - ICM_FIFO_FRAME || (fifo_count % ICM_FIFO_FRAME) != 0;
+    return frames;
+}
+
+/*
+ * Main loop poll for FIFO mode. Starts a drain once the watermark is due
+ * and returns true when a new batch has been decoded into `batch`.
+ */
+bool ICM_FifoProcess(ICM_FifoBatch *batch)
+{
+    if (icm_mode != ICM_MODE_FIFO)
+    {
+        return false;
+    }
+
+    if (icm_fifo_ready)
+    {
+        icm_fifo_ready = false;
+        ICM_FifoParse(icm_fifo_buf, icm_fifo_len, icm_fifo_count, batch);
+        batch->timestamp = icm_fifo_time;
+        icm_stats.batches++;
+        icm_stats.samples += batch->frames;
+        if (batch->overflow)
+        {
+            icm_stats.fifo_overflows++;
+            icm_fifo_reset_pending = true;
+        }
+        return true;
+    }
+
+    if (icm_xfer != ICM_XFER_IDLE)
+    {
+        return false;
+    }
+
+    // Realign after an overflow, dropping any partial frame
+    if (icm_fifo_reset_pending && i2c_bus_claim(I2C_BUS_IMU))
+    {
+        if (ICM_FifoReset() == HAL_OK)
+        {
+            icm_fifo_reset_pending = false;
+            icm_fifo_last = util_cycles();
+        }
+        i2c_bus_release(I2C_BUS_IMU);
+        return false;
+    }
+
+    if ((util_cycles() - icm_fifo_last) * ICM_ODR_HZ < (uint64_t)icm_fifo_watermark * SystemCoreClock)
+    {
+        return false;
+    }
+    if (!i2c_bus_claim(I2C_BUS_IMU))
+    {
+        return false;
+    }
+
+    icm_fifo_last = util_cycles();
+    icm_xfer = ICM_XFER_FIFO_COUNT;
+    if (HAL_I2C_Mem_Read_DMA(&ICM_I2C, ICM20948_ADDR << 1, ICM20948_FIFO_COUNTH, I2C_MEMADD_SIZE_8BIT,
+                             icm_fifo_count_buf, sizeof(icm_fifo_count_buf)) != HAL_OK)
+    {
+        icm_stats.errors++;
+        ICM_XferEnd();
+    }
+    return false;
+}
+
+void ICM_GetSamplingStats(ICM_SamplingStats *stats)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    memcpy(stats, (const void *)&icm_stats, sizeof(*stats));
+    __set_PRIMASK(primask);
+}
@@ -0,0 +1,272 @@
+/*
+ * bitstore.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Multi-slot CrossLink bitstream store in flash bank 2. The Lattice header
+ *  of every slot is parsed once by bitstore_init() into an index with small
+ *  hash tables, so a design is found by name or by CRC without scanning.
+ */
+
+#include "bitstore.h"
+#include "lz4_block.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BITSTORE_SLOT_MAGIC       "XSLT"
+#define BITSTORE_HASH_SIZE        8U      /* Power of two, > BITSTORE_NUM_SLOTS */
+#define BITSTORE_HASH_EMPTY       0xFF
+
+#define LATTICE_HDR_MAX           512U
+
+static bitstore_entry_t bitstore_index[BITSTORE_NUM_SLOTS];
+static uint32_t bitstore_name_hash[BITSTORE_NUM_SLOTS];
+static uint8_t bitstore_by_name[BITSTORE_HASH_SIZE];
+static uint8_t bitstore_by_crc[BITSTORE_HASH_SIZE];
+
+static union {
+    fpga_raw_source_t raw;
+    fpga_lz4_source_t lz4;
+} bitstore_src;
+
+/* Separate from bitstore_src: a slot may be re-indexed while another streams */
+static fpga_lz4_source_t bitstore_index_src;
+
+static uint32_t fnv1a(const char *s) {
+    uint32_t h = 2166136261UL;
+
+    while (*s) {
+        h ^= (uint8_t)*s++;
+        h *= 16777619UL;
+    }
+    return h;
+}
+
+static void copy_field(char *dst, const char *src, size_t len) {
+    size_t n = 0;
+
+    while (n < len && src[n] == ' ') {
+        src++;
+        len--;
+    }
+    if (len >= BITSTORE_NAME_LEN) {
+        len = BITSTORE_NAME_LEN - 1;
+    }
+    memcpy(dst, src, len);
+    dst[len] = '\0';
+}
+
+/*
+ * Parse the Lattice header: 0xFF 0x00, then NUL terminated "Key: value"
+ * strings, terminated by 0xFF.
+ */
+int bitstore_parse_header(const uint8_t *image, uint32_t len, bitstore_entry_t *entry) {
+    uint32_t pos = 2;
+
+    if (len < 2 || image[0] != 0xFF || image[1] != 0x00) {
+        return -1;
+    }
+    if (len > LATTICE_HDR_MAX) {
+        len = LATTICE_HDR_MAX;
+    }
+
+    while (pos < len && image[pos] != 0xFF) {
+        const char *str = (const char *)&image[pos];
+        uint32_t slen = 0;
+
+        while (pos + slen < len && image[pos + slen] != 0x00) {
+            slen++;
+        }
+        if (pos + slen >= len) {
+            return -1;
+        }
+
+        if (strncmp(str, "Design name:", 12) == 0) {
+            const char *ext = memchr(str, '.', slen);
+            copy_field(entry->name, str + 12, (ext ? (uint32_t)(ext - str) : slen) - 12);
+        } else if (strncmp(str, "Part:", 5) == 0) {
+            copy_field(entry->part, str + 5, slen - 5);
+        } else if (strncmp(str, "Date:", 5) == 0) {
+            copy_field(entry->date, str + 5, slen - 5);
+        } else if (strncmp(str, "Bitstream CRC:", 14) == 0) {
+            char hex[8];
+            copy_field(hex, str + 14, (slen - 14 < sizeof(hex) - 1) ? slen - 14 : sizeof(hex) - 1);
+            entry->crc = (uint16_t)strtoul(hex, NULL, 16);
+        }
+        pos += slen + 1;
+    }
+
+    return (entry->name[0] != '\0') ? 0 : -1;
+}
+
+static int hash_insert(uint8_t *table, uint32_t key, uint8_t slot) {
+    for (uint32_t i = 0; i < BITSTORE_HASH_SIZE; i++) {
+        uint32_t h = (key + i) & (BITSTORE_HASH_SIZE - 1);
+        if (table[h] == BITSTORE_HASH_EMPTY) {
+            table[h] = slot;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static void bitstore_index_slot(uint32_t slot) {
+    const uint8_t *base = (const uint8_t *)(BITSTORE_BASE + slot * BITSTORE_SLOT_SIZE);
+    bitstore_entry_t *e = &bitstore_index[slot];
+    uint32_t len;
+
+    memset(e, 0, sizeof(*e));
+    if (memcmp(base, BITSTORE_SLOT_MAGIC, 4) != 0) {
+        return;
+    }
+    memcpy(&len, &base[4], sizeof(len));
+    if (len == 0 || len > BITSTORE_MAX_IMAGE) {
+        return;
+    }
+
+    e->image = base + BITSTORE_HDR_SIZE;
+    e->image_len = len;
+    memcpy(&e->slot_crc, &base[8], sizeof(e->slot_crc));
+    e->image_crc = e->slot_crc;
+    if (memcmp(e->image, "XLZ4", 4) == 0) {
+        // The Lattice header sits at the start of the first block
+        fpga_lz4_source_t *lz4 = &bitstore_index_src;
+        const uint8_t *chunk;
+        e->compressed = true;
+        if (fpga_source_init_lz4(lz4, e->image, len) != 0 || lz4->base.acquire(&lz4->base, &chunk) <= 0) {
+            return;
+        }
+        e->image_crc = lz4->base.crc16;
+        e->valid = (bitstore_parse_header(chunk, lz4->block_size, e) == 0);
+    } else {
+        e->valid = (bitstore_parse_header(e->image, len, e) == 0);
+    }
+}
+
+static void bitstore_rebuild_hash(void) {
+    memset(bitstore_by_name, BITSTORE_HASH_EMPTY, sizeof(bitstore_by_name));
+    memset(bitstore_by_crc, BITSTORE_HASH_EMPTY, sizeof(bitstore_by_crc));
+
+    for (uint32_t slot = 0; slot < BITSTORE_NUM_SLOTS; slot++) {
+        if (!bitstore_index[slot].valid) {
+            continue;
+        }
+        bitstore_name_hash[slot] = fnv1a(bitstore_index[slot].name);
+        hash_insert(bitstore_by_name, bitstore_name_hash[slot], (uint8_t)slot);
+        hash_insert(bitstore_by_crc, bitstore_index[slot].crc, (uint8_t)slot);
+    }
+}
+
+void bitstore_init(void) {
+    for (uint32_t slot = 0; slot < BITSTORE_NUM_SLOTS; slot++) {
+        bitstore_index_slot(slot);
+    }
+    bitstore_rebuild_hash();
+
+    for (uint32_t slot = 0; slot < BITSTORE_NUM_SLOTS; slot++) {
+        const bitstore_entry_t *e = &bitstore_index[slot];
+        if (e->valid) {
+            printf("Slot %lu: %s %s CRC 0x%04X %lu bytes%s\r\n", (unsigned long)slot, e->name, e->part,
+                   e->crc, (unsigned long)e->image_len, e->compressed ? " (lz4)" : "");
+        }
+    }
+}
+
+const bitstore_entry_t *bitstore_entry(uint32_t slot) {
+    if (slot >= BITSTORE_NUM_SLOTS || !bitstore_index[slot].valid) {
+        return NULL;
+    }
+    return &bitstore_index[slot];
+}
+
+int bitstore_find_by_name(const char *name) {
+    uint32_t key = fnv1a(name);
+
+    for (uint32_t i = 0; i < BITSTORE_HASH_SIZE; i++) {
+        uint8_t slot = bitstore_by_name[(key + i) & (BITSTORE_HASH_SIZE - 1)];
+        if (slot == BITSTORE_HASH_EMPTY) {
+            break;
+        }
+        if (bitstore_name_hash[slot] == key && strcmp(bitstore_index[slot].name, name) == 0) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+int bitstore_find_by_crc(uint16_t crc) {
+    for (uint32_t i = 0; i < BITSTORE_HASH_SIZE; i++) {
+        uint8_t slot = bitstore_by_crc[(crc + i) & (BITSTORE_HASH_SIZE - 1)];
+        if (slot == BITSTORE_HASH_EMPTY) {
+            break;
+        }
+        if (bitstore_index[slot].crc == crc) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+/* Source streaming the slot to fpga_configure_start(); valid until the next call */
+fpga_source_t *bitstore_source(uint32_t slot) {
+    const bitstore_entry_t *e = bitstore_entry(slot);
+
+    if (e == NULL) {
+        return NULL;
+    }
+    if (e->compressed) {
+        if (fpga_source_init_lz4(&bitstore_src.lz4, e->image, e->image_len) != 0) {
+            return NULL;
+        }
+        return &bitstore_src.lz4.base;
+    }
+    fpga_source_init_raw(&bitstore_src.raw, e->image, e->image_len);
+    bitstore_src.raw.base.has_crc = true;
+    bitstore_src.raw.base.crc16 = e->image_crc;
+    return &bitstore_src.raw.base;
+}
+
+/* Erase a slot and write a new image (raw bitstream or XLZ4 container) into it */
+int bitstore_program(uint32_t slot, const uint8_t *image, uint32_t len) {
+    FLASH_EraseInitTypeDef erase = {0};
+    uint32_t addr = BITSTORE_BASE + slot * BITSTORE_SLOT_SIZE;
+    uint32_t sector_error;
+    uint32_t word[FLASH_NB_32BITWORD_IN_FLASHWORD];
+    HAL_StatusTypeDef ret;
+
+    if (slot >= BITSTORE_NUM_SLOTS || image == NULL || len == 0 || len > BITSTORE_MAX_IMAGE) {
+        return HAL_ERROR;
+    }
+
+    HAL_FLASH_Unlock();
+
+    erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+    erase.Banks = FLASH_BANK_2;
+    erase.Sector = slot * BITSTORE_SLOT_SECTORS;
+    erase.NbSectors = BITSTORE_SLOT_SECTORS;
+    erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+    ret = HAL_FLASHEx_Erase(&erase, &sector_error);
+
+    // Image first, slot header last: an interrupted write leaves the slot empty
+    for (uint32_t off = 0; ret == HAL_OK && off < len; off += sizeof(word)) {
+        uint32_t n = (len - off < sizeof(word)) ? len - off : sizeof(word);
+        memset(word, 0xFF, sizeof(word));
+        memcpy(word, &image[off], n);
+        ret = HAL_FLASH_Program(FLASH_TYPEPROGRAM_FLASHWORD, addr + BITSTORE_HDR_SIZE + off, (uint32_t)word);
+    }
+    if (ret == HAL_OK) {
+        memset(word, 0xFF, sizeof(word));
+        memcpy(&word[0], BITSTORE_SLOT_MAGIC, 4);
+        word[1] = len;
+        word[2] = util_crc16(image, len);
+        ret = HAL_FLASH_Program(FLASH_TYPEPROGRAM_FLASHWORD, addr, (uint32_t)word);
+    }
+
+    HAL_FLASH_Lock();
+
+    bitstore_index_slot(slot);
+    bitstore_rebuild_hash();
+    return ret;
+}
@@ -0,0 +1,507 @@
+/*
+ * console.c
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "console.h"
+#include "logging.h"
+#include "lwrb.h"
+#include "bitstore.h"
+#include "crosslink.h"
+#include "utils.h"
+#include "crc.h"
+#include "ICM20948.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+
+extern DMA_HandleTypeDef hdma_usart3_rx;
+
+/* DMA writes rx_dma round and round; rx_dma_pos is how far it has been copied out */
+static uint8_t rx_dma[CONSOLE_DMA_SIZE];
+static size_t rx_dma_pos;
+
+static lwrb_t console_rx;
+static uint8_t console_rx_data[CONSOLE_RX_SIZE];
+
+static char console_line[CONSOLE_LINE_MAX + 1];
+static size_t console_line_len;
+static bool console_line_overlong;
+
+static console_stats_t console_stats;
+static bool console_ready = false;
+
+typedef struct {
+    const char *name;
+    const char *help;
+    void (*handler)(int argc, char **argv);
+} console_cmd_t;
+
+static void cmd_help(int argc, char **argv);
+static void cmd_logstat(int argc, char **argv);
+static void cmd_rxstat(int argc, char **argv);
+static void cmd_slots(int argc, char **argv);
+static void cmd_fpga(int argc, char **argv);
+static void cmd_store(int argc, char **argv);
+static void cmd_crcbench(int argc, char **argv);
+static void cmd_verify(int argc, char **argv);
+static void cmd_imu(int argc, char **argv);
+
+static const console_cmd_t console_cmds[] = {
+    { "help",    "list commands",                     cmd_help },
+    { "logstat", "logging ring and sink statistics",  cmd_logstat },
+    { "rxstat",  "console receive statistics",        cmd_rxstat },
+    { "slots",   "list stored bitstreams",            cmd_slots },
+    { "fpga",    "fpga <slot|name|0xCRC>: configure from a slot", cmd_fpga },
+    { "store",   "store <slot> <addr> <len>: write an image in memory into a slot", cmd_store },
+    { "crcbench", "time the CRC16 implementations",   cmd_crcbench },
+    { "verify",  "verify <slot|name|0xCRC>: check a slot image by MDMA CRC", cmd_verify },
+    { "imu",     "imu [drdy|fifo <frames>|off]: IMU sampling mode and statistics", cmd_imu },
+};
+
+static HAL_StatusTypeDef console_rx_start(void) {
+    rx_dma_pos = 0;
+    return HAL_UARTEx_ReceiveToIdle_DMA(&DEBUG_UART, rx_dma, sizeof(rx_dma));
+}
+
+HAL_StatusTypeDef console_init(void) {
+    lwrb_init(&console_rx, console_rx_data, sizeof(console_rx_data));
+
+    /* CubeMX sets up the RX stream in normal mode; receive continuously instead */
+    hdma_usart3_rx.Init.Mode = DMA_CIRCULAR;
+    if (HAL_DMA_Init(&hdma_usart3_rx) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    console_ready = true;
+    return console_rx_start();
+}
+
+/*
+ * Called on IDLE and on the DMA half/full transfer events with the DMA
+ * write position in rx_dma; copy out everything since the last event.
+ */
+void console_UART_RxEventCallback(UART_HandleTypeDef *huart, uint16_t size) {
+    size_t pos = size;
+    size_t len, n, src, part;
+    lwrb_span_t span;
+
+    UNUSED(huart);
+    if (pos == rx_dma_pos) {
+        return;
+    }
+    len = (pos > rx_dma_pos) ? (pos - rx_dma_pos) : (sizeof(rx_dma) - rx_dma_pos + pos);
+
+    /* Copy straight into the ring; either side may wrap, so go piece by piece */
+    n = lwrb_reserve(&console_rx, len, &span);
+    src = rx_dma_pos;
+    for (int i = 0; i < 2; i++) {
+        for (size_t done = 0; done < span.len[i]; done += part) {
+            part = span.len[i] - done;
+            if (part > sizeof(rx_dma) - src) {
+                part = sizeof(rx_dma) - src;
+            }
+            memcpy(&span.data[i][done], &rx_dma[src], part);
+            src = (src + part) % sizeof(rx_dma);
+        }
+    }
+    lwrb_commit(&console_rx, n);
+
+    console_stats.received += len;
+    console_stats.dropped += len - n;
+    rx_dma_pos = (pos == sizeof(rx_dma)) ? 0 : pos;
+}
+
+void console_UART_ErrorCallback(UART_HandleTypeDef *huart) {
+    /* An overrun or framing error stops the reception; start over */
+    console_stats.errors++;
+    if (console_ready && huart->RxState == HAL_UART_STATE_READY) {
+        console_rx_start();
+    }
+}
+
+void console_get_stats(console_stats_t *stats) {
+    memcpy(stats, &console_stats, sizeof(*stats));
+}
+
+static void console_dispatch(char *line) {
+    char *argv[CONSOLE_MAX_ARGS];
+    int argc = 0;
+    char *tok = strtok(line, " \t");
+
+    while (tok != NULL && argc < (int)CONSOLE_MAX_ARGS) {
+        argv[argc++] = tok;
+        tok = strtok(NULL, " \t");
+    }
+    if (argc == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < sizeof(console_cmds) / sizeof(console_cmds[0]); i++) {
+        if (strcmp(argv[0], console_cmds[i].name) == 0) {
+            console_cmds[i].handler(argc, argv);
+            return;
+        }
+    }
+    printf("unknown command '%s', try help\r\n", argv[0]);
+}
+
+/* Run every complete line waiting in the console ring */
+void console_process(void) {
+    uint8_t c;
+
+    if (!console_ready) {
+        return;
+    }
+    while (lwrb_read(&console_rx, &c, 1) == 1) {
+        if (c == '\r' || c == '\n') {
+            if (console_line_overlong) {
+                console_stats.overlong++;
+                printf("line too long\r\n");
+            } else if (console_line_len > 0) {
+                console_line[console_line_len] = '\0';
+                console_dispatch(console_line);
+            }
+            console_line_len = 0;
+            console_line_overlong = false;
+        } else if (c == '\b' || c == 0x7F) {
+            if (console_line_len > 0) {
+                console_line_len--;
+            }
+        } else if (console_line_len < CONSOLE_LINE_MAX) {
+            console_line[console_line_len++] = (char)c;
+        } else {
+            console_line_overlong = true;
+        }
+    }
+}
+
+/*
+ * stdin reads come straight from the console ring, so a command handler
+ * can prompt with getchar()/scanf(). Waits for at least one byte, sleeping
+ * between receive events.
+ */
+int _read(int file, char *ptr, int len) {
+    size_t n;
+
+    UNUSED(file);
+    if (!console_ready) {
+        errno = EIO;
+        return -1;
+    }
+    if (len <= 0) {
+        return 0;
+    }
+    while ((n = lwrb_read(&console_rx, ptr, (size_t)len)) == 0) {
+        __WFI();
+    }
+    return (int)n;
+}
+
+static void cmd_help(int argc, char **argv) {
+    UNUSED(argc);
+    UNUSED(argv);
+    for (size_t i = 0; i < sizeof(console_cmds) / sizeof(console_cmds[0]); i++) {
+        printf("  %-8s %s\r\n", console_cmds[i].name, console_cmds[i].help);
+    }
+}
+
+static void cmd_logstat(int argc, char **argv) {
+    UNUSED(argc);
+    UNUSED(argv);
+    logging_print_stats();
+}
+
+static void cmd_rxstat(int argc, char **argv) {
+    console_stats_t stats;
+
+    UNUSED(argc);
+    UNUSED(argv);
+    console_get_stats(&stats);
+    printf("console: %lu bytes received, %lu dropped, %lu errors, %lu overlong lines\r\n",
+           (unsigned long)stats.received, (unsigned long)stats.dropped,
+           (unsigned long)stats.errors, (unsigned long)stats.overlong);
+}
+
+static void cmd_slots(int argc, char **argv) {
+    UNUSED(argc);
+    UNUSED(argv);
+    for (uint32_t slot = 0; slot < BITSTORE_NUM_SLOTS; slot++) {
+        const bitstore_entry_t *e = bitstore_entry(slot);
+        if (e != NULL) {
+            printf("  %lu: %s %s %s, CRC 0x%04X, %lu bytes%s\r\n", (unsigned long)slot, e->name, e->part,
+                   e->date, e->crc, (unsigned long)e->image_len, e->compressed ? " (lz4)" : "");
+        } else {
+            printf("  %lu: empty\r\n", (unsigned long)slot);
+        }
+    }
+}
+
+/* Slot number, Lattice bitstream CRC ("0x" prefix) or design name; -1 if none matches */
+static int console_find_slot(const char *arg) {
+    unsigned long v;
+    char *end;
+
+    if (arg[0] == '0' && (arg[1] == 'x' || arg[1] == 'X')) {
+        v = strtoul(arg, &end, 16);
+        return (*end == '\0' && v <= 0xFFFFUL) ? bitstore_find_by_crc((uint16_t)v) : -1;
+    }
+    v = strtoul(arg, &end, 10);
+    if (end != arg && *end == '\0') {
+        return (bitstore_entry((uint32_t)v) != NULL) ? (int)v : -1;
+    }
+    return bitstore_find_by_name(arg);
+}
+
+static void cmd_fpga(int argc, char **argv) {
+    fpga_source_t *src;
+    int slot;
+
+    if (argc < 2) {
+        printf("usage: fpga <slot|name|0xCRC>\r\n");
+        return;
+    }
+    if (fpga_configure_busy()) {
+        printf("fpga: configuration in progress\r\n");
+        return;
+    }
+    slot = console_find_slot(argv[1]);
+    src = (slot >= 0) ? bitstore_source((uint32_t)slot) : NULL;
+    if (src == NULL) {
+        printf("fpga: no stored bitstream matches %s\r\n", argv[1]);
+        return;
+    }
+    printf("fpga: configuring from slot %d (%s)\r\n", slot, bitstore_entry((uint32_t)slot)->name);
+    if (fpga_configure_start(src) != HAL_OK) {
+        printf("fpga: start failed\r\n");
+    }
+}
+
+/* True if [addr, addr + len) lies in AXI SRAM or in flash outside the given slot */
+static bool store_source_ok(uint32_t addr, uint32_t len, uint32_t slot) {
+    uint32_t slot_base = BITSTORE_BASE + slot * BITSTORE_SLOT_SIZE;
+
+    if (addr >= D1_AXISRAM_BASE && addr - D1_AXISRAM_BASE + len <= 512U * 1024U) {
+        return true;
+    }
+    if (addr >= FLASH_BANK1_BASE && addr <= FLASH_END && len <= FLASH_END - addr + 1U) {
+        return addr + len <= slot_base || addr >= slot_base + BITSTORE_SLOT_SIZE;
+    }
+    return false;
+}
+
+/*
+ * Writes an image that is already in memory, e.g. loaded into AXI SRAM by
+ * the debugger or in another slot, into a slot and re-indexes it.
+ */
+static void cmd_store(int argc, char **argv) {
+    const bitstore_entry_t *e;
+    uint32_t slot, addr, len;
+    int ret;
+
+    if (argc < 4) {
+        printf("usage: store <slot> <addr> <len>\r\n");
+        return;
+    }
+    slot = (uint32_t)strtoul(argv[1], NULL, 0);
+    addr = (uint32_t)strtoul(argv[2], NULL, 0);
+    len = (uint32_t)strtoul(argv[3], NULL, 0);
+    if (slot >= BITSTORE_NUM_SLOTS || len == 0 || len > BITSTORE_MAX_IMAGE) {
+        printf("store: slot 0..%u, length 1..%lu\r\n", BITSTORE_NUM_SLOTS - 1U, (unsigned long)BITSTORE_MAX_IMAGE);
+        return;
+    }
+    if (!store_source_ok(addr, len, slot)) {
+        printf("store: source must be in AXI SRAM or in flash outside slot %lu\r\n", (unsigned long)slot);
+        return;
+    }
+    if (fpga_configure_busy()) {
+        /* The stream may be reading the slot about to be erased */
+        printf("store: configuration in progress\r\n");
+        return;
+    }
+
+    ret = bitstore_program(slot, (const uint8_t *)(uintptr_t)addr, len);
+    if (ret != HAL_OK) {
+        printf("store: flash write failed (%d)\r\n", ret);
+        return;
+    }
+    e = bitstore_entry(slot);
+    if (e == NULL) {
+        printf("store: slot %lu written, but it holds no Lattice bitstream\r\n", (unsigned long)slot);
+        return;
+    }
+    printf("store: slot %lu: %s %s CRC 0x%04X, %lu bytes%s\r\n", (unsigned long)slot, e->name, e->part,
+           e->crc, (unsigned long)e->image_len, e->compressed ? " (lz4)" : "");
+}
+
+/* Hundredths of a ns per byte for a run of cycles over len bytes */
+static uint32_t crcbench_ns100(uint64_t cycles, uint32_t len) {
+    return (uint32_t)((cycles * 100000000000ULL) / SystemCoreClock / len);
+}
+
+/* CRC16 over the start of flash bank 1, 16 B to 160 KB, byte table vs slicing-by-8 vs the CRC unit */
+static void cmd_crcbench(int argc, char **argv) {
+    static const uint32_t sizes[] = { 16, 64, 256, 1024, 4096, 16384, 65536, 163840 };
+    const uint8_t *src = (const uint8_t *)FLASH_BANK1_BASE;
+    uint64_t t0, t_byte, t_slice, t_hw;
+    uint16_t c_byte, c_slice, c_hw;
+
+    UNUSED(argc);
+    UNUSED(argv);
+    if (fpga_configure_busy()) {
+        printf("crcbench: the CRC unit is in use by the FPGA stream\r\n");
+        return;
+    }
+
+    printf("   bytes   byte ns/B  slice ns/B     hw ns/B\r\n");
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        uint32_t len = sizes[i];
+        uint32_t ns[3];
+
+        t0 = util_cycles();
+        c_byte = util_crc16_bytewise(src, len);
+        t_byte = util_cycles() - t0;
+
+        t0 = util_cycles();
+        c_slice = util_crc16(src, len);
+        t_slice = util_cycles() - t0;
+
+        t0 = util_cycles();
+        c_hw = util_hw_crc16(src, len);
+        t_hw = util_cycles() - t0;
+
+        ns[0] = crcbench_ns100(t_byte, len);
+        ns[1] = crcbench_ns100(t_slice, len);
+        ns[2] = crcbench_ns100(t_hw, len);
+        printf("%8lu %8lu.%02lu %8lu.%02lu %8lu.%02lu%s\r\n", (unsigned long)len,
+               (unsigned long)(ns[0] / 100), (unsigned long)(ns[0] % 100),
+               (unsigned long)(ns[1] / 100), (unsigned long)(ns[1] % 100),
+               (unsigned long)(ns[2] / 100), (unsigned long)(ns[2] % 100),
+               (c_byte == c_slice && c_slice == c_hw) ? "" : "  MISMATCH");
+    }
+}
+
+/*
+ * Check a stored image with an asynchronous CRC job and compare the CPU
+ * time it took against the software CRC over the same bytes. The CRC is
+ * over the bytes as stored, so a compressed slot is checked against the
+ * container CRC in the slot header, not the raw-image CRC.
+ */
+static void cmd_verify(int argc, char **argv) {
+    const bitstore_entry_t *e;
+    crc_job_stats_t stats;
+    crc_ctx_t ctx;
+    crc_job_t job = { 0 };
+    uint64_t t0, sw_cycles;
+    uint16_t crc, sw_crc;
+    uint32_t slot;
+    int found;
+
+    if (argc < 2) {
+        printf("usage: verify <slot|name|0xCRC>\r\n");
+        return;
+    }
+    found = console_find_slot(argv[1]);
+    if (found < 0) {
+        printf("verify: no stored bitstream matches %s\r\n", argv[1]);
+        return;
+    }
+    slot = (uint32_t)found;
+    e = bitstore_entry(slot);
+
+    crc_init(&ctx, &crc16_ccitt_false, CRC_ENGINE_HW);
+    job.ctx = &ctx;
+    job.data = e->image;
+    job.len = e->image_len;
+    if (crc_job_submit(&job) != HAL_OK) {
+        printf("verify: submit failed\r\n");
+        return;
+    }
+    while (job.status == HAL_BUSY) {
+        __WFI();
+    }
+    crc = (uint16_t)crc_final(&ctx);
+
+    t0 = util_cycles();
+    sw_crc = util_crc16(e->image, e->image_len);
+    sw_cycles = util_cycles() - t0;
+
+    printf("slot %lu: crc 0x%04X %s, %lu bytes\r\n", (unsigned long)slot, crc,
+           (job.status == HAL_OK && crc == e->slot_crc) ? "OK" : "BAD", (unsigned long)e->image_len);
+    printf("  mdma %lu cycles elapsed, %lu cpu; software %lu cpu, %lu saved\r\n",
+           (unsigned long)job.elapsed_cycles, (unsigned long)job.cpu_cycles, (unsigned long)sw_cycles,
+           (unsigned long)((sw_cycles > job.cpu_cycles) ? (sw_cycles - job.cpu_cycles) : 0));
+    if (sw_crc != crc) {
+        printf("  software crc 0x%04X differs\r\n", sw_crc);
+    }
+
+    crc_job_get_stats(&stats);
+    printf("  all jobs: %lu, %lu bytes, %lu cpu cycles\r\n", (unsigned long)stats.jobs,
+           (unsigned long)stats.bytes, (unsigned long)stats.cpu_cycles);
+}
+
+static void imu_report(const char *mode, uint8_t status) {
+    if (status == HAL_BUSY) {
+        printf("imu: %s: I2C1 is held by FPGA configuration, try again\r\n", mode);
+    } else if (status != HAL_OK) {
+        printf("imu: %s: register setup failed (status %u)\r\n", mode, status);
+    }
+}
+
+/*
+ * Switch the IMU acquisition mode, or drain the data-ready sample queue and
+ * report the rates and the newest sample.
+ */
+static void cmd_imu(int argc, char **argv) {
+    ICM_SamplingStats stats;
+    ICM_BusStats bus;
+    ICM_Sample sample, last = { 0 };
+    uint32_t drained = 0;
+
+    if (argc >= 2) {
+        if (strcmp(argv[1], "drdy") == 0) {
+            imu_report("drdy", ICM_StartSampling());
+        } else if (strcmp(argv[1], "fifo") == 0 && argc >= 3) {
+            unsigned long watermark = strtoul(argv[2], NULL, 0);
+            if (watermark == 0 || watermark >= ICM_FIFO_MAX_FRAMES) {
+                printf("imu: watermark must be 1..%u frames\r\n", (unsigned)(ICM_FIFO_MAX_FRAMES - 1));
+            } else {
+                imu_report("fifo", ICM_StartFifo((uint16_t)watermark));
+            }
+        } else if (strcmp(argv[1], "off") == 0) {
+            ICM_StopSampling();
+        } else {
+            printf("usage: imu [drdy|fifo <frames>|off]\r\n");
+        }
+        return;
+    }
+
+    while (ICM_GetSample(&sample)) {
+        last = sample;
+        drained++;
+    }
+
+    ICM_GetSamplingStats(&stats);
+    printf("imu: %lu samples, %lu bus busy, %lu overruns, %lu queue full, %lu errors\r\n",
+           (unsigned long)stats.samples, (unsigned long)stats.bus_busy, (unsigned long)stats.overruns,
+           (unsigned long)stats.queue_full, (unsigned long)stats.errors);
+    ICM_GetBusStats(&bus);
+    printf("  regs: %lu transactions, %lu bank selects / %lu writes skipped, %lu reads cached\r\n",
+           (unsigned long)bus.transactions, (unsigned long)bus.bank_skipped,
+           (unsigned long)bus.writes_skipped, (unsigned long)bus.reads_cached);
+    if (stats.batches != 0) {
+        printf("  fifo: %lu batches, %lu frames/batch, %lu overflows\r\n", (unsigned long)stats.batches,
+               (unsigned long)(stats.samples / stats.batches), (unsigned long)stats.fifo_overflows);
+    }
+    if (drained == 0) {
+        return;
+    }
+    printf("  %lu queued, newest at %lu us\r\n", (unsigned long)drained,
+           (unsigned long)(last.timestamp / (SystemCoreClock / 1000000U)));
+    printf("  accel %d %d %d  gyro %d %d %d  temp %d  mag %d %d %d st2 0x%02X\r\n",
+           last.accel.x, last.accel.y, last.accel.z, last.gyro.x, last.gyro.y, last.gyro.z,
+           last.temp, last.mag.x, last.mag.y, last.mag.z, last.mag_status);
+}
@@ -0,0 +1,329 @@
+/*
+ * crc.c
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "crc.h"
+#include "utils.h"
+#include <string.h>
+
+extern MDMA_HandleTypeDef hmdma_crc;
+
+const crc_params_t crc16_ccitt_false = {
+    .name = "CRC-16/CCITT-FALSE", .width = 16, .poly = 0x1021, .init = 0xFFFF,
+    .refin = false, .refout = false, .xorout = 0x0000,
+};
+
+const crc_params_t crc16_modbus = {
+    .name = "CRC-16/MODBUS", .width = 16, .poly = 0x8005, .init = 0xFFFF,
+    .refin = true, .refout = true, .xorout = 0x0000,
+};
+
+const crc_params_t crc32_iso_hdlc = {
+    .name = "CRC-32/ISO-HDLC", .width = 32, .poly = 0x04C11DB7, .init = 0xFFFFFFFF,
+    .refin = true, .refout = true, .xorout = 0xFFFFFFFF,
+};
+
+/* Context holding the CRC unit, and the parameters it is configured for */
+static crc_ctx_t *crc_hw_owner;
+static const crc_params_t *crc_hw_params;
+
+/* Job queue; the head job is the one on the MDMA once crc_job_running is set */
+static crc_job_t *crc_job_head;
+static crc_job_t *crc_job_tail;
+static volatile bool crc_job_running;
+static bool crc_job_cb_registered;
+static crc_job_stats_t crc_job_stats;
+
+static void crc_job_kick(void);
+
+static uint32_t crc_mask(const crc_params_t *p) {
+    return (p->width >= 32) ? 0xFFFFFFFFU : ((1UL << p->width) - 1);
+}
+
+static uint32_t crc_reflect(uint32_t v, uint8_t width) {
+    return __RBIT(v) >> (32 - width);
+}
+
+/*
+ * Bitwise MSB-first update; reflected input is handled by reversing each
+ * byte, the same thing the CRC unit's input inversion does. CCITT-FALSE
+ * takes the slicing-by-8 path in utils.c.
+ */
+static uint32_t crc_sw_update(const crc_params_t *p, uint32_t reg, const uint8_t *data, size_t len) {
+    uint32_t top = 1UL << (p->width - 1);
+    uint32_t mask = crc_mask(p);
+
+    if (p->width == 16 && p->poly == 0x1021 && !p->refin) {
+        return util_crc16_update((uint16_t)reg, data, (uint32_t)len);
+    }
+
+    while (len-- > 0) {
+        uint8_t b = *data++;
+        reg ^= (uint32_t)(p->refin ? crc_reflect(b, 8) : b) << (p->width - 8);
+        for (int i = 0; i < 8; i++) {
+            reg = (reg & top) ? ((reg << 1) ^ p->poly) : (reg << 1);
+        }
+        reg &= mask;
+    }
+    return reg;
+}
+
+bool crc_hw_claim(crc_ctx_t *ctx) {
+    const crc_params_t *p = ctx->params;
+    uint32_t primask = __get_PRIMASK();
+    bool ok;
+
+    __disable_irq();
+    ok = (crc_hw_owner == NULL || crc_hw_owner == ctx);
+    if (ok) {
+        crc_hw_owner = ctx;
+    }
+    __set_PRIMASK(primask);
+    if (!ok) {
+        return false;
+    }
+
+    if (crc_hw_params != p) {
+        hcrc.Init.DefaultPolynomialUse = DEFAULT_POLYNOMIAL_DISABLE;
+        hcrc.Init.GeneratingPolynomial = p->poly;
+        hcrc.Init.CRCLength = (p->width == 8) ? CRC_POLYLENGTH_8B :
+                              (p->width == 16) ? CRC_POLYLENGTH_16B : CRC_POLYLENGTH_32B;
+        hcrc.Init.DefaultInitValueUse = DEFAULT_INIT_VALUE_DISABLE;
+        hcrc.Init.InitValue = ctx->reg;
+        hcrc.Init.InputDataInversionMode = p->refin ? CRC_INPUTDATA_INVERSION_BYTE : CRC_INPUTDATA_INVERSION_NONE;
+        hcrc.Init.OutputDataInversionMode = CRC_OUTPUTDATA_INVERSION_DISABLE;
+        hcrc.InputDataFormat = CRC_INPUTDATA_FORMAT_BYTES;
+        if (HAL_CRC_Init(&hcrc) != HAL_OK) {
+            crc_hw_params = NULL;
+            crc_hw_owner = NULL;
+            return false;
+        }
+        crc_hw_params = p;
+    }
+
+    /* Resume from the context's running value */
+    WRITE_REG(hcrc.Instance->INIT, ctx->reg);
+    __HAL_CRC_DR_RESET(&hcrc);
+    return true;
+}
+
+void crc_hw_release(crc_ctx_t *ctx) {
+    if (crc_hw_owner != ctx) {
+        return;
+    }
+    ctx->reg = hcrc.Instance->DR & crc_mask(ctx->params);
+    crc_hw_owner = NULL;
+
+    /* A job may have been waiting for the unit */
+    crc_job_kick();
+}
+
+void crc_init(crc_ctx_t *ctx, const crc_params_t *params, crc_engine_t engine) {
+    ctx->params = params;
+    ctx->engine = engine;
+    ctx->reg = params->init & crc_mask(params);
+}
+
+void crc_update(crc_ctx_t *ctx, const void *data, size_t len) {
+    bool held = (crc_hw_owner == ctx);
+
+    if (len == 0) {
+        return;
+    }
+    if (ctx->engine == CRC_ENGINE_HW && (held || crc_hw_claim(ctx))) {
+        HAL_CRC_Accumulate(&hcrc, (uint32_t *)data, (uint32_t)len);
+        if (!held) {
+            crc_hw_release(ctx);
+        }
+        return;
+    }
+    ctx->reg = crc_sw_update(ctx->params, ctx->reg, data, len);
+}
+
+uint32_t crc_final(const crc_ctx_t *ctx) {
+    const crc_params_t *p = ctx->params;
+    uint32_t reg = ctx->reg;
+
+    if (p->refout) {
+        reg = crc_reflect(reg, p->width);
+    }
+    return (reg ^ p->xorout) & crc_mask(p);
+}
+
+uint32_t crc_compute(const crc_params_t *params, crc_engine_t engine, const void *data, size_t len) {
+    crc_ctx_t ctx;
+
+    crc_init(&ctx, params, engine);
+    crc_update(&ctx, data, len);
+    return crc_final(&ctx);
+}
+
+/* Queue bookkeeping below runs with interrupts masked; it is short and never waits */
+static void crc_job_dequeue(crc_job_t *job) {
+    crc_job_t **pp = &crc_job_head;
+    crc_job_t *prev = NULL;
+
+    while (*pp != NULL && *pp != job) {
+        prev = *pp;
+        pp = &(*pp)->next;
+    }
+    if (*pp == job) {
+        *pp = job->next;
+        if (crc_job_tail == job) {
+            crc_job_tail = prev;
+        }
+        job->next = NULL;
+    }
+}
+
+static void crc_job_finish(crc_job_t *job, int status, uint64_t t0) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    crc_job_dequeue(job);
+    crc_job_running = false;
+    __set_PRIMASK(primask);
+
+    job->status = status;
+    job->elapsed_cycles = util_cycles() - job->submitted;
+
+    /* Reads the result back and starts the next job, if any */
+    crc_hw_release(job->ctx);
+
+    job->cpu_cycles += (uint32_t)(util_cycles() - t0);
+    crc_job_stats.jobs++;
+    crc_job_stats.bytes += job->len;
+    crc_job_stats.cpu_cycles += job->cpu_cycles;
+    crc_job_stats.elapsed_cycles += job->elapsed_cycles;
+    if (job->cb != NULL) {
+        job->cb(job, crc_final(job->ctx));
+    }
+}
+
+/* Next MDMA block of the running job */
+static int crc_job_block(crc_job_t *job) {
+    size_t len = job->len - job->pos;
+
+    if (len > CRC_JOB_MAX_BLOCK) {
+        len = CRC_JOB_MAX_BLOCK;
+    }
+    return HAL_MDMA_Start_IT(&hmdma_crc, (uint32_t)&job->data[job->pos],
+                             (uint32_t)&hcrc.Instance->DR, (uint32_t)len, 1);
+}
+
+static void crc_job_mdma_cplt(MDMA_HandleTypeDef *hmdma) {
+    crc_job_t *job = crc_job_head;
+    uint64_t t0 = util_cycles();
+    size_t len;
+
+    UNUSED(hmdma);
+    if (!crc_job_running || job == NULL) {
+        return;
+    }
+    len = job->len - job->pos;
+    job->pos += (len > CRC_JOB_MAX_BLOCK) ? CRC_JOB_MAX_BLOCK : len;
+    if (job->pos < job->len) {
+        if (crc_job_block(job) == HAL_OK) {
+            job->cpu_cycles += (uint32_t)(util_cycles() - t0);
+            return;
+        }
+        crc_job_finish(job, HAL_ERROR, t0);
+        return;
+    }
+    crc_job_finish(job, HAL_OK, t0);
+}
+
+static void crc_job_mdma_error(MDMA_HandleTypeDef *hmdma) {
+    UNUSED(hmdma);
+    if (crc_job_running && crc_job_head != NULL) {
+        crc_job_finish(crc_job_head, HAL_ERROR, util_cycles());
+    }
+}
+
+/* Start the head job if the MDMA is idle and the CRC unit can be had */
+static void crc_job_kick(void) {
+    uint64_t t0 = util_cycles();
+    uint32_t primask = __get_PRIMASK();
+    crc_job_t *job;
+
+    __disable_irq();
+    job = crc_job_head;
+    if (crc_job_running || job == NULL || !crc_hw_claim(job->ctx)) {
+        /* Retried from crc_hw_release once the unit is free */
+        __set_PRIMASK(primask);
+        return;
+    }
+    crc_job_running = true;
+    __set_PRIMASK(primask);
+
+    if (!crc_job_cb_registered) {
+        HAL_MDMA_RegisterCallback(&hmdma_crc, HAL_MDMA_XFER_CPLT_CB_ID, crc_job_mdma_cplt);
+        HAL_MDMA_RegisterCallback(&hmdma_crc, HAL_MDMA_XFER_ERROR_CB_ID, crc_job_mdma_error);
+        crc_job_cb_registered = true;
+    }
+    if (crc_job_block(job) != HAL_OK) {
+        crc_job_finish(job, HAL_ERROR, t0);
+        return;
+    }
+    job->cpu_cycles += (uint32_t)(util_cycles() - t0);
+}
+
+/*
+ * Queue a job; it starts right away when nothing is ahead of it. The
+ * callback may submit the next job. Returns HAL_ERROR for a job that is
+ * empty or already queued.
+ */
+int crc_job_submit(crc_job_t *job) {
+    uint32_t primask;
+
+    if (job == NULL || job->ctx == NULL || job->len == 0 || job->status == HAL_BUSY) {
+        return HAL_ERROR;
+    }
+    job->pos = 0;
+    job->next = NULL;
+    job->cpu_cycles = 0;
+    job->elapsed_cycles = 0;
+    job->status = HAL_BUSY;
+    job->submitted = util_cycles();
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if (crc_job_tail != NULL) {
+        crc_job_tail->next = job;
+    } else {
+        crc_job_head = job;
+    }
+    crc_job_tail = job;
+    __set_PRIMASK(primask);
+
+    crc_job_kick();
+    return HAL_OK;
+}
+
+/* Remove a job that has not completed; its callback does not run */
+void crc_job_cancel(crc_job_t *job) {
+    uint32_t primask = __get_PRIMASK();
+    bool running;
+
+    __disable_irq();
+    if (job->status != HAL_BUSY) {
+        __set_PRIMASK(primask);
+        return;
+    }
+    running = crc_job_running && crc_job_head == job;
+    crc_job_dequeue(job);
+    crc_job_running = crc_job_running && !running;
+    job->status = HAL_ERROR;
+    __set_PRIMASK(primask);
+
+    if (running) {
+        HAL_MDMA_Abort(&hmdma_crc);
+        crc_hw_release(job->ctx);
+    }
+}
+
+void crc_job_get_stats(crc_job_stats_t *stats) {
+    memcpy(stats, &crc_job_stats, sizeof(*stats));
+}
@@ -1,7 +1,11 @@
 
 #include "crosslink.h"
 #include "main.h"
-#include "bitstream.h"
+#include "bitstream_lz4.h"
+#include "fpga_source.h"
+#include "logging.h"
+#include "crc.h"
+#include "ICM20948.h"
 #include <string.h>
 #include <stdio.h>
 
@@ -10,12 +14,10 @@
 #define FPGA_RESET_GPIO_Port GPIOC
 #define FPGA_RESET_Pin GPIO_PIN_9
 
-extern uint8_t bitstream_buffer[];  // Place in linker script or define in code
-
-
 volatile uint8_t txComplete = 0;
 volatile uint8_t rxComplete = 0;
 volatile uint8_t i2cError = 0;
+volatile uint32_t i2c1_irq_count = 0;
 
 uint8_t write_buf[4];
 uint8_t read_buf[4];
@@ -25,11 +27,41 @@ void delay_ms(uint32_t ms) {
 }
 
 void print_hex_buf(const char *label, uint8_t *buf, size_t len) {
+#if LOGGING_BINARY
+    logging_bin_hex(label, buf, len);
+#else
     if (label) printf("%s: ", label);
     for (size_t i = 0; i < len; i++) {
         printf("%02X ", buf[i]);
     }
     printf("\r\n");
+#endif
+}
+
+static volatile i2c_bus_owner_t i2c_bus_current = I2C_BUS_FREE;
+
+/* Non-blocking; callable from interrupt context */
+bool i2c_bus_claim(i2c_bus_owner_t owner) {
+    uint32_t primask = __get_PRIMASK();
+    bool ok;
+
+    __disable_irq();
+    ok = (i2c_bus_current == I2C_BUS_FREE || i2c_bus_current == owner);
+    if (ok) {
+        i2c_bus_current = owner;
+    }
+    __set_PRIMASK(primask);
+    return ok;
+}
+
+void i2c_bus_release(i2c_bus_owner_t owner) {
+    if (i2c_bus_current == owner) {
+        i2c_bus_current = I2C_BUS_FREE;
+    }
+}
+
+i2c_bus_owner_t i2c_bus_owner(void) {
+    return i2c_bus_current;
 }
 
 int i2c_write_bytes(uint8_t *data, uint16_t length) {
@@ -71,139 +103,695 @@ int i2c_write_and_read(uint8_t *wbuf, uint16_t wlen, uint8_t *rbuf, uint16_t rle
     return HAL_OK;
 }
 
-int i2c_write_long(uint8_t *cmd, int cmd_len, uint8_t *data, size_t data_len) {
-	HAL_StatusTypeDef ret;
-    size_t offset = 0;
+/*
+ * DMA sequential transmit engine.
+ *
+ * A scatter list is sent as one I2C write, chunk by chunk, with
+ * HAL_I2C_Master_Seq_Transmit_DMA. Each chunk completion (TxCplt callback)
+ * queues the next one from interrupt context, so the CPU only sees one DMA
+ * interrupt per 255 bytes (NBYTES reload) instead of one per byte. The
+ * caller is notified through its completion callback once the last frame
+ * has gone out or an error aborted the transfer.
+ *
+ * A write may also be split into several parts (I2C_SEQ_CONTINUE /
+ * I2C_SEQ_MORE) when the payload is produced while earlier parts are
+ * already on the wire; the bus is held between parts.
+ */
+static struct {
+    const i2c_segment_t *segs;
+    int nsegs;
+    int seg;
+    size_t offset;
+    size_t sent;
+    size_t total;
+    uint32_t flags;
+    i2c_seq_cplt_fn cplt_fn;
+    void *arg;
+    volatile bool active;
+} i2c_seq;
+
+static volatile bool i2c_seq_done;
+static volatile int i2c_seq_status;
+
+static HAL_StatusTypeDef i2c_seq_next_chunk(void) {
+    const i2c_segment_t *seg;
+    size_t current_chunk_size;
     uint32_t frame_flag;
-    size_t total_len = data_len+cmd_len;
-    int num_chunks = (total_len + BITSTREAM_CHUNK_SIZE - 1) / BITSTREAM_CHUNK_SIZE;  // Calculate number of chunks
-    uint8_t *pData;
-	uint16_t datalen;
+    bool first, last;
 
-	memset(bitstream_buffer, 0, MAX_BITSTREAM_SIZE);
-    memcpy(bitstream_buffer, cmd, cmd_len);
-    memcpy(bitstream_buffer + cmd_len, data, data_len);
+    // Skip exhausted (or empty) segments
+    while (i2c_seq.offset >= i2c_seq.segs[i2c_seq.seg].len) {
+        i2c_seq.seg++;
+        i2c_seq.offset = 0;
+    }
+    seg = &i2c_seq.segs[i2c_seq.seg];
+
+    current_chunk_size = (seg->len - i2c_seq.offset > BITSTREAM_CHUNK_SIZE)
+                         ? BITSTREAM_CHUNK_SIZE
+                         : (seg->len - i2c_seq.offset);
+    first = (i2c_seq.sent == 0) && !(i2c_seq.flags & I2C_SEQ_CONTINUE);
+    last = (i2c_seq.sent + current_chunk_size == i2c_seq.total) && !(i2c_seq.flags & I2C_SEQ_MORE);
+
+    // Determine frame flags; consecutive frames in the same direction are
+    // continued by the HAL without a repeated START.
+    if (first && last) {
+        frame_flag = I2C_FIRST_AND_LAST_FRAME;
+    } else if (first) {
+        frame_flag = I2C_FIRST_AND_NEXT_FRAME;
+    } else if (last) {
+        frame_flag = I2C_LAST_FRAME;
+    } else {
+        frame_flag = I2C_NEXT_FRAME;
+    }
 
+    const uint8_t *pData = &seg->data[i2c_seq.offset];
+    i2c_seq.offset += current_chunk_size;
+    i2c_seq.sent += current_chunk_size;
 
-    for (int i = 0; i < num_chunks; i++) {
-        size_t current_chunk_size = (total_len - offset > BITSTREAM_CHUNK_SIZE)
-                                     ? BITSTREAM_CHUNK_SIZE
-                                     : (total_len - offset);
+    return HAL_I2C_Master_Seq_Transmit_DMA(&hi2c1, I2C_SLAVE_ADDR << 1, (uint8_t*)pData,
+                                           (uint16_t)current_chunk_size, frame_flag);
+}
 
-        // Determine frame flags
-        if (i == 0 && num_chunks == 1) {
-            frame_flag = I2C_FIRST_AND_LAST_FRAME;
-        } else if (i == 0) {
-            frame_flag = I2C_FIRST_AND_NEXT_FRAME;
-        } else if (i == num_chunks - 1) {
-            frame_flag = I2C_LAST_FRAME;
-        } else {
-            frame_flag = I2C_NEXT_FRAME;
-        }
+static void i2c_seq_finish(int status) {
+    i2c_seq_cplt_fn fn = i2c_seq.cplt_fn;
+    void *arg = i2c_seq.arg;
 
-        // Check if the I2C peripheral is ready
-        while (HAL_I2C_GetState(&hi2c1) != HAL_I2C_STATE_READY) {
-            //if(verbose_on) printf("I2C busy, waiting...\r\n");
-            HAL_Delay(1);  // Add a small delay to avoid busy looping
+    i2c_seq.active = false;
+    if (fn != NULL) {
+        fn(status, arg);
+    }
+}
+
+int i2c_seq_write_part(const i2c_segment_t *segs, int nsegs, uint32_t flags,
+                       i2c_seq_cplt_fn cplt_fn, void *arg) {
+    HAL_StatusTypeDef ret;
+    size_t total_len = 0;
+
+    if (i2c_seq.active || HAL_I2C_GetState(&hi2c1) != HAL_I2C_STATE_READY) {
+        return HAL_BUSY;
+    }
+
+    for (int s = 0; s < nsegs; s++) {
+        total_len += segs[s].len;
+    }
+    if (total_len == 0) {
+        if (cplt_fn != NULL) {
+            cplt_fn(HAL_OK, arg);
         }
+        return HAL_OK;
+    }
 
-        pData = (uint8_t*)&bitstream_buffer[offset];
-        datalen = (uint16_t)current_chunk_size;
+    i2c_seq.segs = segs;
+    i2c_seq.nsegs = nsegs;
+    i2c_seq.seg = 0;
+    i2c_seq.offset = 0;
+    i2c_seq.sent = 0;
+    i2c_seq.total = total_len;
+    i2c_seq.flags = flags;
+    i2c_seq.cplt_fn = cplt_fn;
+    i2c_seq.arg = arg;
+    i2c_seq.active = true;
+
+    ret = i2c_seq_next_chunk();
+    if (ret != HAL_OK) {
+        printf("++++> i2c_seq_write_part HAL TX HAL_StatusTypeDef: 0%04X I2C_ERROR: 0%04lX\r\n", ret, (unsigned long)hi2c1.ErrorCode);
+        i2c_seq.active = false;
+    }
+    return ret;
+}
 
-        // Reset completion flags
-        txComplete = 0;
-        i2cError = 0;
+int i2c_seq_write_start(const i2c_segment_t *segs, int nsegs, i2c_seq_cplt_fn cplt_fn, void *arg) {
+    return i2c_seq_write_part(segs, nsegs, 0, cplt_fn, arg);
+}
 
-        // Transmit the current chunk
-        ret = HAL_I2C_Master_Seq_Transmit_IT(&hi2c1, I2C_SLAVE_ADDR << 1, pData, datalen, frame_flag);
-        if (ret != HAL_OK) {
-        	printf("++++> i2c_write_long HAL TX HAL_StatusTypeDef: 0%04X I2C_ERROR: 0%04lX\r\n", ret, hi2c1.ErrorCode);
-            return ret; // Return if any transmission fails
+bool i2c_seq_busy(void) {
+    return i2c_seq.active;
+}
+
+static void i2c_seq_blocking_cplt(int status, void *arg) {
+    UNUSED(arg);
+    i2c_seq_status = status;
+    i2c_seq_done = true;
+}
+
+static int i2c_seq_wait(void) {
+    // Sleep until the DMA engine reports completion
+    while (!i2c_seq_done) {
+        __WFI();
+    }
+    return i2c_seq_status;
+}
+
+int i2c_write_segments(const i2c_segment_t *segs, int nsegs) {
+    int ret;
+
+    i2c_seq_done = false;
+    ret = i2c_seq_write_start(segs, nsegs, i2c_seq_blocking_cplt, NULL);
+    if (ret != HAL_OK) {
+        return ret;
+    }
+
+    return i2c_seq_wait();
+}
+
+/*
+ * Bitstream CRC verification. Every chunk is pushed through the CRC unit by
+ * MDMA as soon as it is acquired, i.e. while the previous chunk is still on
+ * the I2C bus, so checking the image costs no extra wall time. The final
+ * chunk is only sent once the CRC over the whole image matches the value
+ * the source advertises; on mismatch the transfer is cut short and the
+ * device never sees a complete (corrupt) bitstream.
+ */
+static struct {
+    bool enabled;
+    volatile bool busy;
+    volatile int status;
+    crc_ctx_t ctx;
+    crc_job_t job;                  /* One chunk at a time, continuing ctx */
+} fpga_crc;
+
+static void fpga_crc_done(crc_job_t *job, uint32_t crc) {
+    (void)crc;
+    if (job->status != HAL_OK) {
+        fpga_crc.status = HAL_ERROR;
+    }
+    fpga_crc.busy = false;
+}
+
+static void fpga_crc_begin(const fpga_source_t *src) {
+    fpga_crc.enabled = src->has_crc && src->total > 0;
+    fpga_crc.busy = false;
+    fpga_crc.status = HAL_OK;
+    if (!fpga_crc.enabled) {
+        return;
+    }
+    crc_init(&fpga_crc.ctx, &crc16_ccitt_false, CRC_ENGINE_HW);
+    memset(&fpga_crc.job, 0, sizeof(fpga_crc.job));
+    fpga_crc.job.ctx = &fpga_crc.ctx;
+    fpga_crc.job.cb = fpga_crc_done;
+}
+
+/* Stops a feed cut short by a failed stream */
+static void fpga_crc_end(void) {
+    if (fpga_crc.enabled && fpga_crc.busy) {
+        crc_job_cancel(&fpga_crc.job);
+        fpga_crc.busy = false;
+    }
+}
+
+static int fpga_crc_feed(const uint8_t *data, int len) {
+    if (!fpga_crc.enabled) {
+        return HAL_OK;
+    }
+    fpga_crc.busy = true;
+    fpga_crc.job.data = data;
+    fpga_crc.job.len = (size_t)len;
+    if (crc_job_submit(&fpga_crc.job) != HAL_OK) {
+        fpga_crc.busy = false;
+        return HAL_ERROR;
+    }
+    return HAL_OK;
+}
+
+/*
+ * Non-blocking bitstream stream: cmd followed by everything the source
+ * produces, sent as one I2C write. The next chunk is acquired (e.g.
+ * decompressed) while the previous one is still being clocked out by DMA,
+ * so a compressed source costs no extra wall time as long as it outpaces
+ * the bus.
+ */
+#define FPGA_STREAM_PENDING     (-1)    /* Distinct from every HAL_StatusTypeDef */
+
+static struct {
+    fpga_source_t *src;
+    i2c_segment_t segs[2];
+    const uint8_t *cmd;
+    int cmd_len;
+    size_t sent;
+    const uint8_t *pending;         /* Acquired, not yet on the wire */
+    int pending_len;
+    bool started;
+    bool inflight;
+    bool failed;
+    bool crc_mismatch;
+    uint32_t irq_start;
+    uint32_t tick_start;
+} fpga_stream;
+
+static fpga_stream_stats_t fpga_stream_stats;
+
+static void fpga_stream_begin(const uint8_t *cmd, int cmd_len, fpga_source_t *src) {
+    memset(&fpga_stream, 0, sizeof(fpga_stream));
+    fpga_stream.src = src;
+    fpga_stream.cmd = cmd;
+    fpga_stream.cmd_len = cmd_len;
+    fpga_crc_begin(src);
+
+    memset(&fpga_stream_stats, 0, sizeof(fpga_stream_stats));
+    fpga_stream.irq_start = i2c1_irq_count;
+    fpga_stream.tick_start = HAL_GetTick();
+}
+
+static int fpga_stream_end(int ret) {
+    fpga_crc_end();
+    fpga_stream_stats.bytes = (uint32_t)fpga_stream.sent;
+    fpga_stream_stats.irqs = i2c1_irq_count - fpga_stream.irq_start;
+    fpga_stream_stats.ms = HAL_GetTick() - fpga_stream.tick_start;
+    return ret;
+}
+
+/* Acquire the next chunk and start checksumming it */
+static void fpga_stream_acquire(fpga_source_t *src) {
+    fpga_stream.pending_len = src->acquire(src, &fpga_stream.pending);
+    if (fpga_stream.pending_len < 0 ||
+        (fpga_stream.pending_len > 0 && fpga_crc_feed(fpga_stream.pending, fpga_stream.pending_len) != HAL_OK)) {
+        fpga_stream.pending_len = 0;
+        fpga_stream.failed = true;
+    }
+}
+
+/* Called before the last chunk goes out, once its CRC has been accumulated */
+static bool fpga_stream_crc_ok(fpga_source_t *src) {
+    uint16_t crc;
+
+    if (!fpga_crc.enabled) {
+        return true;
+    }
+    fpga_crc_end();
+    crc = (uint16_t)crc_final(&fpga_crc.ctx);
+    if (fpga_crc.status != HAL_OK || crc != src->crc16) {
+        printf("Bitstream CRC mismatch: 0x%04X, expected 0x%04X\r\n", crc, src->crc16);
+        return false;
+    }
+    printf("Bitstream CRC OK: 0x%04X\r\n", crc);
+    return true;
+}
+
+/* Returns FPGA_STREAM_PENDING while the stream is in progress, HAL_OK when done, or an error */
+static int fpga_stream_poll(void) {
+    fpga_source_t *src = fpga_stream.src;
+    uint32_t flags;
+    int nsegs = 0;
+    int ret;
+
+    if (fpga_stream.inflight) {
+        if (!i2c_seq_done) {
+            // Prefetch the next chunk while the current one is on the wire
+            if (fpga_stream.pending_len == 0 && !fpga_stream.failed && !fpga_crc.busy &&
+                fpga_stream.sent < src->total) {
+                fpga_stream_acquire(src);
+            }
+            return FPGA_STREAM_PENDING;
+        }
+        fpga_stream.inflight = false;
+        if (src->total > 0) {
+            src->release(src);
         }
+        if (i2c_seq_status != HAL_OK) {
+            return fpga_stream_end(i2c_seq_status);
+        }
+    }
 
-        // Wait for the transmission to complete
-        while (!txComplete && !i2cError) {}
+    if (fpga_stream.started && fpga_stream.sent == src->total) {
+        return fpga_stream_end(HAL_OK);
+    }
 
-        if (i2cError)
-        {
-            return HAL_ERROR;
+    if (fpga_stream.pending_len == 0 && !fpga_stream.failed && src->total > 0) {
+        fpga_stream_acquire(src);
+        if (fpga_stream.pending_len == 0 && !fpga_stream.failed) {
+            fpga_stream_stats.starved++;
+            return FPGA_STREAM_PENDING;
         }
+    }
 
-        offset += current_chunk_size;
+    // A chunk goes out only after its CRC pass; hold the last one until the image checks out
+    if (fpga_crc.busy) {
+        fpga_stream_stats.starved++;
+        return FPGA_STREAM_PENDING;
+    }
+    if (fpga_stream.pending_len > 0 && fpga_stream.sent + (size_t)fpga_stream.pending_len == src->total &&
+        !fpga_stream_crc_ok(src)) {
+        fpga_stream.crc_mismatch = true;
+        fpga_stream.failed = true;
     }
 
-    printf("Programmed Successfully\r\n");
-    HAL_Delay(100);
-    return HAL_OK;
+    if (fpga_stream.failed) {
+        if (fpga_stream.started) {
+            // Terminate the open transfer so the bus is released
+            static const uint8_t pad = 0xFF;
+            fpga_stream.segs[0] = (i2c_segment_t){ &pad, 1 };
+            i2c_seq_done = false;
+            if (i2c_seq_write_part(fpga_stream.segs, 1, I2C_SEQ_CONTINUE, i2c_seq_blocking_cplt, NULL) == HAL_OK) {
+                i2c_seq_wait();
+            }
+        }
+        return fpga_stream_end(HAL_ERROR);
+    }
+
+    flags = fpga_stream.started ? I2C_SEQ_CONTINUE : 0;
+    if (!fpga_stream.started) {
+        fpga_stream.segs[nsegs++] = (i2c_segment_t){ fpga_stream.cmd, (size_t)fpga_stream.cmd_len };
+    }
+    if (fpga_stream.pending_len > 0) {
+        fpga_stream.segs[nsegs++] = (i2c_segment_t){ fpga_stream.pending, (size_t)fpga_stream.pending_len };
+    }
+    fpga_stream.sent += (size_t)fpga_stream.pending_len;
+    fpga_stream.pending_len = 0;
+    if (fpga_stream.sent < src->total) {
+        flags |= I2C_SEQ_MORE;
+    }
+
+    i2c_seq_done = false;
+    ret = i2c_seq_write_part(fpga_stream.segs, nsegs, flags, i2c_seq_blocking_cplt, NULL);
+    if (ret != HAL_OK) {
+        return fpga_stream_end(ret);
+    }
+    fpga_stream_stats.parts++;
+    fpga_stream.started = true;
+    fpga_stream.inflight = true;
+    return FPGA_STREAM_PENDING;
 }
 
-void fpga_configure() {
+int fpga_program_stream(const uint8_t *cmd, int cmd_len, fpga_source_t *src) {
+    int ret;
+
+    fpga_stream_begin(cmd, cmd_len, src);
+    while ((ret = fpga_stream_poll()) == FPGA_STREAM_PENDING) {
+        __WFI();
+    }
+    return ret;
+}
+
+/*
+ * FPGA configuration state machine.
+ *
+ * fpga_configure_start() kicks off a configuration and fpga_configure_process()
+ * advances it from the main loop without blocking. Instead of sleeping for the
+ * worst case after erase and program, the CrossLink status register (0x3C) is
+ * polled until BUSY clears, so every phase ends as soon as the device is ready.
+ */
+#define FPGA_RESET_HOLD_MS      1000
+#define FPGA_ACTIVATE_MS        10
+#define FPGA_CMD_SETTLE_MS      1
+#define FPGA_STATUS_POLL_MS     1
+#define FPGA_ERASE_TIMEOUT_MS   5000
+#define FPGA_DONE_TIMEOUT_MS    200
+#define FPGA_BUS_WAIT_MS        5       /* Longer than any IMU burst read */
+
+#define FPGA_STATUS_DONE        (1UL << 8)
+#define FPGA_STATUS_BUSY        (1UL << 12)
+#define FPGA_STATUS_FAIL        (1UL << 13)
+
+static const char * const fpga_phase_names[FPGA_PHASE_COUNT] = {
+    "reset", "activate", "erase", "program", "verify",
+};
+
+static struct {
+    fpga_cfg_state_t state;
+    fpga_cfg_phase_t phase;
+    fpga_source_t *src;
+    uint32_t wait_start;
+    uint32_t last_poll;
+    uint32_t phase_start;
+    uint32_t phase_ms[FPGA_PHASE_COUNT];
+    uint32_t status;
+} fpga_cfg;
+
+static fpga_lz4_source_t fpga_builtin_src;
+
+static int fpga_read_status(uint32_t *status) {
+    int ret;
+
+    memset(read_buf, 0, 4);
+    memcpy(write_buf, (uint8_t[]){0x3C,0x00,0x00,0x00}, 4);
+    ret = i2c_write_and_read(write_buf, 4, read_buf, 4);
+    *status = ((uint32_t)read_buf[0] << 24) | ((uint32_t)read_buf[1] << 16) |
+              ((uint32_t)read_buf[2] << 8) | read_buf[3];
+    return ret;
+}
+
+static void fpga_send_cmd(uint8_t opcode) {
+    memcpy(write_buf, (uint8_t[]){opcode,0x00,0x00,0x00}, 4);
+    i2c_write_bytes(write_buf, 4);
+}
+
+static void fpga_enter(fpga_cfg_state_t state) {
+    fpga_cfg.state = state;
+    fpga_cfg.wait_start = HAL_GetTick();
+    fpga_cfg.last_poll = fpga_cfg.wait_start;
+}
+
+static void fpga_begin_phase(fpga_cfg_phase_t phase) {
+    uint32_t now = HAL_GetTick();
+
+    if (phase > fpga_cfg.phase) {
+        fpga_cfg.phase_ms[fpga_cfg.phase] = now - fpga_cfg.phase_start;
+    }
+    fpga_cfg.phase = phase;
+    fpga_cfg.phase_start = now;
+}
+
+static bool fpga_elapsed(uint32_t ms) {
+    return (HAL_GetTick() - fpga_cfg.wait_start) >= ms;
+}
+
+static void fpga_fail(const char *what) {
+    fpga_cfg.phase_ms[fpga_cfg.phase] = HAL_GetTick() - fpga_cfg.phase_start;
+    printf("FPGA configuration failed: %s (status 0x%08lX)\r\n", what, (unsigned long)fpga_cfg.status);
+    fpga_cfg.state = FPGA_CFG_ERROR;
+}
+
+/*
+ * Poll the status register (rate limited) until BUSY clears.
+ * Returns 1 while busy, 0 when ready, -1 on timeout or read failure.
+ */
+static int fpga_poll_ready(uint32_t timeout_ms) {
+    uint32_t now = HAL_GetTick();
+
+    if (now - fpga_cfg.last_poll < FPGA_STATUS_POLL_MS) {
+        return fpga_elapsed(timeout_ms) ? -1 : 1;
+    }
+    fpga_cfg.last_poll = now;
+
+    if (fpga_read_status(&fpga_cfg.status) != HAL_OK) {
+        return -1;
+    }
+    if (!(fpga_cfg.status & FPGA_STATUS_BUSY)) {
+        return 0;
+    }
+    return fpga_elapsed(timeout_ms) ? -1 : 1;
+}
+
+int fpga_configure_start(fpga_source_t *src) {
+    uint32_t start;
+
+    if (fpga_configure_busy()) {
+        return HAL_BUSY;
+    }
+
+    // Wait out an IMU read in flight, then keep the bus until configuration ends
+    start = HAL_GetTick();
+    while (!i2c_bus_claim(I2C_BUS_FPGA)) {
+        if (HAL_GetTick() - start > FPGA_BUS_WAIT_MS) {
+            return HAL_BUSY;
+        }
+    }
+
+    if (src == NULL) {
+        if (fpga_source_init_lz4(&fpga_builtin_src, bitstream_lz4, bitstream_lz4_SIZE) != 0) {
+            printf("Invalid compressed bitstream image\r\n");
+            i2c_bus_release(I2C_BUS_FPGA);
+            return HAL_ERROR;
+        }
+        src = &fpga_builtin_src.base;
+    }
+
     printf("Starting FPGA configuration...\r\n");
+    memset(&fpga_cfg, 0, sizeof(fpga_cfg));
+    fpga_cfg.src = src;
+    fpga_begin_phase(FPGA_PHASE_RESET);
 
     // Set GPIO LOW
     HAL_GPIO_WritePin(FPGA_RESET_GPIO_Port, FPGA_RESET_Pin, GPIO_PIN_RESET);
-    delay_ms(1000);
+    fpga_enter(FPGA_CFG_RESET);
+    return HAL_OK;
+}
 
-    // Activation Key
-    uint8_t activation_key[] = {0xFF, 0xA4, 0xC6, 0xF4, 0x8A};
-    i2c_write_bytes(activation_key, 5);
-    HAL_GPIO_WritePin(FPGA_RESET_GPIO_Port, FPGA_RESET_Pin, GPIO_PIN_SET);
-    delay_ms(10);
+bool fpga_configure_busy(void) {
+    return fpga_cfg.state != FPGA_CFG_IDLE && fpga_cfg.state != FPGA_CFG_DONE &&
+           fpga_cfg.state != FPGA_CFG_ERROR;
+}
 
-    // IDCODE
-    memset(read_buf, 0, 4);
-    memcpy(write_buf, (uint8_t[]){0xE0,0x00,0x00,0x00}, 4);
-    i2c_write_and_read(write_buf, 4, read_buf, 4);
-    print_hex_buf("IDCODE", read_buf, 4);
+fpga_cfg_state_t fpga_configure_state(void) {
+    return fpga_cfg.state;
+}
 
-    // Enable SRAM
-    memcpy(write_buf, (uint8_t[]){0xC6,0x00,0x00,0x00}, 4);
-    i2c_write_bytes(write_buf, 4);
-    delay_ms(1);
+uint32_t fpga_configure_phase_ms(fpga_cfg_phase_t phase) {
+    return (phase < FPGA_PHASE_COUNT) ? fpga_cfg.phase_ms[phase] : 0;
+}
 
-    // Erase SRAM
-    memcpy(write_buf, (uint8_t[]){0x0E,0x00,0x00,0x00}, 4);
-    i2c_write_bytes(write_buf, 4);
-    delay_ms(5000);
+const fpga_stream_stats_t *fpga_configure_stream_stats(void) {
+    return &fpga_stream_stats;
+}
 
-    // Read Status
-    memset(read_buf, 0, 4);
-    memcpy(write_buf, (uint8_t[]){0x3C,0x00,0x00,0x00}, 4);
-    i2c_write_and_read(write_buf, 4, read_buf, 4);
-    print_hex_buf("Erase Status", read_buf, 4);
+bool fpga_configure_process(void) {
+    int ret;
 
-    // Program Command
-    memcpy(write_buf, (uint8_t[]){0x46,0x00,0x00,0x00}, 4);
-    i2c_write_bytes(write_buf, 4);
-    delay_ms(1);
+    switch (fpga_cfg.state) {
+    case FPGA_CFG_RESET:
+        if (!fpga_elapsed(FPGA_RESET_HOLD_MS)) {
+            break;
+        }
+        fpga_begin_phase(FPGA_PHASE_ACTIVATE);
+
+        // Activation Key
+        uint8_t activation_key[] = {0xFF, 0xA4, 0xC6, 0xF4, 0x8A};
+        i2c_write_bytes(activation_key, 5);
+        HAL_GPIO_WritePin(FPGA_RESET_GPIO_Port, FPGA_RESET_Pin, GPIO_PIN_SET);
+        fpga_enter(FPGA_CFG_ACTIVATE);
+        break;
+
+    case FPGA_CFG_ACTIVATE:
+        if (!fpga_elapsed(FPGA_ACTIVATE_MS)) {
+            break;
+        }
 
-    // Send Bitstream
-    memcpy(write_buf, (uint8_t[]){0x7A,0x00,0x00,0x00}, 4);
-    i2c_write_long(write_buf, 4, (uint8_t*)bitstream_file_buffer, (size_t)bitstream_file_buffer_SIZE);
-    delay_ms(100);
+        // IDCODE
+        memset(read_buf, 0, 4);
+        memcpy(write_buf, (uint8_t[]){0xE0,0x00,0x00,0x00}, 4);
+        i2c_write_and_read(write_buf, 4, read_buf, 4);
+        print_hex_buf("IDCODE", read_buf, 4);
 
-    // USERCODE (optional)
-    memset(read_buf, 0, 4);
-    memcpy(write_buf, (uint8_t[]){0xC0,0x00,0x00,0x00}, 4);
-    i2c_write_and_read(write_buf, 4, read_buf, 4);
-    print_hex_buf("User Register", read_buf, 4);
+        // Enable SRAM
+        fpga_send_cmd(0xC6);
+        fpga_enter(FPGA_CFG_ENABLE);
+        break;
 
-    // Final Status
-    memset(read_buf, 0, 4);
-    memcpy(write_buf, (uint8_t[]){0x3C,0x00,0x00,0x00}, 4);
-    i2c_write_and_read(write_buf, 4, read_buf, 4);
-    print_hex_buf("Program Status", read_buf, 4);
+    case FPGA_CFG_ENABLE:
+        if (!fpga_elapsed(FPGA_CMD_SETTLE_MS)) {
+            break;
+        }
+        fpga_begin_phase(FPGA_PHASE_ERASE);
 
-    // Exit Program Mode
-    memcpy(write_buf, (uint8_t[]){0x26,0x00,0x00,0x00}, 4);
-    i2c_write_bytes(write_buf, 4);
+        // Erase SRAM
+        fpga_send_cmd(0x0E);
+        fpga_enter(FPGA_CFG_ERASE);
+        break;
+
+    case FPGA_CFG_ERASE:
+        ret = fpga_poll_ready(FPGA_ERASE_TIMEOUT_MS);
+        if (ret > 0) {
+            break;
+        }
+        if (ret < 0 || (fpga_cfg.status & FPGA_STATUS_FAIL)) {
+            fpga_fail("erase");
+            break;
+        }
+        printf("Erase Status: %08lX\r\n", (unsigned long)fpga_cfg.status);
+
+        // Program Command
+        fpga_send_cmd(0x46);
+        fpga_enter(FPGA_CFG_PROGRAM_CMD);
+        break;
+
+    case FPGA_CFG_PROGRAM_CMD:
+        if (!fpga_elapsed(FPGA_CMD_SETTLE_MS)) {
+            break;
+        }
+        fpga_begin_phase(FPGA_PHASE_PROGRAM);
+
+        // Send Bitstream
+        static const uint8_t program_cmd[4] = {0x7A, 0x00, 0x00, 0x00};
+        fpga_stream_begin(program_cmd, sizeof(program_cmd), fpga_cfg.src);
+        fpga_enter(FPGA_CFG_STREAM);
+        break;
+
+    case FPGA_CFG_STREAM:
+        ret = fpga_stream_poll();
+        if (ret == FPGA_STREAM_PENDING) {
+            break;
+        }
+        if (ret != HAL_OK) {
+            fpga_fail(fpga_stream.crc_mismatch ? "bitstream CRC mismatch" : "bitstream transfer");
+            break;
+        }
+        printf("Programmed Successfully\r\n");
+        fpga_begin_phase(FPGA_PHASE_VERIFY);
+        fpga_enter(FPGA_CFG_VERIFY);
+        break;
+
+    case FPGA_CFG_VERIFY:
+        ret = fpga_poll_ready(FPGA_DONE_TIMEOUT_MS);
+        if (ret > 0) {
+            break;
+        }
+
+        // USERCODE (optional)
+        memset(read_buf, 0, 4);
+        memcpy(write_buf, (uint8_t[]){0xC0,0x00,0x00,0x00}, 4);
+        i2c_write_and_read(write_buf, 4, read_buf, 4);
+        print_hex_buf("User Register", read_buf, 4);
+        printf("Program Status: %08lX\r\n", (unsigned long)fpga_cfg.status);
+
+        if (ret < 0 || (fpga_cfg.status & FPGA_STATUS_FAIL) || !(fpga_cfg.status & FPGA_STATUS_DONE)) {
+            fpga_fail("device not DONE");
+            break;
+        }
+
+        // Exit Program Mode
+        fpga_send_cmd(0x26);
+        fpga_cfg.phase_ms[FPGA_PHASE_VERIFY] = HAL_GetTick() - fpga_cfg.phase_start;
 
-    printf("FPGA configuration complete.\r\n");
+        uint32_t total = 0;
+        for (int i = 0; i < FPGA_PHASE_COUNT; i++) {
+            printf("  %-8s %5lu ms\r\n", fpga_phase_names[i], (unsigned long)fpga_cfg.phase_ms[i]);
+            total += fpga_cfg.phase_ms[i];
+        }
+        printf("FPGA configuration complete in %lu ms.\r\n", (unsigned long)total);
+        printf("  stream   %lu bytes in %lu ms, %lu parts, %lu irqs (%lu bytes/irq), %lu starved polls\r\n",
+               (unsigned long)fpga_stream_stats.bytes, (unsigned long)fpga_stream_stats.ms,
+               (unsigned long)fpga_stream_stats.parts, (unsigned long)fpga_stream_stats.irqs,
+               (unsigned long)(fpga_stream_stats.irqs ? fpga_stream_stats.bytes / fpga_stream_stats.irqs : 0),
+               (unsigned long)fpga_stream_stats.starved);
+        fpga_cfg.state = FPGA_CFG_DONE;
+        break;
+
+    default:
+        break;
+    }
+
+    if (!fpga_configure_busy()) {
+        i2c_bus_release(I2C_BUS_FPGA);
+        return false;
+    }
+    return true;
+}
+
+void fpga_configure() {
+    if (fpga_configure_start(NULL) != HAL_OK) {
+        return;
+    }
+    while (fpga_configure_process()) {
+        __WFI();
+    }
 }
 
 // Callback implementations
 void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
 {
+    if (i2c_seq.active)
+    {
+        if (i2c_seq.sent == i2c_seq.total)
+        {
+            i2c_seq_finish(HAL_OK);
+        }
+        else if (i2c_seq_next_chunk() != HAL_OK)
+        {
+            i2c_seq_finish(HAL_ERROR);
+        }
+        return;
+    }
+
     txComplete = 1;
 }
 
@@ -214,6 +802,18 @@ void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c)
 
 void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
 {
+    if (i2c_bus_current == I2C_BUS_IMU)
+    {
+        ICM_I2C_ErrorCallback(hi2c);
+        return;
+    }
+
+    if (i2c_seq.active)
+    {
+        i2c_seq_finish(HAL_ERROR);
+        return;
+    }
+
     i2cError = 1;
 }
 
@@ -0,0 +1,127 @@
+/*
+ * fpga_source.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Bitstream sources for the CrossLink programmer: raw images are handed out
+ *  in place, compressed images are decoded block by block into a pair of RAM
+ *  buffers so the next block can be prepared while the previous one is sent.
+ */
+
+#include "fpga_source.h"
+#include "lz4_block.h"
+#include <string.h>
+
+#define LZ4_IMAGE_MAGIC       "XLZ4"
+#define LZ4_IMAGE_HDR_SIZE    12
+#define LZ4_BLOCK_STORED      0x8000
+
+static int raw_acquire(fpga_source_t *base, const uint8_t **chunk) {
+    fpga_raw_source_t *src = (fpga_raw_source_t *)base;
+    size_t len = base->total - src->pos;
+
+    if (len > FPGA_RAW_CHUNK_SIZE) {
+        len = FPGA_RAW_CHUNK_SIZE;
+    }
+    *chunk = &src->data[src->pos];
+    src->pos += len;
+    return (int)len;
+}
+
+static void raw_release(fpga_source_t *base) {
+    (void)base;
+}
+
+int fpga_source_init_raw(fpga_raw_source_t *src, const uint8_t *data, size_t len) {
+    if (data == NULL) {
+        return -1;
+    }
+    src->base.total = len;
+    src->base.has_crc = false;
+    src->base.acquire = raw_acquire;
+    src->base.release = raw_release;
+    src->data = data;
+    src->pos = 0;
+    return 0;
+}
+
+static uint16_t get_le16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_le32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static int lz4_acquire(fpga_source_t *base, const uint8_t **chunk) {
+    fpga_lz4_source_t *src = (fpga_lz4_source_t *)base;
+    uint8_t *dst = src->buf[src->head];
+    size_t want = base->total - src->produced;
+    uint16_t hdr;
+    size_t len;
+    int ret;
+
+    if (want == 0) {
+        return -1;
+    }
+    if (want > src->block_size) {
+        want = src->block_size;
+    }
+    if (src->end - src->next < 2) {
+        return -1;
+    }
+    hdr = get_le16(src->next);
+    src->next += 2;
+    len = hdr & ~LZ4_BLOCK_STORED;
+    if (len > (size_t)(src->end - src->next)) {
+        return -1;
+    }
+
+    if (hdr & LZ4_BLOCK_STORED) {
+        ret = (len == want) ? (int)len : -1;
+        if (ret > 0) {
+            memcpy(dst, src->next, len);
+        }
+    } else {
+        ret = lz4_block_decompress(src->next, len, dst, want);
+    }
+    src->next += len;
+
+    // Every block but the last decodes to exactly block_size bytes
+    if (ret != (int)want) {
+        return -1;
+    }
+
+    src->produced += want;
+    src->head ^= 1;
+    *chunk = dst;
+    return ret;
+}
+
+static void lz4_release(fpga_source_t *base) {
+    // Buffers alternate; with at most two outstanding chunks the one being
+    // released is never the one acquire() decodes into next.
+    (void)base;
+}
+
+int fpga_source_init_lz4(fpga_lz4_source_t *src, const uint8_t *image, size_t image_len) {
+    if (image == NULL || image_len < LZ4_IMAGE_HDR_SIZE || memcmp(image, LZ4_IMAGE_MAGIC, 4) != 0) {
+        return -1;
+    }
+
+    src->block_size = get_le16(&image[8]);
+    if (src->block_size == 0 || src->block_size > FPGA_LZ4_BLOCK_MAX) {
+        return -1;
+    }
+
+    src->base.total = get_le32(&image[4]);
+    src->base.acquire = lz4_acquire;
+    src->base.release = lz4_release;
+    src->base.has_crc = true;
+    src->base.crc16 = get_le16(&image[10]);
+    src->next = image + LZ4_IMAGE_HDR_SIZE;
+    src->end = image + image_len;
+    src->produced = 0;
+    src->head = 0;
+    return 0;
+}
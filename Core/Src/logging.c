@@ -1,21 +1,66 @@
 #include "main.h"
 #include "logging.h"
-#include "lwrb.h"
+#include "lwrb_mr.h"
+#include "utils.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdarg.h>
+#include <stddef.h>
 
 static bool bInit_dma = false;
 volatile bool bPrintfTransferComplete = false;
 
-static uint8_t usart_start_tx_dma_transfer(void);
+/*
+ * Log ring: one byte stream fanned out to every sink through its own
+ * lwrb_mr reader. Producers (thread code or any ISR) write with
+ * lwrb_mr_claim()/lwrb_mr_commit(), which is lock-free for any number of
+ * them; see lwrb_mr.h.
+ *
+ * On the read side every sink claims its own transfers through sink->busy,
+ * so each transfer is started by exactly one context.
+ */
+static lwrb_mr_t log_ring;
+static uint8_t log_ring_data[1024];         /* Power of two */
+static logging_stats_t log_stats;
 
-/* Ring buffer for TX data */
-lwrb_t usart_tx_buff;
-uint8_t usart_tx_buff_data[1024];
-volatile size_t usart_tx_dma_current_len;
+#define LOG_LINE_MAX            128
+#define LOG_TEXT_CHUNK          128
+#define LOG_MAX_SINKS           LWRB_MR_MAX_READERS
+#define LOG_UART_MAX_BURST      256
+#define LOG_LAP_HEADROOM        (2 * LOG_UART_MAX_BURST)
+
+/*
+ * Log sinks. A sink's reader holds the start of the span handed to its
+ * current transfer, so space is reused only once every sink is done with
+ * it; pos is the next byte to send. A sink that falls behind another one
+ * (the UART next to USB CDC) is lapped rather than allowed to hold the
+ * ring: its unsent data is skipped and counted, and the faster sink never
+ * waits for it. A sink stays attached to the ring while a transfer is in
+ * flight, even after logging_sink_detach().
+ */
+static log_sink_t *log_sinks[LOG_MAX_SINKS];
+
+static int log_uart_send(log_sink_t *sink, const uint8_t *data, size_t len);
+
+static log_sink_t log_uart_sink = {
+    .name = "uart",
+    .send = log_uart_send,
+    .max_burst = LOG_UART_MAX_BURST,
+};
+
+static const char * const log_policy_names[LOG_POLICY_COUNT] = {
+    "drop-newest", "drop-oldest", "truncate", "block",
+};
+
+static log_policy_t log_level_policy[LOG_LEVEL_COUNT] = {
+    [LOG_LEVEL_DEBUG] = LOG_POLICY_DROP_NEWEST,
+    [LOG_LEVEL_INFO]  = LOG_POLICY_DROP_NEWEST,
+    [LOG_LEVEL_WARN]  = LOG_POLICY_DROP_OLDEST,
+    [LOG_LEVEL_ERROR] = LOG_POLICY_BLOCK,
+};
 
 
 #ifdef __GNUC__
@@ -27,26 +72,472 @@ volatile size_t usart_tx_dma_current_len;
 #endif /* __GNUC__ */
 
 
-#ifdef __GNUC__
-int _write(int fd, const void *buf, size_t count){
-	UNUSED(fd);
-	uint8_t * src = (uint8_t *)buf;
+static size_t log_ring_write(const uint8_t *data, size_t count, size_t min) {
+    lwrb_span_t span;
+    size_t len;
+
+    len = lwrb_mr_claim(&log_ring, count, min, &span);
+    if (len == 0) {
+        return 0;
+    }
+    memcpy(span.data[0], data, span.len[0]);
+    if (span.len[1] > 0) {
+        memcpy(span.data[1], &data[span.len[0]], span.len[1]);
+    }
+    __atomic_add_fetch(&log_stats.written, len, __ATOMIC_RELAXED);
+    lwrb_mr_commit(&log_ring, len);
+    return len;
+}
+
+static bool log_sink_active(const log_sink_t *sink) {
+    return sink->attached || sink->inflight > 0;
+}
+
+/* Read position of the sink furthest behind, or w if no sink holds data; interrupts masked */
+static size_t log_ring_tail(size_t w) {
+    size_t r = w;
+
+    for (int i = 0; i < LOG_MAX_SINKS; i++) {
+        log_sink_t *sink = log_sinks[i];
+        if (sink != NULL && log_sink_active(sink) && w - sink->reader.r > w - r) {
+            r = sink->reader.r;
+        }
+    }
+    return r;
+}
+
+/*
+ * Free `needed` bytes by moving sink cursors forward over data they have not
+ * sent yet. With laggards_only a sink is moved at most up to the sink furthest
+ * ahead, i.e. only over data another sink has already consumed; otherwise all
+ * sinks are moved (drop oldest). Spans already handed to a transfer are freed
+ * when it completes. Returns the bytes released from the ring.
+ */
+static size_t log_sinks_lap(size_t needed, bool laggards_only) {
+    uint32_t primask = __get_PRIMASK();
+    size_t w, r, target, t, lead = 0, released;
+    int active = 0;
+
+    __disable_irq();
+    w = log_ring.w;
+    r = log_ring_tail(w);
+    target = w - r;
+    if (needed < target) {
+        target = needed;
+    }
+
+    for (int i = 0; i < LOG_MAX_SINKS; i++) {
+        log_sink_t *sink = log_sinks[i];
+        if (sink != NULL && log_sink_active(sink)) {
+            size_t d = sink->pos - r;
+            lead = (d > lead) ? d : lead;
+            active++;
+        }
+    }
+    if (laggards_only) {
+        if (active < 2) {
+            __set_PRIMASK(primask);
+            return 0;
+        }
+        target = (lead < target) ? lead : target;
+    }
+
+    for (int i = 0; i < LOG_MAX_SINKS; i++) {
+        log_sink_t *sink = log_sinks[i];
+        size_t d;
+        if (sink == NULL || !sink->attached) {
+            continue;
+        }
+        /*
+         * A span in flight frees nothing until it completes; move that sink up
+         * to the lead so the completion releases all the others have consumed.
+         */
+        t = (laggards_only && sink->busy) ? lead : target;
+        d = sink->pos - r;
+        /* A claimed sink with nothing in flight is setting up a transfer from pos */
+        if (d >= t || (sink->busy && sink->inflight == 0)) {
+            continue;
+        }
+        sink->lapped_bytes += t - d;
+        sink->pos = r + t;
+        if (!sink->busy) {
+            lwrb_mr_skip(&log_ring, &sink->reader, sink->pos - sink->reader.r);
+        }
+    }
+    released = log_ring_tail(w) - r;
+    __set_PRIMASK(primask);
+    return released;
+}
+
+/*
+ * Keep a slow sink from holding the ring while a faster one has moved on.
+ * Lapping starts before the ring is full: a span in flight is only released
+ * when its transfer completes, and messages logged until then need room.
+ */
+static void log_ring_make_room(size_t count) {
+    size_t free = lwrb_mr_get_free(&log_ring);
+
+    if (count + LOG_LAP_HEADROOM > free) {
+        log_sinks_lap(count + LOG_LAP_HEADROOM - free, true);
+    }
+}
+
+static void log_sink_kick(log_sink_t *sink) {
+    uint32_t idle;
+    size_t len;
+
+    for (;;) {
+        /* Only the context that wins sink->busy may start a transfer */
+        idle = 0;
+        if (!__atomic_compare_exchange_n(&sink->busy, &idle, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            return;
+        }
+
+        /* Largest linear block from the reader, which is at pos while idle; after a wrap
+           the next one is chained on completion */
+        len = sink->attached ? lwrb_mr_get_linear_block_read_length(&log_ring, &sink->reader) : 0;
+        if (len > 0) {
+            if (sink->max_burst > 0 && len > sink->max_burst) {
+                len = sink->max_burst;
+            }
+            sink->pos = sink->reader.r + len;
+            sink->inflight = len;
+            if (sink->send(sink, lwrb_mr_get_linear_block_read_address(&log_ring, &sink->reader), len) == HAL_OK) {
+                return;
+            }
+            /* Sink not ready; retried on the next write or completion */
+            sink->pos = sink->reader.r;
+            sink->inflight = 0;
+            __atomic_store_n(&sink->busy, 0, __ATOMIC_RELEASE);
+            return;
+        }
+
+        /* Nothing to send; data published after the check is picked up here */
+        __atomic_store_n(&sink->busy, 0, __ATOMIC_RELEASE);
+        if (!sink->attached || lwrb_mr_get_full(&log_ring, &sink->reader) == 0) {
+            return;
+        }
+    }
+}
+
+static void log_sinks_kick(void) {
+    for (int i = 0; i < LOG_MAX_SINKS; i++) {
+        if (log_sinks[i] != NULL && log_sinks[i]->attached) {
+            log_sink_kick(log_sinks[i]);
+        }
+    }
+}
+
+/* Called by a sink when its transfer has completed (any context) */
+void logging_sink_done(log_sink_t *sink) {
+    uint32_t primask;
+
+    if (sink->inflight == 0) {
+        /* Not ours (e.g. another user of the same endpoint); just retry */
+        log_sink_kick(sink);
+        return;
+    }
+
+    /* Release the span sent, and whatever the sink was lapped over meanwhile */
+    primask = __get_PRIMASK();
+    __disable_irq();
+    lwrb_mr_skip(&log_ring, &sink->reader, sink->pos - sink->reader.r);
+    sink->inflight = 0;
+    if (!sink->attached) {
+        lwrb_mr_detach(&log_ring, &sink->reader);
+    }
+    __set_PRIMASK(primask);
+
+    __atomic_store_n(&sink->busy, 0, __ATOMIC_RELEASE);
+    log_sink_kick(sink);
+}
+
+/*
+ * Called by a sink whose transfer failed (any context). The span is dropped
+ * rather than resent, since part of it may already be out, and the sink
+ * carries on from the next byte.
+ */
+void logging_sink_error(log_sink_t *sink) {
+    if (sink->inflight != 0) {
+        sink->errors++;
+        sink->error_bytes += sink->inflight;
+    }
+    logging_sink_done(sink);
+}
+
+/* Start feeding a sink; it receives what is logged from now on */
+bool logging_sink_attach(log_sink_t *sink) {
+    uint32_t primask = __get_PRIMASK();
+    int slot = -1;
+
+    __disable_irq();
+    for (int i = 0; i < LOG_MAX_SINKS; i++) {
+        if (log_sinks[i] == sink) {
+            slot = i;
+            break;
+        }
+        if (log_sinks[i] == NULL && slot < 0) {
+            slot = i;
+        }
+    }
+    /* Still on the ring if a transfer is in flight */
+    if (slot >= 0 && !log_sink_active(sink)) {
+        if (lwrb_mr_attach(&log_ring, &sink->reader, 0)) {
+            sink->pos = sink->reader.r;
+        } else {
+            slot = -1;
+        }
+    }
+    if (slot >= 0) {
+        log_sinks[slot] = sink;
+        sink->attached = true;
+    }
+    __set_PRIMASK(primask);
+
+    /* A newly attached reader needs the timebase to render timestamps */
+    if (slot >= 0) {
+        logging_timebase();
+    }
+    return slot >= 0;
+}
+
+/* Stop feeding a sink; a transfer in progress still completes */
+void logging_sink_detach(log_sink_t *sink) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    sink->attached = false;
+    if (sink->inflight == 0) {
+        lwrb_mr_detach(&log_ring, &sink->reader);
+    }
+    __set_PRIMASK(primask);
+}
+
+static void log_count_drop(logging_policy_stats_t *st, size_t bytes) {
+    __atomic_add_fetch(&st->dropped, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&st->dropped_bytes, bytes, __ATOMIC_RELAXED);
+}
+
+/*
+ * Queue a message under the given policy; returns the bytes queued. Only the
+ * truncate policy queues less than count, and never less than min.
+ */
+static size_t log_ring_write_policy(const uint8_t *data, size_t count, log_policy_t policy, size_t min) {
+    logging_policy_stats_t *st = &log_stats.policy[policy];
+    size_t cap = log_ring.size;
+    size_t n = 0;
+
+    __atomic_add_fetch(&st->messages, 1, __ATOMIC_RELAXED);
+    log_ring_make_room((count > cap) ? cap : count);
+
+    switch (policy) {
+    case LOG_POLICY_BLOCK:
+        // Waiting for the UART from an ISR or with interrupts masked would never return
+        if (__get_IPSR() == 0 && __get_PRIMASK() == 0) {
+            while (n < count) {
+                size_t piece = (count - n > cap) ? cap : count - n;
+                size_t done;
+                while ((done = log_ring_write(&data[n], piece, piece)) == 0) {
+                    log_sinks_kick();
+                    log_ring_make_room(piece);
+                }
+                n += done;
+                log_sinks_kick();
+            }
+            return n;
+        }
+        n = log_ring_write(data, count, count);
+        break;
+
+    case LOG_POLICY_DROP_OLDEST:
+        n = log_ring_write(data, count, count);
+        if (n == 0 && count <= cap) {
+            size_t flushed = log_sinks_lap(count - lwrb_mr_get_free(&log_ring), false);
+            if (flushed > 0) {
+                log_count_drop(st, flushed);
+                n = log_ring_write(data, count, count);
+            }
+        }
+        break;
+
+    case LOG_POLICY_TRUNCATE:
+        n = log_ring_write(data, count, min);
+        if (n > 0 && n < count) {
+            log_count_drop(st, count - n);
+            log_sinks_kick();
+            return n;
+        }
+        break;
+
+    default:
+        n = log_ring_write(data, count, count);
+        break;
+    }
+
+    if (n == 0) {
+        log_count_drop(st, count);
+        return 0;
+    }
+    log_sinks_kick();
+    return n;
+}
+
+static size_t logging_output(const uint8_t *src, size_t count, log_policy_t policy, size_t min) {
 	if(bInit_dma)
 	{
-	    if (lwrb_get_free(&usart_tx_buff) >= count) {
-	        lwrb_write(&usart_tx_buff, buf, count);
-	        usart_start_tx_dma_transfer();
-	    }
+	    return log_ring_write_policy(src, count, policy, min);
 	}
 	else
 	{
-		HAL_StatusTypeDef com_tx_status = HAL_UART_Transmit(&DEBUG_UART, src, count, 10);
+		HAL_StatusTypeDef com_tx_status = HAL_UART_Transmit(&DEBUG_UART, (uint8_t *)src, count, 10);
 		if(com_tx_status != HAL_OK)
 		{
-			Error_Handler();
+			/* A lost log line is no reason to halt */
+			return 0;
 		}
 	}
+	return count;
+}
 
+static size_t log_put_time(uint8_t *rec) {
+    uint64_t now = util_cycles();
+    memcpy(rec, &now, LOGB_TIME_SIZE);
+    return LOGB_TIME_SIZE;
+}
+
+/*
+ * Text goes out behind a timestamp record in the same ring write, so the
+ * two stay together; truncation only ever shortens the text. Returns the
+ * text bytes queued.
+ */
+static size_t logging_text(const uint8_t *src, size_t count, log_policy_t policy) {
+#if LOGGING_BINARY
+    uint8_t rec[1 + LOGB_TIME_SIZE + LOG_TEXT_CHUNK];
+    size_t hdr, n, queued, done = 0;
+
+    while (done < count) {
+        n = (count - done > LOG_TEXT_CHUNK) ? LOG_TEXT_CHUNK : (count - done);
+        rec[0] = LOGB_SYNC_TIME;
+        hdr = 1 + log_put_time(&rec[1]);
+        memcpy(&rec[hdr], &src[done], n);
+
+        queued = logging_output(rec, hdr + n, policy, hdr + 1);
+        if (queued <= hdr) {
+            break;
+        }
+        done += queued - hdr;
+        if (queued < hdr + n) {
+            break;
+        }
+    }
+    return done;
+#else
+    return logging_output(src, count, policy, 1);
+#endif
+}
+
+static int log_vprintf(log_policy_t policy, const char *fmt, va_list ap) {
+    char line[LOG_LINE_MAX];
+    int len = vsnprintf(line, sizeof(line), fmt, ap);
+
+    if (len < 0) {
+        return len;
+    }
+    if (len >= (int)sizeof(line)) {
+        len = sizeof(line) - 1;
+    }
+    len = (int)logging_text((const uint8_t *)line, (size_t)len, policy);
+    return (len > 0) ? len : -1;
+}
+
+/* Returns the number of bytes queued, or -1 if the message was dropped */
+int log_printf(log_level_t level, const char *fmt, ...) {
+    va_list ap;
+    int ret;
+
+    va_start(ap, fmt);
+    ret = log_vprintf(log_level_policy[(level < LOG_LEVEL_COUNT) ? level : LOG_LEVEL_INFO], fmt, ap);
+    va_end(ap);
+    return ret;
+}
+
+int log_printf_policy(log_policy_t policy, const char *fmt, ...) {
+    va_list ap;
+    int ret;
+
+    va_start(ap, fmt);
+    ret = log_vprintf((policy < LOG_POLICY_COUNT) ? policy : LOG_POLICY_DROP_NEWEST, fmt, ap);
+    va_end(ap);
+    return ret;
+}
+
+void logging_set_policy(log_level_t level, log_policy_t policy) {
+    if (level < LOG_LEVEL_COUNT && policy < LOG_POLICY_COUNT) {
+        log_level_policy[level] = policy;
+    }
+}
+
+/* One record per call, so concurrent producers never interleave inside it */
+void logging_bin(uint16_t fmt_id, uint32_t nargs, ...) {
+    uint8_t rec[4 + LOGB_TIME_SIZE + LOGB_MAX_ARGS * 4];
+    size_t len;
+    va_list ap;
+
+    if (nargs > LOGB_MAX_ARGS) {
+        nargs = LOGB_MAX_ARGS;
+    }
+    rec[0] = LOGB_SYNC;
+    rec[1] = (uint8_t)nargs;
+    rec[2] = (uint8_t)fmt_id;
+    rec[3] = (uint8_t)(fmt_id >> 8);
+    len = 4 + log_put_time(&rec[4]);
+
+    va_start(ap, nargs);
+    for (uint32_t i = 0; i < nargs; i++) {
+        uint32_t arg = va_arg(ap, uint32_t);
+        memcpy(&rec[len], &arg, sizeof(arg));
+        len += sizeof(arg);
+    }
+    va_end(ap);
+
+    logging_output(rec, len, log_level_policy[LOG_LEVEL_INFO], len);
+}
+
+void logging_bin_hex(const char *label, const uint8_t *buf, size_t len) {
+    uint8_t rec[6 + LOGB_TIME_SIZE + LOGB_MAX_HEX];
+    uint32_t addr = (uint32_t)(uintptr_t)label;
+    size_t hdr;
+
+    if (len > LOGB_MAX_HEX) {
+        len = LOGB_MAX_HEX;
+    }
+    rec[0] = LOGB_SYNC_HEX;
+    rec[1] = (uint8_t)len;
+    memcpy(&rec[2], &addr, sizeof(addr));
+    hdr = 6 + log_put_time(&rec[6]);
+    memcpy(&rec[hdr], buf, len);
+
+    logging_output(rec, hdr + len, log_level_policy[LOG_LEVEL_INFO], hdr + len);
+}
+
+/* Tells the decoder how to convert record timestamps to seconds */
+void logging_timebase(void) {
+#if LOGGING_BINARY
+    uint8_t rec[5];
+    uint32_t hz = SystemCoreClock;
+
+    rec[0] = LOGB_SYNC_TIMEBASE;
+    memcpy(&rec[1], &hz, sizeof(hz));
+    logging_output(rec, sizeof(rec), log_level_policy[LOG_LEVEL_INFO], sizeof(rec));
+#endif
+}
+
+#ifdef __GNUC__
+int _write(int fd, const void *buf, size_t count){
+	UNUSED(fd);
+	/* Losses are counted in log_stats; reporting a short write would set
+	   newlib's sticky error flag on stdout and silence every later printf */
+	logging_text((const uint8_t *)buf, count, log_level_policy[LOG_LEVEL_INFO]);
 	return count;
 }
 #else
@@ -61,31 +552,53 @@ PUTCHAR_PROTOTYPE
 
 void init_dma_logging()
 {
-    /* Initialize ringbuff */
-    lwrb_init(&usart_tx_buff, usart_tx_buff_data, sizeof(usart_tx_buff_data));
+    lwrb_mr_init(&log_ring, log_ring_data, sizeof(log_ring_data));
+    memset(&log_stats, 0, sizeof(log_stats));
 
     bInit_dma = true;
 	bPrintfTransferComplete = true;
+    logging_sink_attach(&log_uart_sink);
 }
 
 bool is_using_dma(){
 	return bInit_dma;
 }
 
-static uint8_t usart_start_tx_dma_transfer(void) {
-    if (usart_tx_dma_current_len == 0 && (usart_tx_dma_current_len = lwrb_get_linear_block_read_length(&usart_tx_buff)) > 0) {
+void logging_get_stats(logging_stats_t *stats) {
+    memcpy(stats, &log_stats, sizeof(*stats));
+}
+
+void logging_print_stats(void) {
+    logging_stats_t stats;
 
-        /* Limit maximal size to transmit at a time */
-        if (usart_tx_dma_current_len > 32) {
-            usart_tx_dma_current_len = 32;
+    logging_get_stats(&stats);
+    printf("log: %lu bytes queued\r\n", (unsigned long)stats.written);
+    for (int i = 0; i < LOG_POLICY_COUNT; i++) {
+        printf("  %-11s %lu msgs, %lu dropped, %lu bytes lost\r\n", log_policy_names[i],
+               (unsigned long)stats.policy[i].messages, (unsigned long)stats.policy[i].dropped,
+               (unsigned long)stats.policy[i].dropped_bytes);
+    }
+    for (int i = 0; i < LOG_MAX_SINKS; i++) {
+        if (log_sinks[i] != NULL) {
+            printf("  sink %-6s %s, %lu bytes lapped, %lu errors (%lu bytes)\r\n", log_sinks[i]->name,
+                   log_sinks[i]->attached ? "attached" : "detached", (unsigned long)log_sinks[i]->lapped_bytes,
+                   (unsigned long)log_sinks[i]->errors, (unsigned long)log_sinks[i]->error_bytes);
         }
-    	bPrintfTransferComplete = false;
-		if(HAL_UART_Transmit_DMA(&DEBUG_UART, (uint8_t*)lwrb_get_linear_block_read_address(&usart_tx_buff), usart_tx_dma_current_len)!= HAL_OK)
-		{
-			Error_Handler();
-		}
     }
-    return 1;
+}
+
+static int log_uart_send(log_sink_t *sink, const uint8_t *data, size_t len) {
+    UNUSED(sink);
+    bPrintfTransferComplete = false;
+    if(HAL_UART_Transmit_DMA(&DEBUG_UART, (uint8_t*)data, len)!= HAL_OK)
+    {
+        /* UART still busy or locked; the span is retried on the next kick */
+        bPrintfTransferComplete = true;
+        return HAL_ERROR;
+    }
+    /* Only completion matters; skip the half-transfer interrupt */
+    __HAL_DMA_DISABLE_IT(DEBUG_UART.hdmatx, DMA_IT_HT);
+    return HAL_OK;
 }
 
 void logging_UART_TxHalfCpltCallback(UART_HandleTypeDef *huart)
@@ -96,14 +609,22 @@ void logging_UART_TxHalfCpltCallback(UART_HandleTypeDef *huart)
 
 void logging_UART_ErrorCallback(UART_HandleTypeDef *huart)
 {
-
+    /*
+     * RX errors leave the transmitter running. A TX DMA error has already
+     * stopped the stream and ended the transfer (gState back to READY), and
+     * no TxCplt will follow, so release the span here or the sink stays busy.
+     */
+    if (log_uart_sink.inflight == 0 || huart->gState != HAL_UART_STATE_READY)
+    {
+        return;
+    }
+    bPrintfTransferComplete = true;
+    logging_sink_error(&log_uart_sink);
 }
 
 
 void logging_UART_TxCpltCallback(UART_HandleTypeDef *huart)
 {
 	bPrintfTransferComplete = true;
-    lwrb_skip(&usart_tx_buff, usart_tx_dma_current_len);/* Data sent, ignore these */
-    usart_tx_dma_current_len = 0;
-    usart_start_tx_dma_transfer();          /* Try to send more data */
+    logging_sink_done(&log_uart_sink);      /* Data sent; release it and send more */
 }
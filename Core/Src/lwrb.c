@@ -35,7 +35,11 @@
 
 /* Memory set and copy functions */
 #define BUF_MEMSET                      memset
+#if LWRB_USE_WORD_COPY
+#define BUF_MEMCPY                      prv_copy
+#else
 #define BUF_MEMCPY                      memcpy
+#endif /* LWRB_USE_WORD_COPY */
 
 #if LWRB_USE_MAGIC
 #define BUF_IS_VALID(b)                 ((b) != NULL && (b)->magic1 == 0xDEADBEEF && (b)->magic2 == ~0xDEADBEEF && (b)->buff != NULL && (b)->size > 0)
@@ -46,6 +50,57 @@
 #define BUF_MAX(x, y)                   ((x) > (y) ? (x) : (y))
 #define BUF_SEND_EVT(b, type, bp)       do { if ((b)->evt_fn != NULL) { (b)->evt_fn((b), (type), (bp)); } } while (0)
 
+#if LWRB_USE_WORD_COPY
+/* Word-aligned 64-bit accesses; the compiler pairs them into LDRD/STRD */
+typedef uint32_t __attribute__((may_alias)) lwrb_word_t;
+typedef uint64_t __attribute__((may_alias, aligned(4))) lwrb_dword_t;
+
+#define LWRB_COPY_MIN                   16
+
+/**
+ * \brief           Copy `len` bytes between the buffer and user memory
+ * \param[out]      dst: Destination
+ * \param[in]       src: Source
+ * \param[in]       len: Number of bytes to copy
+ * \return          `dst`
+ */
+static void*
+prv_copy(void* dst, const void* src, size_t len) {
+    uint8_t* d = dst;
+    const uint8_t* s = src;
+
+    /*
+     * Only a source and destination that can be word aligned together take
+     * the word path; otherwise the library memcpy handles the misalignment
+     */
+    if (len < LWRB_COPY_MIN || (((uintptr_t)d ^ (uintptr_t)s) & 0x03) != 0) {
+        return memcpy(dst, src, len);
+    }
+
+    /* Head: bytes up to the word boundary */
+    for (; ((uintptr_t)d & 0x03) != 0; --len) {
+        *d++ = *s++;
+    }
+
+    /* Middle: 16 bytes per iteration */
+    for (; len >= 16; len -= 16, d += 16, s += 16) {
+        lwrb_dword_t a = ((const lwrb_dword_t*)s)[0];
+        lwrb_dword_t b = ((const lwrb_dword_t*)s)[1];
+        ((lwrb_dword_t*)d)[0] = a;
+        ((lwrb_dword_t*)d)[1] = b;
+    }
+    for (; len >= 4; len -= 4, d += 4, s += 4) {
+        *(lwrb_word_t*)d = *(const lwrb_word_t*)s;
+    }
+
+    /* Tail */
+    while (len-- > 0) {
+        *d++ = *s++;
+    }
+    return dst;
+}
+#endif /* LWRB_USE_WORD_COPY */
+
 /**
  * \brief           Initialize buffer handle to default values with size and buffer data array
  * \param[in]       buff: Buffer handle
@@ -367,7 +422,7 @@ lwrb_get_linear_block_read_length(LWRB_VOLATILE lwrb_t* buff) {
  */
 size_t
 lwrb_skip(LWRB_VOLATILE lwrb_t* buff, size_t len) {
-    size_t full;
+    size_t full, r;
 
     if (!BUF_IS_VALID(buff) || len == 0) {
         return 0;
@@ -375,10 +430,11 @@ lwrb_skip(LWRB_VOLATILE lwrb_t* buff, size_t len) {
 
     full = lwrb_get_full(buff);
     len = BUF_MIN(len, full);
-    buff->r += len;
-    if (buff->r >= buff->size) {
-        buff->r -= buff->size;
+    r = buff->r + len;
+    if (r >= buff->size) {
+        r -= buff->size;
     }
+    buff->r = r;                                /* Single store: the writer never sees an out-of-range pointer */
     BUF_SEND_EVT(buff, LWRB_EVT_READ, len);
     return len;
 }
@@ -445,7 +501,7 @@ lwrb_get_linear_block_write_length(LWRB_VOLATILE lwrb_t* buff) {
  */
 size_t
 lwrb_advance(LWRB_VOLATILE lwrb_t* buff, size_t len) {
-    size_t free;
+    size_t free, w;
 
     if (!BUF_IS_VALID(buff) || len == 0) {
         return 0;
@@ -453,10 +509,66 @@ lwrb_advance(LWRB_VOLATILE lwrb_t* buff, size_t len) {
 
     free = lwrb_get_free(buff);
     len = BUF_MIN(len, free);
-    buff->w += len;
-    if (buff->w >= buff->size) {
-        buff->w -= buff->size;
+    w = buff->w + len;
+    if (w >= buff->size) {
+        w -= buff->size;
     }
+    buff->w = w;                                /* Single store: the reader never sees an out-of-range pointer */
     BUF_SEND_EVT(buff, LWRB_EVT_WRITE, len);
     return len;
 }
+
+/**
+ * \brief           Reserve write space to fill in place.
+ * Hands out up to `btw` bytes of free space starting at the write pointer,
+ * split in two spans when it wraps past the end of the buffer. Nothing is
+ * visible to the reader until \ref lwrb_commit is called.
+ *
+ * \note            Single producer only: the reservation itself is not recorded,
+ *                      so another writer would be handed the same space
+ * \param[in]       buff: Buffer handle
+ * \param[in]       btw: Number of bytes wanted
+ * \param[out]      span: Reserved spans, filled in order
+ * \return          Number of bytes reserved, less than `btw` when the buffer is short of space
+ */
+size_t
+lwrb_reserve(LWRB_VOLATILE lwrb_t* buff, size_t btw, lwrb_span_t* span) {
+    size_t w, first;
+
+    if (span == NULL) {
+        return 0;
+    }
+    span->len[0] = span->len[1] = 0;
+    span->data[0] = span->data[1] = NULL;
+    if (!BUF_IS_VALID(buff) || btw == 0) {
+        return 0;
+    }
+
+    btw = BUF_MIN(btw, lwrb_get_free(buff));
+    if (btw == 0) {
+        return 0;
+    }
+
+    w = buff->w;
+    first = BUF_MIN(buff->size - w, btw);
+    span->data[0] = &buff->buff[w];
+    span->len[0] = first;
+    if (btw > first) {
+        span->data[1] = buff->buff;
+        span->len[1] = btw - first;
+    }
+    return btw;
+}
+
+/**
+ * \brief           Publish bytes written into space from \ref lwrb_reserve.
+ * `len` may be less than was reserved; the rest stays free
+ *
+ * \param[in]       buff: Buffer handle
+ * \param[in]       len: Number of bytes written, counted from the first span
+ * \return          Number of bytes committed
+ */
+size_t
+lwrb_commit(LWRB_VOLATILE lwrb_t* buff, size_t len) {
+    return lwrb_advance(buff, len);
+}
@@ -0,0 +1,255 @@
+/**
+ * \file            lwrb_mq.c
+ * \brief           Framed message queue on top of LwRB
+ */
+
+#include "lwrb_mq.h"
+
+/**
+ * \brief           Describe `len` bytes at ring offset `pos` as up to two spans
+ */
+static void
+prv_spans(lwrb_t* rb, size_t pos, size_t len, lwrb_span_t* span) {
+    size_t first;
+
+    if (pos >= rb->size) {
+        pos -= rb->size;
+    }
+    first = rb->size - pos;
+    if (first > len) {
+        first = len;
+    }
+    span->data[0] = &rb->buff[pos];
+    span->len[0] = first;
+    span->data[1] = (len > first) ? rb->buff : NULL;
+    span->len[1] = len - first;
+}
+
+/**
+ * \brief           Read the length prefix of the record `off` bytes past the read pointer
+ * \return          Record payload length, `0` if there is no record at `off`
+ */
+static size_t
+prv_record_len(lwrb_t* rb, size_t off, size_t full) {
+    uint8_t hdr[LWRB_MQ_HDR_SIZE];
+    size_t len;
+
+    if (off + LWRB_MQ_HDR_SIZE > full
+        || lwrb_peek(rb, off, hdr, sizeof(hdr)) != sizeof(hdr)) {
+        return 0;
+    }
+    len = (size_t)hdr[0] | ((size_t)hdr[1] << 8);
+    return (off + LWRB_MQ_HDR_SIZE + len <= full) ? len : 0;
+}
+
+/**
+ * \brief           Initialize the queue on `buffdata`
+ * \param[in]       mq: Queue handle
+ * \param[in]       buffdata: Ring memory
+ * \param[in]       size: Size of `buffdata`; every record takes its length plus \ref LWRB_MQ_HDR_SIZE
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+lwrb_mq_init(lwrb_mq_t* mq, void* buffdata, size_t size) {
+    if (mq == NULL) {
+        return 0;
+    }
+    mq->dropped = 0;
+    return lwrb_init(&mq->rb, buffdata, size);
+}
+
+/**
+ * \brief           Drop every queued record. Not safe against a concurrent producer
+ * \param[in]       mq: Queue handle
+ */
+void
+lwrb_mq_reset(lwrb_mq_t* mq) {
+    lwrb_reset(&mq->rb);
+}
+
+/**
+ * \brief           Reserve room for one record of up to `len` bytes.
+ * The payload is written in place into `span`, then published with
+ * \ref lwrb_mq_commit. Nothing is visible to the consumer before that
+ *
+ * \param[in]       mq: Queue handle
+ * \param[in]       len: Maximum payload length
+ * \param[out]      span: Payload space
+ * \return          `len` on success, `0` when the record does not fit (counted as dropped)
+ */
+size_t
+lwrb_mq_reserve(lwrb_mq_t* mq, size_t len, lwrb_span_t* span) {
+    span->data[0] = span->data[1] = NULL;
+    span->len[0] = span->len[1] = 0;
+    if (len == 0 || len > LWRB_MQ_MAX_LEN) {
+        return 0;
+    }
+    if (lwrb_get_free(&mq->rb) < LWRB_MQ_HDR_SIZE + len) {
+        mq->dropped++;
+        return 0;
+    }
+    prv_spans(&mq->rb, mq->rb.w + LWRB_MQ_HDR_SIZE, len, span);
+    return len;
+}
+
+/**
+ * \brief           Publish the record written into the last reservation
+ * \param[in]       mq: Queue handle
+ * \param[in]       len: Payload bytes written, at most what was reserved
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+lwrb_mq_commit(lwrb_mq_t* mq, size_t len) {
+    lwrb_span_t hdr;
+
+    if (len == 0 || len > LWRB_MQ_MAX_LEN || lwrb_get_free(&mq->rb) < LWRB_MQ_HDR_SIZE + len) {
+        return 0;
+    }
+
+    /* Length prefix last, then one pointer update makes the whole record visible */
+    prv_spans(&mq->rb, mq->rb.w, LWRB_MQ_HDR_SIZE, &hdr);
+    hdr.data[0][0] = (uint8_t)len;
+    if (hdr.len[0] > 1) {
+        hdr.data[0][1] = (uint8_t)(len >> 8);
+    } else {
+        hdr.data[1][0] = (uint8_t)(len >> 8);
+    }
+    return lwrb_advance(&mq->rb, LWRB_MQ_HDR_SIZE + len) == LWRB_MQ_HDR_SIZE + len;
+}
+
+/**
+ * \brief           Queue one record
+ * \param[in]       mq: Queue handle
+ * \param[in]       data: Payload
+ * \param[in]       len: Payload length, `1` to \ref LWRB_MQ_MAX_LEN
+ * \return          `1` if queued, `0` if it did not fit (counted as dropped) or `len` is out of range
+ */
+uint8_t
+lwrb_mq_put(lwrb_mq_t* mq, const void* data, size_t len) {
+    lwrb_span_t span;
+
+    if (lwrb_mq_reserve(mq, len, &span) == 0) {
+        return 0;
+    }
+    memcpy(span.data[0], data, span.len[0]);
+    if (span.len[1] > 0) {
+        memcpy(span.data[1], (const uint8_t*)data + span.len[0], span.len[1]);
+    }
+    return lwrb_mq_commit(mq, len);
+}
+
+/**
+ * \brief           Look at a queued record without copying or removing it
+ * \param[in]       mq: Queue handle
+ * \param[in]       index: Record to look at, `0` being the oldest
+ * \param[out]      span: Record payload, valid until the record is released
+ * \return          Payload length, `0` if there is no such record
+ */
+size_t
+lwrb_mq_peek(lwrb_mq_t* mq, size_t index, lwrb_span_t* span) {
+    size_t full = lwrb_get_full(&mq->rb);
+    size_t off = 0, len;
+
+    for (;;) {
+        len = prv_record_len(&mq->rb, off, full);
+        if (len == 0 || index-- == 0) {
+            break;
+        }
+        off += LWRB_MQ_HDR_SIZE + len;
+    }
+    if (len == 0) {
+        span->len[0] = span->len[1] = 0;
+        return 0;
+    }
+    prv_spans(&mq->rb, mq->rb.r + off + LWRB_MQ_HDR_SIZE, len, span);
+    return len;
+}
+
+/**
+ * \brief           Look at up to `max_count` of the oldest records in one pass.
+ * Follow with \ref lwrb_mq_release to remove them
+ *
+ * \param[in]       mq: Queue handle
+ * \param[out]      spans: One entry per record
+ * \param[in]       max_count: Size of `spans`
+ * \return          Number of records filled in
+ */
+size_t
+lwrb_mq_peek_batch(lwrb_mq_t* mq, lwrb_span_t* spans, size_t max_count) {
+    size_t full = lwrb_get_full(&mq->rb);
+    size_t off = 0, len, count;
+
+    for (count = 0; count < max_count; count++) {
+        len = prv_record_len(&mq->rb, off, full);
+        if (len == 0) {
+            break;
+        }
+        prv_spans(&mq->rb, mq->rb.r + off + LWRB_MQ_HDR_SIZE, len, &spans[count]);
+        off += LWRB_MQ_HDR_SIZE + len;
+    }
+    return count;
+}
+
+/**
+ * \brief           Remove the `count` oldest records
+ * \param[in]       mq: Queue handle
+ * \param[in]       count: Number of records to remove
+ * \return          Number of records removed
+ */
+size_t
+lwrb_mq_release(lwrb_mq_t* mq, size_t count) {
+    size_t full = lwrb_get_full(&mq->rb);
+    size_t off = 0, len, done;
+
+    for (done = 0; done < count; done++) {
+        len = prv_record_len(&mq->rb, off, full);
+        if (len == 0) {
+            break;
+        }
+        off += LWRB_MQ_HDR_SIZE + len;
+    }
+    lwrb_skip(&mq->rb, off);
+    return done;
+}
+
+/**
+ * \brief           Copy out and remove the oldest record
+ * \param[in]       mq: Queue handle
+ * \param[out]      data: Output buffer
+ * \param[in]       max_len: Size of `data`; a longer record is truncated, but still removed
+ * \return          Bytes copied, `0` if the queue is empty
+ */
+size_t
+lwrb_mq_get(lwrb_mq_t* mq, void* data, size_t max_len) {
+    lwrb_span_t span;
+    size_t len, n;
+
+    if (lwrb_mq_peek(mq, 0, &span) == 0) {
+        return 0;
+    }
+    len = 0;
+    for (int i = 0; i < 2 && len < max_len; i++) {
+        n = (span.len[i] < max_len - len) ? span.len[i] : (max_len - len);
+        memcpy((uint8_t*)data + len, span.data[i], n);
+        len += n;
+    }
+    lwrb_mq_release(mq, 1);
+    return len;
+}
+
+/**
+ * \brief           Number of records waiting
+ * \param[in]       mq: Queue handle
+ * \return          Record count
+ */
+size_t
+lwrb_mq_count(lwrb_mq_t* mq) {
+    size_t full = lwrb_get_full(&mq->rb);
+    size_t off = 0, len, count = 0;
+
+    while ((len = prv_record_len(&mq->rb, off, full)) != 0) {
+        off += LWRB_MQ_HDR_SIZE + len;
+        count++;
+    }
+    return count;
+}
@@ -0,0 +1,331 @@
+/**
+ * \file            lwrb_mr.c
+ * \brief           Multi-reader ring buffer
+ */
+
+#include "lwrb_mr.h"
+#include <stddef.h>
+
+#define BUF_IS_VALID(b)                 ((b) != NULL && (b)->buff != NULL && (b)->size > 0)
+#define BUF_MIN(x, y)                   ((x) < (y) ? (x) : (y))
+#define BUF_INDEX(b, pos)               ((pos) & ((b)->size - 1))
+
+/**
+ * \brief           Move a lossy reader up to the oldest byte still in the buffer
+ * \param[in]       buff: Buffer handle
+ * \param[in]       reader: Reader cursor
+ * \param[in]       w: Write position to measure against
+ * \return          Read position to continue from
+ */
+static size_t
+prv_catch_up(lwrb_mr_t* buff, lwrb_mr_reader_t* reader, size_t w) {
+    size_t r = reader->r;
+
+    if (reader->lossy && w - r > buff->size) {
+        reader->lost += w - r - buff->size;
+        r = w - buff->size;
+        reader->r = r;
+    }
+    return r;
+}
+
+/**
+ * \brief           Free space left by the slowest non-lossy reader, measured from `w`
+ * \param[in]       buff: Buffer handle
+ * \param[in]       w: Write position, claimed or published
+ * \return          Number of bytes that can be claimed
+ */
+static size_t
+prv_get_free(lwrb_mr_t* buff, size_t w) {
+    size_t used = 0;
+    lwrb_mr_reader_t* reader;
+
+    for (size_t i = 0; i < LWRB_MR_MAX_READERS; ++i) {
+        reader = buff->readers[i];
+        if (reader != NULL && !reader->lossy && w - reader->r > used) {
+            used = w - reader->r;
+        }
+    }
+    return buff->size - used;
+}
+
+/**
+ * \brief           Initialize buffer
+ * \param[in]       buff: Buffer handle
+ * \param[in]       buffdata: Buffer memory
+ * \param[in]       size: Size of `buffdata`, a power of two
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+lwrb_mr_init(lwrb_mr_t* buff, void* buffdata, size_t size) {
+    if (buff == NULL || buffdata == NULL || size == 0 || (size & (size - 1)) != 0) {
+        return 0;
+    }
+    memset(buff, 0, sizeof(*buff));
+    buff->buff = buffdata;
+    buff->size = size;
+    return 1;
+}
+
+/**
+ * \brief           Attach a reader. It starts at the current write position
+ * \note            Call from the writer's context, or while the writer is idle
+ * \param[in]       buff: Buffer handle
+ * \param[in]       reader: Reader cursor
+ * \param[in]       lossy: `1` to skip ahead when overrun instead of stalling the writer
+ * \return          `1` on success, `0` when every reader slot is taken
+ */
+uint8_t
+lwrb_mr_attach(lwrb_mr_t* buff, lwrb_mr_reader_t* reader, uint8_t lossy) {
+    if (!BUF_IS_VALID(buff) || reader == NULL) {
+        return 0;
+    }
+    for (size_t i = 0; i < LWRB_MR_MAX_READERS; ++i) {
+        if (buff->readers[i] == NULL) {
+            reader->r = buff->w;
+            reader->lossy = lossy;
+            reader->lost = 0;
+            buff->readers[i] = reader;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Detach a reader; the writer stops waiting for it
+ * \param[in]       buff: Buffer handle
+ * \param[in]       reader: Reader cursor
+ */
+void
+lwrb_mr_detach(lwrb_mr_t* buff, lwrb_mr_reader_t* reader) {
+    for (size_t i = 0; i < LWRB_MR_MAX_READERS; ++i) {
+        if (buff->readers[i] == reader) {
+            buff->readers[i] = NULL;
+        }
+    }
+}
+
+/**
+ * \brief           Free space for writers: what the slowest non-lossy reader leaves
+ * \param[in]       buff: Buffer handle
+ * \return          Number of bytes that can be written
+ */
+size_t
+lwrb_mr_get_free(lwrb_mr_t* buff) {
+    if (!BUF_IS_VALID(buff)) {
+        return 0;
+    }
+    return prv_get_free(buff, buff->w_claim);
+}
+
+/**
+ * \brief           Claim space for a write. Readers see none of it until
+ *                  \ref lwrb_mr_commit is called for the claimed length
+ *
+ * Safe against other writers in any context. A writer preempted between its
+ * claim and its commit holds back the data of writers that claimed after it,
+ * but never loses it.
+ *
+ * \param[in]       buff: Buffer handle
+ * \param[in]       btw: Number of bytes wanted
+ * \param[in]       min: Fewest bytes worth claiming when short of space
+ * \param[out]      span: Claimed spans, split in two when they wrap
+ * \return          Number of bytes claimed: `btw`, at least `min` when short of space, or `0`
+ */
+size_t
+lwrb_mr_claim(lwrb_mr_t* buff, size_t btw, size_t min, lwrb_span_t* span) {
+    size_t w, idx, free, len;
+
+    if (span == NULL) {
+        return 0;
+    }
+    span->len[0] = span->len[1] = 0;
+    span->data[0] = span->data[1] = NULL;
+    if (!BUF_IS_VALID(buff) || btw == 0) {
+        return 0;
+    }
+
+    w = __atomic_load_n(&buff->w_claim, __ATOMIC_RELAXED);
+    do {
+        free = prv_get_free(buff, w);
+        len = btw;
+        if (len > free) {
+            if (free == 0 || free < min) {
+                return 0;
+            }
+            len = free;
+        }
+    } while (!__atomic_compare_exchange_n(&buff->w_claim, &w, w + len, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+    idx = BUF_INDEX(buff, w);
+    span->data[0] = &buff->buff[idx];
+    span->len[0] = BUF_MIN(buff->size - idx, len);
+    if (len > span->len[0]) {
+        span->data[1] = buff->buff;
+        span->len[1] = len - span->len[0];
+    }
+    return len;
+}
+
+/**
+ * \brief           Commit a span filled after \ref lwrb_mr_claim
+ * \param[in]       buff: Buffer handle
+ * \param[in]       len: Length returned by the claim
+ */
+void
+lwrb_mr_commit(lwrb_mr_t* buff, size_t len) {
+    size_t done, w;
+
+    if (!BUF_IS_VALID(buff) || len == 0) {
+        return;
+    }
+
+    /* Only the commit that completes every claimed span may publish */
+    done = __atomic_add_fetch(&buff->w_done, len, __ATOMIC_ACQ_REL);
+    if (done != __atomic_load_n(&buff->w_claim, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+
+    /* A writer preempted here may find a later count already published; never move back */
+    w = __atomic_load_n(&buff->w, __ATOMIC_RELAXED);
+    while ((ptrdiff_t)(done - w) > 0
+           && !__atomic_compare_exchange_n(&buff->w, &w, done, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+    }
+}
+
+/**
+ * \brief           Write data for every attached reader
+ * \param[in]       buff: Buffer handle
+ * \param[in]       data: Data to write
+ * \param[in]       btw: Number of bytes to write
+ * \return          Number of bytes written, less than `btw` when a non-lossy reader is behind
+ */
+size_t
+lwrb_mr_write(lwrb_mr_t* buff, const void* data, size_t btw) {
+    lwrb_span_t span;
+    const uint8_t* d = data;
+
+    if (data == NULL) {
+        return 0;
+    }
+    btw = lwrb_mr_claim(buff, btw, 1, &span);
+    if (btw == 0) {
+        return 0;
+    }
+    memcpy(span.data[0], d, span.len[0]);
+    if (span.len[1] > 0) {
+        memcpy(span.data[1], &d[span.len[0]], span.len[1]);
+    }
+    lwrb_mr_commit(buff, btw);
+    return btw;
+}
+
+/**
+ * \brief           Number of bytes waiting for a reader
+ * \param[in]       buff: Buffer handle
+ * \param[in]       reader: Reader cursor
+ * \return          Bytes available; a lossy reader that was overrun is moved ahead first
+ */
+size_t
+lwrb_mr_get_full(lwrb_mr_t* buff, lwrb_mr_reader_t* reader) {
+    size_t w;
+
+    if (!BUF_IS_VALID(buff) || reader == NULL) {
+        return 0;
+    }
+    w = buff->w;
+    return w - prv_catch_up(buff, reader, w);
+}
+
+/**
+ * \brief           Copy data out for one reader
+ * \param[in]       buff: Buffer handle
+ * \param[in]       reader: Reader cursor
+ * \param[out]      data: Output memory
+ * \param[in]       btr: Number of bytes to read
+ * \return          Number of bytes read
+ */
+size_t
+lwrb_mr_read(lwrb_mr_t* buff, lwrb_mr_reader_t* reader, void* data, size_t btr) {
+    size_t w, r, idx, tocopy, n;
+    uint8_t* d = data;
+
+    if (!BUF_IS_VALID(buff) || reader == NULL || data == NULL || btr == 0) {
+        return 0;
+    }
+
+    for (;;) {
+        w = buff->w;
+        r = prv_catch_up(buff, reader, w);
+        n = BUF_MIN(btr, w - r);
+        if (n == 0) {
+            return 0;
+        }
+
+        idx = BUF_INDEX(buff, r);
+        tocopy = BUF_MIN(buff->size - idx, n);
+        memcpy(d, &buff->buff[idx], tocopy);
+        if (n > tocopy) {
+            memcpy(&d[tocopy], buff->buff, n - tocopy);
+        }
+        if (!reader->lossy) {
+            break;
+        }
+
+        /* The writer may have lapped a lossy reader during the copy; start over if so */
+        LWRB_MR_BARRIER();
+        if (buff->w_claim - r <= buff->size) {
+            break;
+        }
+    }
+    reader->r = r + n;
+    return n;
+}
+
+/**
+ * \brief           Start of the data waiting for a reader, for zero-copy access
+ * \note            A lossy reader may be overwritten while it works on the block in place
+ * \param[in]       buff: Buffer handle
+ * \param[in]       reader: Reader cursor
+ * \return          Linear block start address
+ */
+void*
+lwrb_mr_get_linear_block_read_address(lwrb_mr_t* buff, lwrb_mr_reader_t* reader) {
+    if (!BUF_IS_VALID(buff) || reader == NULL) {
+        return NULL;
+    }
+    return &buff->buff[BUF_INDEX(buff, reader->r)];
+}
+
+/**
+ * \brief           Length of the data waiting for a reader before the buffer wraps
+ * \param[in]       buff: Buffer handle
+ * \param[in]       reader: Reader cursor
+ * \return          Linear block length in units of bytes
+ */
+size_t
+lwrb_mr_get_linear_block_read_length(lwrb_mr_t* buff, lwrb_mr_reader_t* reader) {
+    size_t full = lwrb_mr_get_full(buff, reader);
+
+    if (full == 0) {
+        return 0;
+    }
+    return BUF_MIN(full, buff->size - BUF_INDEX(buff, reader->r));
+}
+
+/**
+ * \brief           Mark data as read for one reader
+ * \param[in]       buff: Buffer handle
+ * \param[in]       reader: Reader cursor
+ * \param[in]       len: Number of bytes to skip
+ * \return          Number of bytes skipped
+ */
+size_t
+lwrb_mr_skip(lwrb_mr_t* buff, lwrb_mr_reader_t* reader, size_t len) {
+    len = BUF_MIN(len, lwrb_mr_get_full(buff, reader));
+    if (len > 0) {
+        reader->r += len;
+    }
+    return len;
+}
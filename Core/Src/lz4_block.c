@@ -0,0 +1,86 @@
+/*
+ * lz4_block.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Minimal LZ4 block format decoder. Every length and offset is bounds
+ *  checked, so a corrupt image fails with -1 instead of writing past dst.
+ */
+
+#include "lz4_block.h"
+
+#define LZ4_MIN_MATCH 4
+
+static int lz4_read_len(const uint8_t **ip, const uint8_t *iend, size_t *len) {
+    uint8_t b;
+
+    do {
+        if (*ip >= iend) {
+            return -1;
+        }
+        b = *(*ip)++;
+        *len += b;
+    } while (b == 255);
+
+    return 0;
+}
+
+/**
+ * Decode one LZ4 block.
+ * Returns the number of bytes written to dst, or -1 if the block is malformed
+ * or does not fit into dst_cap bytes.
+ */
+int lz4_block_decompress(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_cap) {
+    const uint8_t *ip = src;
+    const uint8_t *iend = src + src_len;
+    uint8_t *op = dst;
+    uint8_t *oend = dst + dst_cap;
+
+    while (ip < iend) {
+        uint8_t token = *ip++;
+        size_t lit_len = token >> 4;
+        size_t match_len = token & 0x0F;
+        size_t offset;
+
+        // Literals
+        if (lit_len == 15 && lz4_read_len(&ip, iend, &lit_len) != 0) {
+            return -1;
+        }
+        if (lit_len > (size_t)(iend - ip) || lit_len > (size_t)(oend - op)) {
+            return -1;
+        }
+        for (size_t i = 0; i < lit_len; i++) {
+            *op++ = *ip++;
+        }
+
+        // The last sequence carries literals only
+        if (ip == iend) {
+            break;
+        }
+
+        // Match
+        if (iend - ip < 2) {
+            return -1;
+        }
+        offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op - dst)) {
+            return -1;
+        }
+        if (match_len == 15 && lz4_read_len(&ip, iend, &match_len) != 0) {
+            return -1;
+        }
+        match_len += LZ4_MIN_MATCH;
+        if (match_len > (size_t)(oend - op)) {
+            return -1;
+        }
+
+        // Byte copy: matches may overlap their own output (runs)
+        const uint8_t *match = op - offset;
+        for (size_t i = 0; i < match_len; i++) {
+            *op++ = *match++;
+        }
+    }
+
+    return (int)(op - dst);
+}
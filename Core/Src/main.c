@@ -25,6 +25,10 @@
 #include "crosslink.h"
 #include "ICM20948.h"
 #include "usb_device.h"
+#include "usbd_cdc_if.h"
+#include "bitstore.h"
+#include "utils.h"
+#include "console.h"
 
 #include <stdio.h>
 
@@ -50,6 +54,8 @@
 CRC_HandleTypeDef hcrc;
 
 I2C_HandleTypeDef hi2c1;
+DMA_HandleTypeDef hdma_i2c1_tx;
+DMA_HandleTypeDef hdma_i2c1_rx;
 
 TIM_HandleTypeDef htim12;
 
@@ -58,7 +64,9 @@ DMA_HandleTypeDef hdma_usart3_rx;
 DMA_HandleTypeDef hdma_usart3_tx;
 
 /* USER CODE BEGIN PV */
-__attribute__((section(".RAM_D1"))) uint8_t bitstream_buffer[MAX_BITSTREAM_SIZE]; // 160KB buffer
+MDMA_HandleTypeDef hmdma_crc;
+static volatile bool fpga_config_request = false;
+static ICM_FifoBatch imu_batch;
 
 /* USER CODE END PV */
 
@@ -124,7 +132,9 @@ int main(void)
 {
 
   /* USER CODE BEGIN 1 */
-
+  uint32_t led_tick = 0;
+  uint32_t upload_start = 0;
+  bool upload_active = false;
   /* USER CODE END 1 */
 
   /* MPU Configuration--------------------------------------------------------*/
@@ -155,7 +165,12 @@ int main(void)
   MX_TIM12_Init();
   /* USER CODE BEGIN 2 */
 
+  util_cycles_init();
   init_dma_logging();
+  if (console_init() != HAL_OK)
+  {
+    printf("Console receive failed to start\r\n");
+  }
 
   printf("\033c");
   printf("DUVITECH LLC\r\n");
@@ -173,6 +188,7 @@ int main(void)
 		printf("IMU detected\r\n");
 	    HAL_Delay(100);
 	    ICM_DumpRegisters();
+	    ICM_StartSampling();
 	}
   }
   else
@@ -180,6 +196,8 @@ int main(void)
     printf("IMU NOT detected\r\n\n");
   }
 
+  bitstore_init();
+
   MX_USB_DEVICE_Init();
 
   /* USER CODE END 2 */
@@ -200,8 +218,51 @@ int main(void)
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
-	HAL_Delay(250);
-	BSP_LED_Toggle(LED_BLUE);
+	if (fpga_config_request && !fpga_configure_busy())
+	{
+		fpga_config_request = false;
+		/* First stored slot if any, otherwise the built-in image */
+		fpga_source_t *src = NULL;
+		for (uint32_t slot = 0; slot < BITSTORE_NUM_SLOTS && src == NULL; slot++)
+		{
+			src = bitstore_source(slot);
+		}
+		fpga_configure_start(src);
+	}
+
+	/* Bitstream uploaded over USB CDC, programmed while it streams in */
+	fpga_source_t *upload = CDC_Upload_Request();
+	if (upload != NULL)
+	{
+		if (fpga_configure_start(upload) == HAL_OK)
+		{
+			upload_start = HAL_GetTick();
+			upload_active = true;
+		}
+		else
+		{
+			CDC_Upload_Complete(-1, 0);
+		}
+	}
+
+	console_process();
+
+	/* IMU FIFO batches (console "imu fifo <frames>"); frames are counted in the sampling stats */
+	ICM_FifoProcess(&imu_batch);
+
+	fpga_configure_process();
+
+	if (upload_active && !fpga_configure_busy())
+	{
+		upload_active = false;
+		CDC_Upload_Complete((fpga_configure_state() == FPGA_CFG_DONE) ? 0 : -1, HAL_GetTick() - upload_start);
+	}
+
+	if (HAL_GetTick() - led_tick >= 250)
+	{
+		led_tick = HAL_GetTick();
+		BSP_LED_Toggle(LED_BLUE);
+	}
   }
   /* USER CODE END 3 */
 }
@@ -291,6 +352,17 @@ static void MX_CRC_Init(void)
   }
   /* USER CODE BEGIN CRC_Init 2 */
 
+  /* CRC16-CCITT (poly 0x1021, init 0xFFFF) to match util_crc16 and the bitstream images */
+  hcrc.Init.DefaultPolynomialUse = DEFAULT_POLYNOMIAL_DISABLE;
+  hcrc.Init.GeneratingPolynomial = 0x1021;
+  hcrc.Init.CRCLength = CRC_POLYLENGTH_16B;
+  hcrc.Init.DefaultInitValueUse = DEFAULT_INIT_VALUE_DISABLE;
+  hcrc.Init.InitValue = 0xFFFF;
+  if (HAL_CRC_Init(&hcrc) != HAL_OK)
+  {
+    Error_Handler();
+  }
+
   /* USER CODE END CRC_Init 2 */
 
 }
@@ -452,6 +524,12 @@ static void MX_DMA_Init(void)
   /* DMA1_Stream1_IRQn interrupt configuration */
   HAL_NVIC_SetPriority(DMA1_Stream1_IRQn, 0, 0);
   HAL_NVIC_EnableIRQ(DMA1_Stream1_IRQn);
+  /* DMA1_Stream2_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Stream2_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Stream2_IRQn);
+  /* DMA1_Stream3_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Stream3_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Stream3_IRQn);
 
 }
 
@@ -471,12 +549,19 @@ static void MX_GPIO_Init(void)
   __HAL_RCC_GPIOC_CLK_ENABLE();
   __HAL_RCC_GPIOH_CLK_ENABLE();
   __HAL_RCC_GPIOD_CLK_ENABLE();
+  __HAL_RCC_GPIOG_CLK_ENABLE();
   __HAL_RCC_GPIOA_CLK_ENABLE();
   __HAL_RCC_GPIOB_CLK_ENABLE();
 
   /*Configure GPIO pin Output Level */
   HAL_GPIO_WritePin(CRESET_GPIO_Port, CRESET_Pin, GPIO_PIN_RESET);
 
+  /*Configure GPIO pin : ICM_INT_Pin */
+  GPIO_InitStruct.Pin = ICM_INT_Pin;
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING;
+  GPIO_InitStruct.Pull = GPIO_PULLDOWN;
+  HAL_GPIO_Init(ICM_INT_GPIO_Port, &GPIO_InitStruct);
+
   /*Configure GPIO pin : CRESET_Pin */
   GPIO_InitStruct.Pin = CRESET_Pin;
   GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
@@ -484,12 +569,25 @@ static void MX_GPIO_Init(void)
   GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
   HAL_GPIO_Init(CRESET_GPIO_Port, &GPIO_InitStruct);
 
+  /* EXTI interrupt init*/
+  HAL_NVIC_SetPriority(EXTI3_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(EXTI3_IRQn);
+
   /* USER CODE BEGIN MX_GPIO_Init_2 */
 
   /* USER CODE END MX_GPIO_Init_2 */
 }
 
 /* USER CODE BEGIN 4 */
+void BSP_PB_Callback(Button_TypeDef Button)
+{
+  if (Button == BUTTON_USER)
+  {
+    /* Configuration runs from the main loop, not from the EXTI handler */
+    fpga_config_request = true;
+  }
+}
+
 void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
 {
   if (huart->Instance == USART3)
@@ -498,6 +596,31 @@ void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
   }
 }
 
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+  if (GPIO_Pin == ICM_INT_Pin)
+  {
+    ICM_EXTI_Callback();
+  }
+}
+
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+  if (huart->Instance == USART3)
+  {
+    console_UART_RxEventCallback(huart, Size);
+  }
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+  if (huart->Instance == USART3)
+  {
+    logging_UART_ErrorCallback(huart);
+    console_UART_ErrorCallback(huart);
+  }
+}
+
 /* USER CODE END 4 */
 
  /* MPU Configuration */
@@ -547,7 +670,11 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
     HAL_IncTick();
   }
   /* USER CODE BEGIN Callback 1 */
-
+  if (htim->Instance == TIM15 && (HAL_GetTick() % 1000U) == 0U)
+  {
+    /* Keep the 64-bit cycle counter current across CYCCNT wraps */
+    util_cycles();
+  }
   /* USER CODE END Callback 1 */
 }
 
@@ -23,6 +23,10 @@
 /* USER CODE BEGIN Includes */
 
 /* USER CODE END Includes */
+extern DMA_HandleTypeDef hdma_i2c1_tx;
+
+extern DMA_HandleTypeDef hdma_i2c1_rx;
+
 extern DMA_HandleTypeDef hdma_usart3_rx;
 
 extern DMA_HandleTypeDef hdma_usart3_tx;
@@ -44,6 +48,7 @@ extern DMA_HandleTypeDef hdma_usart3_tx;
 
 /* Private variables ---------------------------------------------------------*/
 /* USER CODE BEGIN PV */
+extern MDMA_HandleTypeDef hmdma_crc;
 
 /* USER CODE END PV */
 
@@ -96,6 +101,33 @@ void HAL_CRC_MspInit(CRC_HandleTypeDef* hcrc)
     __HAL_RCC_CRC_CLK_ENABLE();
     /* USER CODE BEGIN CRC_MspInit 1 */
 
+    /* MDMA channel feeding memory to the CRC data register */
+    __HAL_RCC_MDMA_CLK_ENABLE();
+
+    hmdma_crc.Instance = MDMA_Channel0;
+    hmdma_crc.Init.Request = MDMA_REQUEST_SW;
+    hmdma_crc.Init.TransferTriggerMode = MDMA_BLOCK_TRANSFER;
+    hmdma_crc.Init.Priority = MDMA_PRIORITY_HIGH;
+    hmdma_crc.Init.Endianness = MDMA_LITTLE_ENDIANNESS_PRESERVE;
+    hmdma_crc.Init.SourceInc = MDMA_SRC_INC_BYTE;
+    hmdma_crc.Init.DestinationInc = MDMA_DEST_INC_DISABLE;
+    hmdma_crc.Init.SourceDataSize = MDMA_SRC_DATASIZE_BYTE;
+    hmdma_crc.Init.DestDataSize = MDMA_DEST_DATASIZE_BYTE;
+    hmdma_crc.Init.DataAlignment = MDMA_DATAALIGN_PACKENABLE;
+    hmdma_crc.Init.BufferTransferLength = 128;
+    hmdma_crc.Init.SourceBurst = MDMA_SOURCE_BURST_SINGLE;
+    hmdma_crc.Init.DestBurst = MDMA_DEST_BURST_SINGLE;
+    hmdma_crc.Init.SourceBlockAddressOffset = 0;
+    hmdma_crc.Init.DestBlockAddressOffset = 0;
+    if (HAL_MDMA_Init(&hmdma_crc) != HAL_OK)
+    {
+      Error_Handler();
+    }
+
+    /* MDMA_IRQn interrupt configuration */
+    HAL_NVIC_SetPriority(MDMA_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(MDMA_IRQn);
+
     /* USER CODE END CRC_MspInit 1 */
 
   }
@@ -119,6 +151,9 @@ void HAL_CRC_MspDeInit(CRC_HandleTypeDef* hcrc)
     __HAL_RCC_CRC_CLK_DISABLE();
     /* USER CODE BEGIN CRC_MspDeInit 1 */
 
+    HAL_MDMA_DeInit(&hmdma_crc);
+    HAL_NVIC_DisableIRQ(MDMA_IRQn);
+
     /* USER CODE END CRC_MspDeInit 1 */
   }
 
@@ -163,6 +198,44 @@ void HAL_I2C_MspInit(I2C_HandleTypeDef* hi2c)
 
     /* Peripheral clock enable */
     __HAL_RCC_I2C1_CLK_ENABLE();
+
+    /* I2C1 DMA Init */
+    /* I2C1_TX Init */
+    hdma_i2c1_tx.Instance = DMA1_Stream2;
+    hdma_i2c1_tx.Init.Request = DMA_REQUEST_I2C1_TX;
+    hdma_i2c1_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_i2c1_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_i2c1_tx.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_i2c1_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma_i2c1_tx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    hdma_i2c1_tx.Init.Mode = DMA_NORMAL;
+    hdma_i2c1_tx.Init.Priority = DMA_PRIORITY_HIGH;
+    hdma_i2c1_tx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&hdma_i2c1_tx) != HAL_OK)
+    {
+      Error_Handler();
+    }
+
+    __HAL_LINKDMA(hi2c,hdmatx,hdma_i2c1_tx);
+
+    /* I2C1_RX Init */
+    hdma_i2c1_rx.Instance = DMA1_Stream3;
+    hdma_i2c1_rx.Init.Request = DMA_REQUEST_I2C1_RX;
+    hdma_i2c1_rx.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    hdma_i2c1_rx.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_i2c1_rx.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_i2c1_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma_i2c1_rx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    hdma_i2c1_rx.Init.Mode = DMA_NORMAL;
+    hdma_i2c1_rx.Init.Priority = DMA_PRIORITY_HIGH;
+    hdma_i2c1_rx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&hdma_i2c1_rx) != HAL_OK)
+    {
+      Error_Handler();
+    }
+
+    __HAL_LINKDMA(hi2c,hdmarx,hdma_i2c1_rx);
+
     /* I2C1 interrupt Init */
     HAL_NVIC_SetPriority(I2C1_EV_IRQn, 0, 0);
     HAL_NVIC_EnableIRQ(I2C1_EV_IRQn);
@@ -200,6 +273,10 @@ void HAL_I2C_MspDeInit(I2C_HandleTypeDef* hi2c)
 
     HAL_GPIO_DeInit(GPIOB, GPIO_PIN_9);
 
+    /* I2C1 DMA DeInit */
+    HAL_DMA_DeInit(hi2c->hdmatx);
+    HAL_DMA_DeInit(hi2c->hdmarx);
+
     /* I2C1 interrupt DeInit */
     HAL_NVIC_DisableIRQ(I2C1_EV_IRQn);
     HAL_NVIC_DisableIRQ(I2C1_ER_IRQn);
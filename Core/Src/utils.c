@@ -8,9 +8,8 @@
 
 
 #include "utils.h"
+#include "crc.h"
 #include <stdio.h>
-// testing crc calculations
-uint32_t startTime = 0, endTime = 0, duration = 0;
 
 // CRC16-ccitt lookup table
 const uint16_t crc16_tab[256] = {
@@ -56,10 +55,10 @@ void printBuffer(const uint8_t* buffer, uint32_t size) {
     printf("\r\n\r\n"); // Print a newline character to separate the output
 }
 
-uint16_t util_crc16(const uint8_t* buf, uint32_t size) {
+uint16_t util_crc16_bytewise(const uint8_t* buf, uint32_t size) {
 	uint16_t crc = 0xFFFF;
 
-	for (int i = 0; i < size; i++) {
+	for (uint32_t i = 0; i < size; i++) {
 		uint8_t byte = buf[i];
 		crc = (crc<<8) ^ crc16_tab[(crc>>8)^byte];
 	}
@@ -67,9 +66,123 @@ uint16_t util_crc16(const uint8_t* buf, uint32_t size) {
 	return crc;
 }
 
-uint16_t util_hw_crc16(uint8_t* buf, uint32_t size)
+/*
+ * Slicing-by-8 tables, built by the compiler: crc16_slice[k][b] is the CRC
+ * contribution of byte b followed by k zero bytes, i.e. b(x) * x^(16+8k)
+ * mod 0x1021. CRC16_X(n) is x^n mod 0x1021; each power is an enum
+ * constant so the chain is evaluated once, not expanded textually.
+ */
+#define CRC16_NEXT(c)	((((c) << 1) ^ (((c) & 0x8000) ? 0x1021 : 0)) & 0xFFFF)
+
+enum {
+	CRC16_X16 = 0x1021,
+	CRC16_X17 = CRC16_NEXT(CRC16_X16), CRC16_X18 = CRC16_NEXT(CRC16_X17), CRC16_X19 = CRC16_NEXT(CRC16_X18),
+	CRC16_X20 = CRC16_NEXT(CRC16_X19), CRC16_X21 = CRC16_NEXT(CRC16_X20), CRC16_X22 = CRC16_NEXT(CRC16_X21),
+	CRC16_X23 = CRC16_NEXT(CRC16_X22), CRC16_X24 = CRC16_NEXT(CRC16_X23), CRC16_X25 = CRC16_NEXT(CRC16_X24),
+	CRC16_X26 = CRC16_NEXT(CRC16_X25), CRC16_X27 = CRC16_NEXT(CRC16_X26), CRC16_X28 = CRC16_NEXT(CRC16_X27),
+	CRC16_X29 = CRC16_NEXT(CRC16_X28), CRC16_X30 = CRC16_NEXT(CRC16_X29), CRC16_X31 = CRC16_NEXT(CRC16_X30),
+	CRC16_X32 = CRC16_NEXT(CRC16_X31), CRC16_X33 = CRC16_NEXT(CRC16_X32), CRC16_X34 = CRC16_NEXT(CRC16_X33),
+	CRC16_X35 = CRC16_NEXT(CRC16_X34), CRC16_X36 = CRC16_NEXT(CRC16_X35), CRC16_X37 = CRC16_NEXT(CRC16_X36),
+	CRC16_X38 = CRC16_NEXT(CRC16_X37), CRC16_X39 = CRC16_NEXT(CRC16_X38), CRC16_X40 = CRC16_NEXT(CRC16_X39),
+	CRC16_X41 = CRC16_NEXT(CRC16_X40), CRC16_X42 = CRC16_NEXT(CRC16_X41), CRC16_X43 = CRC16_NEXT(CRC16_X42),
+	CRC16_X44 = CRC16_NEXT(CRC16_X43), CRC16_X45 = CRC16_NEXT(CRC16_X44), CRC16_X46 = CRC16_NEXT(CRC16_X45),
+	CRC16_X47 = CRC16_NEXT(CRC16_X46), CRC16_X48 = CRC16_NEXT(CRC16_X47), CRC16_X49 = CRC16_NEXT(CRC16_X48),
+	CRC16_X50 = CRC16_NEXT(CRC16_X49), CRC16_X51 = CRC16_NEXT(CRC16_X50), CRC16_X52 = CRC16_NEXT(CRC16_X51),
+	CRC16_X53 = CRC16_NEXT(CRC16_X52), CRC16_X54 = CRC16_NEXT(CRC16_X53), CRC16_X55 = CRC16_NEXT(CRC16_X54),
+	CRC16_X56 = CRC16_NEXT(CRC16_X55), CRC16_X57 = CRC16_NEXT(CRC16_X56), CRC16_X58 = CRC16_NEXT(CRC16_X57),
+	CRC16_X59 = CRC16_NEXT(CRC16_X58), CRC16_X60 = CRC16_NEXT(CRC16_X59), CRC16_X61 = CRC16_NEXT(CRC16_X60),
+	CRC16_X62 = CRC16_NEXT(CRC16_X61), CRC16_X63 = CRC16_NEXT(CRC16_X62), CRC16_X64 = CRC16_NEXT(CRC16_X63),
+	CRC16_X65 = CRC16_NEXT(CRC16_X64), CRC16_X66 = CRC16_NEXT(CRC16_X65), CRC16_X67 = CRC16_NEXT(CRC16_X66),
+	CRC16_X68 = CRC16_NEXT(CRC16_X67), CRC16_X69 = CRC16_NEXT(CRC16_X68), CRC16_X70 = CRC16_NEXT(CRC16_X69),
+	CRC16_X71 = CRC16_NEXT(CRC16_X70), CRC16_X72 = CRC16_NEXT(CRC16_X71), CRC16_X73 = CRC16_NEXT(CRC16_X72),
+	CRC16_X74 = CRC16_NEXT(CRC16_X73), CRC16_X75 = CRC16_NEXT(CRC16_X74), CRC16_X76 = CRC16_NEXT(CRC16_X75),
+	CRC16_X77 = CRC16_NEXT(CRC16_X76), CRC16_X78 = CRC16_NEXT(CRC16_X77), CRC16_X79 = CRC16_NEXT(CRC16_X78),
+};
+
+/* Entry for byte b in slice k: XOR of x^(16+8k+i) over the set bits i of b */
+#define CRC16_BIT(b, i, x)	((((b) >> (i)) & 1) ? (x) : 0)
+#define CRC16_E(b, x0, x1, x2, x3, x4, x5, x6, x7) \
+	(uint16_t)(CRC16_BIT(b, 0, x0) ^ CRC16_BIT(b, 1, x1) ^ CRC16_BIT(b, 2, x2) ^ CRC16_BIT(b, 3, x3) ^ \
+	           CRC16_BIT(b, 4, x4) ^ CRC16_BIT(b, 5, x5) ^ CRC16_BIT(b, 6, x6) ^ CRC16_BIT(b, 7, x7))
+#define CRC16_E4(b, ...)	CRC16_E((b), __VA_ARGS__), CRC16_E((b) + 1, __VA_ARGS__), \
+	CRC16_E((b) + 2, __VA_ARGS__), CRC16_E((b) + 3, __VA_ARGS__)
+#define CRC16_E16(b, ...)	CRC16_E4((b), __VA_ARGS__), CRC16_E4((b) + 4, __VA_ARGS__), \
+	CRC16_E4((b) + 8, __VA_ARGS__), CRC16_E4((b) + 12, __VA_ARGS__)
+#define CRC16_E64(b, ...)	CRC16_E16((b), __VA_ARGS__), CRC16_E16((b) + 16, __VA_ARGS__), \
+	CRC16_E16((b) + 32, __VA_ARGS__), CRC16_E16((b) + 48, __VA_ARGS__)
+#define CRC16_SLICE(...)	{ CRC16_E64(0, __VA_ARGS__), CRC16_E64(64, __VA_ARGS__), \
+	CRC16_E64(128, __VA_ARGS__), CRC16_E64(192, __VA_ARGS__) }
+
+static const uint16_t crc16_slice[8][256] = {
+	CRC16_SLICE(CRC16_X16, CRC16_X17, CRC16_X18, CRC16_X19, CRC16_X20, CRC16_X21, CRC16_X22, CRC16_X23),
+	CRC16_SLICE(CRC16_X24, CRC16_X25, CRC16_X26, CRC16_X27, CRC16_X28, CRC16_X29, CRC16_X30, CRC16_X31),
+	CRC16_SLICE(CRC16_X32, CRC16_X33, CRC16_X34, CRC16_X35, CRC16_X36, CRC16_X37, CRC16_X38, CRC16_X39),
+	CRC16_SLICE(CRC16_X40, CRC16_X41, CRC16_X42, CRC16_X43, CRC16_X44, CRC16_X45, CRC16_X46, CRC16_X47),
+	CRC16_SLICE(CRC16_X48, CRC16_X49, CRC16_X50, CRC16_X51, CRC16_X52, CRC16_X53, CRC16_X54, CRC16_X55),
+	CRC16_SLICE(CRC16_X56, CRC16_X57, CRC16_X58, CRC16_X59, CRC16_X60, CRC16_X61, CRC16_X62, CRC16_X63),
+	CRC16_SLICE(CRC16_X64, CRC16_X65, CRC16_X66, CRC16_X67, CRC16_X68, CRC16_X69, CRC16_X70, CRC16_X71),
+	CRC16_SLICE(CRC16_X72, CRC16_X73, CRC16_X74, CRC16_X75, CRC16_X76, CRC16_X77, CRC16_X78, CRC16_X79),
+};
+
+/* Continue a CRC16-CCITT over buf, eight bytes per step */
+uint16_t util_crc16_update(uint16_t crc, const uint8_t* buf, uint32_t size) {
+	while (size >= 8) {
+		crc = crc16_slice[7][buf[0] ^ (crc >> 8)] ^ crc16_slice[6][buf[1] ^ (crc & 0xFF)] ^
+		      crc16_slice[5][buf[2]] ^ crc16_slice[4][buf[3]] ^
+		      crc16_slice[3][buf[4]] ^ crc16_slice[2][buf[5]] ^
+		      crc16_slice[1][buf[6]] ^ crc16_slice[0][buf[7]];
+		buf += 8;
+		size -= 8;
+	}
+	while (size-- > 0) {
+		crc = (uint16_t)(crc << 8) ^ crc16_slice[0][(crc >> 8) ^ *buf++];
+	}
+
+	return crc;
+}
+
+uint16_t util_crc16(const uint8_t* buf, uint32_t size) {
+	return util_crc16_update(0xFFFF, buf, size);
+}
+
+/* Same result as util_crc16, on the CRC unit (or in software while it is claimed) */
+uint16_t util_hw_crc16(const uint8_t* buf, uint32_t size)
 {
-	uint32_t uwCRCValue = HAL_CRC_Accumulate(&hcrc, (uint32_t *)buf, size);
-	printf("uwCRCValue 0x%08lx\r\n", uwCRCValue);
-	return (uint16_t)uwCRCValue;
+	return (uint16_t)crc_compute(&crc16_ccitt_false, CRC_ENGINE_HW, buf, size);
+}
+
+/*
+ * 64-bit cycle counter from the DWT CYCCNT. The 32-bit counter wraps every
+ * ~8.9 s at 480 MHz, so util_cycles() must run at least that often; the
+ * HAL tick callback takes care of that.
+ */
+static uint32_t cycles_last;
+static uint32_t cycles_high;
+
+void util_cycles_init(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->LAR = 0xC5ACCE55;		/* Unlock the DWT on the Cortex-M7 */
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	cycles_last = 0;
+	cycles_high = 0;
+}
+
+uint64_t util_cycles(void)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint32_t now;
+	uint64_t cycles;
+
+	__disable_irq();
+	now = DWT->CYCCNT;
+	if (now < cycles_last) {
+		cycles_high++;
+	}
+	cycles_last = now;
+	cycles = ((uint64_t)cycles_high << 32) | now;
+	__set_PRIMASK(primask);
+
+	return cycles;
 }
@@ -0,0 +1,84 @@
+/*
+ * bench_crc16.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  CRC16 cost per byte from 16 B to a full 160 KB bitstream, three ways:
+ *  the byte-wise table, slicing-by-8 (util_crc16), and util_hw_crc16 on
+ *  the CRC unit. The two software paths are timed on the host: absolute
+ *  numbers say little about the Cortex-M7, the ratio is the point. The
+ *  hardware path runs on the stub CRC unit to check its result, but the
+ *  stub computes bit by bit, so its time is modelled from the unit's
+ *  datasheet rate instead: one byte per AHB clock plus a fixed cost for
+ *  claiming the unit and loading the polynomial.
+ */
+
+#include "hal_stub.h"
+#include "test.h"
+#include "utils.h"
+#include <time.h>
+
+TEST_DEFINE();
+
+#define BENCH_MAX_LEN           (160U * 1024)
+#define BENCH_BYTES             (16U * 1024 * 1024)     /* Per size and path */
+
+#define HCLK_HZ                 240000000.0             /* AHB clock feeding the CRC unit */
+#define CRC_HW_SETUP_CYCLES     120.0                   /* Claim, HAL_CRC_Init, release */
+
+static uint8_t data[BENCH_MAX_LEN];
+
+static const uint32_t sizes[] = { 16, 64, 256, 1024, 4096, 16384, 65536, BENCH_MAX_LEN };
+
+static double now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static double bench(uint16_t (*fn)(const uint8_t *, uint32_t), uint32_t len, uint16_t *crc) {
+    uint32_t rounds = BENCH_BYTES / len;
+    volatile uint16_t sink = 0;
+    double t0;
+
+    *crc = fn(data, len);
+    t0 = now_ns();
+    for (uint32_t i = 0; i < rounds; i++) {
+        sink ^= fn(data, len);
+    }
+    (void)sink;
+    return (now_ns() - t0) / ((double)rounds * len);
+}
+
+static double model_hw(uint32_t len) {
+    return (CRC_HW_SETUP_CYCLES + len) * 1e9 / HCLK_HZ / len;
+}
+
+int test_main(void) {
+    uint32_t seed = 7;
+    uint16_t crc_bytewise, crc_slicing, crc_hw;
+    double ns_bytewise, ns_slicing, ns_hw;
+
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)test_rand(&seed);
+    }
+
+    printf("%8s  %14s  %14s  %14s   (ns/byte)\n", "size", "byte-wise", "slicing-by-8", "CRC unit*");
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        uint32_t len = sizes[i];
+
+        ns_bytewise = bench(util_crc16_bytewise, len, &crc_bytewise);
+        ns_slicing = bench(util_crc16, len, &crc_slicing);
+        crc_hw = util_hw_crc16(data, len);
+        ns_hw = model_hw(len);
+        CHECK_EQ(crc_slicing, crc_bytewise);
+        CHECK_EQ(crc_hw, crc_bytewise);
+
+        printf("%8lu  %14.3f  %8.3f %4.2fx  %14.3f\n", (unsigned long)len, ns_bytewise,
+               ns_slicing, ns_bytewise / ns_slicing, ns_hw);
+    }
+    printf("* target time, modelled: %.0f MHz AHB, one byte per clock, %.0f cycles setup\n",
+           HCLK_HZ / 1e6, CRC_HW_SETUP_CYCLES);
+    return TEST_RESULT();
+}
@@ -0,0 +1,84 @@
+/*
+ * bench_crosslink.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  CrossLink configuration against the simulated LIF-MD6000 slave
+ *  (xlink_sim.c), with the device's busy times set per run. Each run
+ *  configures the built-in image through fpga_configure() and reports the total and
+ *  per-phase times and bytes per I2C interrupt, all in virtual time, so
+ *  loader changes can be compared without a board.
+ */
+
+#include "hal_stub.h"
+#include "test.h"
+#include "crosslink.h"
+#include "utils.h"
+#include "xlink_sim.h"
+#include <string.h>
+
+TEST_DEFINE();
+
+/* The built-in image, defined by crosslink.c from bitstream_lz4.h */
+extern const uint8_t bitstream_lz4[];
+
+static const xlink_config_t configs[] = {
+    { "400 kHz",            400000,  30,  2 },
+    { "1 MHz",             1000000,  30,  2 },
+    { "1 MHz, slow erase", 1000000, 400, 20 },
+};
+
+/* ---- Runs ---- */
+
+static void run(const xlink_config_t *cfg) {
+    const fpga_stream_stats_t *st;
+    hal_stub_i2c_stats_t i2c0, i2c1;
+    uint32_t total = 0, image_len;
+    uint16_t image_crc;
+    uint64_t t0;
+
+    memcpy(&image_len, &bitstream_lz4[4], sizeof(image_len));
+    memcpy(&image_crc, &bitstream_lz4[10], sizeof(image_crc));
+    xlink_sim_reset(cfg, image_len, image_crc);
+    hal_stub_i2c_get_stats(&i2c0);
+
+    t0 = hal_stub_now();
+    fpga_configure();
+    hal_stub_i2c_get_stats(&i2c1);
+    st = fpga_configure_stream_stats();
+
+    // The firmware prints the per-phase table; sum it up per run for comparison
+    for (int i = 0; i < FPGA_PHASE_COUNT; i++) {
+        total += fpga_configure_phase_ms(i);
+    }
+    printf("== %s (erase busy %lu ms, done busy %lu ms): %lu ms total, %lu ms erase, %lu ms program, "
+           "%.1f bytes/irq, %lu I2C transfers, %.1f ms virtual\n\n",
+           cfg->name, (unsigned long)cfg->erase_ms, (unsigned long)cfg->done_ms, (unsigned long)total,
+           (unsigned long)fpga_configure_phase_ms(FPGA_PHASE_ERASE),
+           (unsigned long)fpga_configure_phase_ms(FPGA_PHASE_PROGRAM),
+           st->irqs ? (double)st->bytes / st->irqs : 0.0,
+           (unsigned long)(i2c1.transfers - i2c0.transfers), (hal_stub_now() - t0) / 1e6);
+
+    CHECK_EQ(fpga_configure_state(), FPGA_CFG_DONE);
+    CHECK(xlink.image_ok);
+    CHECK(xlink.exited);
+    CHECK_EQ(xlink.image_len, xlink.image_want);
+    CHECK_EQ(st->bytes, xlink.image_want);
+    CHECK_EQ(i2c1.nacks, i2c0.nacks);
+    // Status polling ends each wait within a poll period of the device going ready
+    CHECK(fpga_configure_phase_ms(FPGA_PHASE_ERASE) >= cfg->erase_ms);
+    CHECK(fpga_configure_phase_ms(FPGA_PHASE_ERASE) <= cfg->erase_ms + 5);
+    CHECK(fpga_configure_phase_ms(FPGA_PHASE_VERIFY) <= cfg->done_ms + 5);
+    // The bitstream goes out by DMA, one interrupt per NBYTES reload
+    CHECK(st->irqs > 0 && st->bytes / st->irqs >= 200);
+}
+
+int test_main(void) {
+    util_cycles_init();
+    xlink_sim_attach();
+
+    for (size_t i = 0; i < sizeof(configs) / sizeof(configs[0]); i++) {
+        run(&configs[i]);
+    }
+    return TEST_RESULT();
+}
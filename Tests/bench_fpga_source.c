@@ -0,0 +1,117 @@
+/*
+ * bench_fpga_source.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Host throughput of the two bitstream sources on the same image: the
+ *  built-in XLZ4 image through fpga_source_init_lz4, and its decompressed
+ *  form through fpga_source_init_raw. Every chunk is read once, as the I2C
+ *  DMA would. Absolute numbers say little about the Cortex-M7; what matters
+ *  is how far each source stays ahead of the bus it feeds, and that the
+ *  compressed one does so from a fraction of the flash.
+ */
+
+#include "hal_stub.h"
+#include "test.h"
+#include "fpga_source.h"
+#include "utils.h"
+#include "bitstream_lz4.h"
+#include <string.h>
+#include <time.h>
+
+TEST_DEFINE();
+
+#define BENCH_ROUNDS    200
+#define I2C_KBPS        100.0           /* 1 MHz I2C, 9 clocks per byte, rounded down */
+
+static uint8_t raw[256 * 1024];
+
+static double now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* What the I2C DMA does with a chunk: read it */
+static uint32_t consume(const uint8_t *p, size_t len) {
+    uint32_t sum = 0;
+
+    for (size_t i = 0; i < len; i += 16) {
+        sum += p[i];
+    }
+    return sum + (uint32_t)len;
+}
+
+/* Bytes produced by one pass, or 0 on a source error */
+static size_t drain(fpga_source_t *src, uint32_t *sum, uint8_t *copy) {
+    const uint8_t *chunk;
+    size_t produced = 0;
+    int len;
+
+    while (produced < src->total) {
+        len = src->acquire(src, &chunk);
+        if (len <= 0) {
+            return 0;
+        }
+        if (copy != NULL) {
+            memcpy(&copy[produced], chunk, (size_t)len);
+        }
+        *sum += consume(chunk, (size_t)len);
+        produced += (size_t)len;
+        src->release(src);
+    }
+    return produced;
+}
+
+static double bench_lz4(size_t *total, uint32_t *sum) {
+    fpga_lz4_source_t src;
+    double t0 = now_ns();
+
+    *total = 0;
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        fpga_source_init_lz4(&src, bitstream_lz4, bitstream_lz4_SIZE);
+        *total += drain(&src.base, sum, NULL);
+    }
+    return now_ns() - t0;
+}
+
+static double bench_raw(size_t len, size_t *total, uint32_t *sum) {
+    fpga_raw_source_t src;
+    double t0 = now_ns();
+
+    *total = 0;
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        fpga_source_init_raw(&src, raw, len);
+        *total += drain(&src.base, sum, NULL);
+    }
+    return now_ns() - t0;
+}
+
+int test_main(void) {
+    static fpga_lz4_source_t lz4;
+    uint32_t sum_lz4 = 0, sum_raw = 0, sum = 0;
+    size_t len, total_lz4, total_raw;
+    double ns_lz4, ns_raw, mbs_lz4, mbs_raw;
+
+    // The raw image is the compressed one decoded once
+    CHECK_EQ(fpga_source_init_lz4(&lz4, bitstream_lz4, bitstream_lz4_SIZE), 0);
+    len = drain(&lz4.base, &sum, raw);
+    CHECK_EQ(len, lz4.base.total);
+    CHECK_EQ(util_crc16(raw, (uint32_t)len), lz4.base.crc16);
+
+    ns_lz4 = bench_lz4(&total_lz4, &sum_lz4);
+    ns_raw = bench_raw(len, &total_raw, &sum_raw);
+    CHECK_EQ(total_lz4, (size_t)BENCH_ROUNDS * len);
+    CHECK_EQ(total_raw, total_lz4);
+    CHECK_EQ(sum_lz4, sum_raw);
+
+    mbs_lz4 = total_lz4 / (ns_lz4 / 1e3);
+    mbs_raw = total_raw / (ns_raw / 1e3);
+    printf("image %lu bytes, %u bytes compressed (%.1fx)\n", (unsigned long)len, (unsigned)bitstream_lz4_SIZE,
+           (double)len / bitstream_lz4_SIZE);
+    printf("raw %.1f MB/s (%.1f us/image), lz4 %.1f MB/s (%.1f us/image), raw/lz4 %.2fx\n",
+           mbs_raw, ns_raw / BENCH_ROUNDS / 1e3, mbs_lz4, ns_lz4 / BENCH_ROUNDS / 1e3, mbs_raw / mbs_lz4);
+    printf("lz4 decode outpaces 1 MHz I2C (%.0f KB/s) %.0fx on this host\n", I2C_KBPS, mbs_lz4 * 1e3 / I2C_KBPS);
+    return TEST_RESULT();
+}
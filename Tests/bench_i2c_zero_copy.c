@@ -0,0 +1,134 @@
+/*
+ * bench_i2c_zero_copy.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Cost of getting a 160 KB bitstream onto the CrossLink I2C bus, two ways:
+ *  the old i2c_write_long, which cleared the MAX_BITSTREAM_SIZE staging
+ *  buffer and copied the command and image into it before sending, and
+ *  i2c_write_segments, which sends the command and the image in place as
+ *  a two-entry scatter list. The slave at the end of the stub bus checks
+ *  that both deliver the same bytes in one write. Copy time is host wall
+ *  time; the bus time is virtual and the same either way.
+ */
+
+#include "hal_stub.h"
+#include "test.h"
+#include "crosslink.h"
+#include "utils.h"
+#include <string.h>
+#include <time.h>
+
+TEST_DEFINE();
+
+#define SLAVE_ADDR      0x40
+#define IMAGE_LEN       (160U * 1024)
+#define CMD_LEN         4
+#define ROUNDS          20
+
+static const uint8_t cmd[CMD_LEN] = { 0x70, 0x00, 0x00, 0x01 };   /* LSC_BITSTREAM_BURST */
+static uint8_t image[IMAGE_LEN];
+static uint8_t staging[MAX_BITSTREAM_SIZE];
+
+/* ---- Slave: one CRC over each write, START to STOP ---- */
+
+static struct {
+    uint16_t crc;
+    uint32_t bytes;
+    uint32_t writes;
+    uint16_t last_crc;
+    uint32_t last_bytes;
+} slave;
+
+static int slave_write(void *ctx, const uint8_t *data, size_t len, bool start, bool stop) {
+    UNUSED(ctx);
+    if (start) {
+        slave.crc = 0xFFFF;
+        slave.bytes = 0;
+    }
+    slave.crc = util_crc16_update(slave.crc, data, (uint32_t)len);
+    slave.bytes += (uint32_t)len;
+    if (stop) {
+        slave.last_crc = slave.crc;
+        slave.last_bytes = slave.bytes;
+        slave.writes++;
+    }
+    return 0;
+}
+
+static const hal_stub_i2c_dev_t slave_dev = { .write = slave_write };
+
+void ICM_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
+    UNUSED(hi2c);
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* What i2c_write_long did before sending: clear the whole buffer, then copy */
+static void stage(void) {
+    memset(staging, 0, MAX_BITSTREAM_SIZE);
+    memcpy(staging, cmd, CMD_LEN);
+    memcpy(staging + CMD_LEN, image, IMAGE_LEN);
+}
+
+int test_main(void) {
+    const i2c_segment_t staged[] = { { staging, CMD_LEN + IMAGE_LEN } };
+    const i2c_segment_t zero_copy[] = { { cmd, CMD_LEN }, { image, IMAGE_LEN } };
+    hal_stub_i2c_stats_t i2c0, i2c1, i2c2;
+    double copy_ns = 0, t0;
+    uint64_t bus_staged, bus_zero_copy, v0;
+    uint32_t seed = 31, writes;
+    uint16_t want;
+
+    for (size_t i = 0; i < sizeof(image); i++) {
+        image[i] = (uint8_t)test_rand(&seed);
+    }
+    want = util_crc16_update(util_crc16(cmd, CMD_LEN), image, IMAGE_LEN);
+
+    util_cycles_init();
+    hal_stub_i2c_attach(SLAVE_ADDR, &slave_dev);
+    hal_stub_i2c_set_clock(1000000);
+
+    // Copy cost over several rounds; the bus only has to be run once per path
+    for (int r = 0; r < ROUNDS; r++) {
+        t0 = now_ns();
+        stage();
+        copy_ns += now_ns() - t0;
+    }
+    copy_ns /= ROUNDS;
+
+    hal_stub_i2c_get_stats(&i2c0);
+    v0 = hal_stub_now();
+    CHECK_EQ(i2c_write_segments(staged, 1), HAL_OK);
+    bus_staged = hal_stub_now() - v0;
+    CHECK_EQ(slave.last_bytes, CMD_LEN + IMAGE_LEN);
+    CHECK_EQ(slave.last_crc, want);
+    hal_stub_i2c_get_stats(&i2c1);
+
+    // Nothing is copied: the list points at the command and the image where they are
+    writes = slave.writes;
+    memset(staging, 0, sizeof(staging));
+    v0 = hal_stub_now();
+    CHECK_EQ(i2c_write_segments(zero_copy, 2), HAL_OK);
+    bus_zero_copy = hal_stub_now() - v0;
+    CHECK_EQ(slave.writes, writes + 1);
+    CHECK_EQ(slave.last_bytes, CMD_LEN + IMAGE_LEN);
+    CHECK_EQ(slave.last_crc, want);
+    hal_stub_i2c_get_stats(&i2c2);
+    CHECK_EQ(i2c2.bytes - i2c1.bytes, i2c1.bytes - i2c0.bytes);
+
+    printf("%-12s  %14s  %14s  %12s  %12s\n", "path", "bytes cleared", "bytes copied", "copy us", "bus ms*");
+    printf("%-12s  %14lu  %14lu  %12.1f  %12.1f\n", "staged", (unsigned long)MAX_BITSTREAM_SIZE,
+           (unsigned long)(CMD_LEN + IMAGE_LEN), copy_ns / 1e3, bus_staged / 1e6);
+    printf("%-12s  %14d  %14d  %12.1f  %12.1f\n", "zero copy", 0, 0, 0.0, bus_zero_copy / 1e6);
+    printf("zero copy saves %lu bytes of memory traffic and %.1f us of copying per image on this host\n",
+           (unsigned long)(MAX_BITSTREAM_SIZE + CMD_LEN + IMAGE_LEN), copy_ns / 1e3);
+    printf("* virtual time at 1 MHz, %lu bytes on the bus either way\n",
+           (unsigned long)(i2c1.bytes - i2c0.bytes));
+    return TEST_RESULT();
+}
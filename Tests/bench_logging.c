@@ -0,0 +1,130 @@
+/*
+ * bench_logging.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Producer-side cost and wire size of one IMU sample line, three ways:
+ *  printf's path (format, then _write into the log ring), log_printf, and
+ *  a LOGB binary record through logging_bin. The DWT only counts virtual
+ *  time here, so CPU cost is host wall time around the calls; the UART is
+ *  drained between batches, outside the timed part. Absolute numbers say
+ *  little about the Cortex-M7; the ratio is the point.
+ */
+
+#include "hal_stub.h"
+#include "test.h"
+#include "logging.h"
+#include "utils.h"
+#include <time.h>
+
+TEST_DEFINE();
+
+#define BATCH           12              /* Lines per batch, well within the 1 KB ring */
+#define BATCHES         20000
+#define UART_BAUD       921600
+
+#define SAMPLE_FMT      "imu %6d %6d %6d %6d %6d %6d t=%lu\r\n"
+
+int _write(int fd, const void *buf, size_t count);
+
+typedef enum {
+    PATH_PRINTF = 0,
+    PATH_LOG_PRINTF,
+    PATH_LOGB,
+    PATH_COUNT,
+} path_t;
+
+static const char *const path_names[PATH_COUNT] = { "printf -> _write", "log_printf", "LOGB record" };
+
+static uint8_t wire[1U << 16];
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+    logging_UART_TxCpltCallback(huart);
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
+    logging_UART_ErrorCallback(huart);
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void log_sample(path_t path, const int16_t *s, uint32_t t) {
+    char line[96];
+    int len;
+
+    switch (path) {
+    case PATH_PRINTF:
+        // What newlib's printf does: format into its buffer, then hand the line to _write
+        len = snprintf(line, sizeof(line), SAMPLE_FMT, s[0], s[1], s[2], s[3], s[4], s[5], (unsigned long)t);
+        _write(1, line, (size_t)len);
+        break;
+    case PATH_LOG_PRINTF:
+        log_printf(LOG_LEVEL_INFO, SAMPLE_FMT, s[0], s[1], s[2], s[3], s[4], s[5], (unsigned long)t);
+        break;
+    default:
+        // LOGB(SAMPLE_FMT, ...) in a LOGGING_BINARY build; the format's offset is a constant
+        logging_bin(0x0120, 7, (uint32_t)s[0], (uint32_t)s[1], (uint32_t)s[2], (uint32_t)s[3],
+                    (uint32_t)s[4], (uint32_t)s[5], t);
+        break;
+    }
+}
+
+/* Host ns per line; wire bytes per line in *bytes */
+static double bench(path_t path, double *bytes) {
+    uint32_t seed = 29, t = 0;
+    uint64_t out = 0;
+    int16_t s[6];
+    double ns = 0, t0;
+
+    for (int b = 0; b < BATCHES; b++) {
+        t0 = now_ns();
+        for (int i = 0; i < BATCH; i++) {
+            for (int k = 0; k < 6; k++) {
+                s[k] = (int16_t)test_rand(&seed);
+            }
+            log_sample(path, s, t++);
+        }
+        ns += now_ns() - t0;
+
+        // Let the UART DMA drain the batch
+        hal_stub_run_all();
+        out += hal_stub_uart_take(wire, sizeof(wire));
+    }
+    *bytes = (double)out / ((double)BATCHES * BATCH);
+    return ns / ((double)BATCHES * BATCH);
+}
+
+int test_main(void) {
+    logging_stats_t before, after;
+    double ns[PATH_COUNT], bytes[PATH_COUNT];
+
+    util_cycles_init();
+    hal_stub_uart_set_baud(UART_BAUD);
+    init_dma_logging();
+    hal_stub_run_all();
+    hal_stub_uart_take(wire, sizeof(wire));
+
+    logging_get_stats(&before);
+    for (int p = 0; p < PATH_COUNT; p++) {
+        ns[p] = bench((path_t)p, &bytes[p]);
+    }
+    logging_get_stats(&after);
+    // Nothing may be lost, or the byte counts would flatter whichever path dropped
+    for (int i = 0; i < LOG_POLICY_COUNT; i++) {
+        CHECK_EQ(after.policy[i].dropped, before.policy[i].dropped);
+    }
+    CHECK(bytes[PATH_LOGB] < bytes[PATH_PRINTF]);
+
+    printf("%-18s  %10s  %12s  %14s\n", "path", "ns/line", "bytes/line", "lines/s @921k");
+    for (int p = 0; p < PATH_COUNT; p++) {
+        printf("%-18s  %10.1f  %12.1f  %14.0f\n", path_names[p], ns[p], bytes[p], UART_BAUD / 10.0 / bytes[p]);
+    }
+    printf("LOGB: %.2fx less CPU than printf, %.2fx fewer bytes\n", ns[PATH_PRINTF] / ns[PATH_LOGB],
+           bytes[PATH_PRINTF] / bytes[PATH_LOGB]);
+    return TEST_RESULT();
+}
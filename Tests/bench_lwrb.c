@@ -0,0 +1,115 @@
+/*
+ * bench_lwrb.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Host cost of producing records into an lwrb: built in a stack buffer
+ *  and copied in with lwrb_write, against built in place in the spans from
+ *  lwrb_reserve and published with lwrb_commit. The consumer drains the
+ *  ring in place either way. Absolute numbers say little about the
+ *  Cortex-M7; the ratio per record size is the point.
+ */
+
+#include "hal_stub.h"
+#include "test.h"
+#include "lwrb.h"
+#include <time.h>
+
+TEST_DEFINE();
+
+#define RING_SIZE       4096
+#define BENCH_BYTES     (64U * 1024 * 1024)
+
+static const size_t rec_sizes[] = { 8, 32, 128, 512 };
+
+static double now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* The producer's work on a record: e.g. a sample block being formatted */
+static void fill(uint8_t *p, size_t len, uint32_t seq) {
+    for (size_t i = 0; i < len; i++) {
+        p[i] = (uint8_t)(seq + i);
+    }
+}
+
+static uint32_t drain(lwrb_t *rb) {
+    uint32_t sum = 0;
+    size_t len;
+
+    while ((len = lwrb_get_linear_block_read_length(rb)) > 0) {
+        const uint8_t *p = lwrb_get_linear_block_read_address(rb);
+        for (size_t i = 0; i < len; i += 16) {
+            sum += p[i];
+        }
+        lwrb_skip(rb, len);
+    }
+    return sum;
+}
+
+static double bench_write(size_t rec, uint32_t *sum) {
+    static uint8_t ring[RING_SIZE];
+    uint8_t tmp[512];
+    size_t written = 0;
+    uint32_t seq = 0;
+    lwrb_t rb;
+    double t0;
+
+    lwrb_init(&rb, ring, sizeof(ring));
+    *sum = 0;
+    t0 = now_ns();
+    while (written < BENCH_BYTES) {
+        while (lwrb_get_free(&rb) >= rec) {
+            fill(tmp, rec, seq++);
+            written += lwrb_write(&rb, tmp, rec);
+        }
+        *sum += drain(&rb);
+    }
+    return (now_ns() - t0) / (written / rec);
+}
+
+static double bench_reserve(size_t rec, uint32_t *sum) {
+    static uint8_t ring[RING_SIZE];
+    size_t written = 0;
+    uint32_t seq = 0;
+    lwrb_span_t span;
+    lwrb_t rb;
+    double t0;
+
+    lwrb_init(&rb, ring, sizeof(ring));
+    *sum = 0;
+    t0 = now_ns();
+    while (written < BENCH_BYTES) {
+        while (lwrb_reserve(&rb, rec, &span) == rec) {
+            // A record split by the wrap is built in two pieces, as a real producer would
+            fill(span.data[0], span.len[0], seq);
+            if (span.len[1] > 0) {
+                fill(span.data[1], span.len[1], seq + (uint32_t)span.len[0]);
+            }
+            seq++;
+            written += lwrb_commit(&rb, rec);
+        }
+        *sum += drain(&rb);
+    }
+    return (now_ns() - t0) / (written / rec);
+}
+
+int test_main(void) {
+    uint32_t sum_write, sum_reserve;
+    double ns_write, ns_reserve;
+
+    printf("%8s  %14s  %14s  %s\n", "record", "write ns/rec", "reserve ns/rec", "ratio");
+    for (size_t i = 0; i < sizeof(rec_sizes) / sizeof(rec_sizes[0]); i++) {
+        size_t rec = rec_sizes[i];
+
+        ns_write = bench_write(rec, &sum_write);
+        ns_reserve = bench_reserve(rec, &sum_reserve);
+        // Same records, same bytes read back
+        CHECK_EQ(sum_reserve, sum_write);
+        printf("%8lu  %14.1f  %14.1f  %.2fx\n", (unsigned long)rec, ns_write, ns_reserve, ns_write / ns_reserve);
+    }
+    return TEST_RESULT();
+}
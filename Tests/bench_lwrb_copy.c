@@ -0,0 +1,98 @@
+/*
+ * bench_lwrb_copy.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  lwrb_write + lwrb_read throughput with LWRB_USE_WORD_COPY 1 (the
+ *  firmware build) and 0 (lwrb_memcpy.c, plain memcpy), per block size and
+ *  ring offset: word aligned, each misalignment, and straddling the wrap.
+ *  The host libc memcpy is far better than the Cortex-M7's newlib one, so
+ *  this shows where the word path is taken and what it costs on the host,
+ *  not the gain on target.
+ */
+
+#include "hal_stub.h"
+#include "test.h"
+#include "lwrb.h"
+#include <string.h>
+#include <time.h>
+
+TEST_DEFINE();
+
+#define RING_SIZE       4096
+#define BENCH_BYTES     (32U * 1024 * 1024)
+
+/* The LWRB_USE_WORD_COPY 0 build, from lwrb_memcpy.c */
+uint8_t lwrb_memcpy_init(lwrb_t* buff, void* buffdata, size_t size);
+size_t lwrb_memcpy_write(lwrb_t* buff, const void* data, size_t btw);
+size_t lwrb_memcpy_read(lwrb_t* buff, void* data, size_t btr);
+
+typedef struct {
+    const char *name;
+    uint8_t (*init)(lwrb_t *, void *, size_t);
+    size_t (*write)(lwrb_t *, const void *, size_t);
+    size_t (*read)(lwrb_t *, void *, size_t);
+} copy_impl_t;
+
+static const copy_impl_t impls[] = {
+    { "word", lwrb_init, lwrb_write, lwrb_read },
+    { "memcpy", lwrb_memcpy_init, lwrb_memcpy_write, lwrb_memcpy_read },
+};
+
+static const size_t blocks[] = { 8, 32, 128, 512, 2048 };
+
+static uint8_t ring[RING_SIZE] __attribute__((aligned(8)));
+static uint8_t src[RING_SIZE] __attribute__((aligned(8)));
+static uint8_t dst[RING_SIZE] __attribute__((aligned(8)));
+
+static double now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* MB/s through the ring, every block written at and read back from `pos`; 0 on a data error */
+static double bench(const copy_impl_t *impl, size_t len, size_t pos) {
+    uint32_t rounds = BENCH_BYTES / len;
+    lwrb_t rb;
+    double t0;
+
+    impl->init(&rb, ring, sizeof(ring));
+    memset(dst, 0, len);
+    t0 = now_ns();
+    for (uint32_t i = 0; i < rounds; i++) {
+        rb.r = rb.w = pos;
+        impl->write(&rb, src, len);
+        impl->read(&rb, dst, len);
+    }
+    t0 = now_ns() - t0;
+    return (memcmp(dst, src, len) == 0) ? (double)rounds * len / (t0 / 1e3) : 0.0;
+}
+
+int test_main(void) {
+    uint32_t seed = 17;
+
+    for (size_t i = 0; i < sizeof(src); i++) {
+        src[i] = (uint8_t)test_rand(&seed);
+    }
+
+    printf("MB/s, lwrb_write + lwrb_read, word copy / memcpy\n");
+    printf("%6s  %15s  %15s  %15s  %15s  %15s\n", "block", "offset 0", "offset 1", "offset 2", "offset 3", "wrap");
+    for (size_t b = 0; b < sizeof(blocks) / sizeof(blocks[0]); b++) {
+        size_t len = blocks[b];
+        // Aligned, each misalignment, then split in the middle by the end of the ring
+        size_t offsets[] = { 0, 1, 2, 3, RING_SIZE - len / 2 };
+
+        printf("%6lu", (unsigned long)len);
+        for (size_t o = 0; o < sizeof(offsets) / sizeof(offsets[0]); o++) {
+            double word = bench(&impls[0], len, offsets[o]);
+            double plain = bench(&impls[1], len, offsets[o]);
+
+            CHECK(word > 0 && plain > 0);
+            printf("  %6.0f / %6.0f", word, plain);
+        }
+        printf("\n");
+    }
+    return TEST_RESULT();
+}
@@ -0,0 +1,116 @@
+/*
+ * bench_lwrb_mq.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  lwrb_mq throughput per record size: put and get interleaved on one
+ *  thread (the cost of the calls themselves), then a producer thread
+ *  against a consuming one through a 4 KB ring, the producer retrying
+ *  whatever does not fit. Host wall time; on a single-CPU host the
+ *  two-thread figure is mostly the scheduler.
+ */
+
+#include "hal_stub.h"
+#include "test.h"
+#include "lwrb_mq.h"
+#include <sched.h>
+#include <time.h>
+
+TEST_DEFINE();
+
+#define RING_SIZE       4096
+#define BENCH_BYTES     (64U * 1024 * 1024)
+
+static const size_t rec_sizes[] = { 16, 64, 256 };
+
+static lwrb_mq_t mq;
+static uint8_t ring[RING_SIZE];
+static uint8_t data[256];
+
+typedef struct {
+    pthread_t thread;
+    size_t rec;
+    uint32_t count;
+    uint32_t retries;
+} producer_t;
+
+static double now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* ns per record, a batch put then got back */
+static double bench_one_thread(size_t rec, uint32_t count) {
+    uint8_t out[256];
+    uint32_t moved = 0;
+    double t0;
+
+    lwrb_mq_init(&mq, ring, sizeof(ring));
+    t0 = now_ns();
+    while (moved < count) {
+        while (lwrb_mq_put(&mq, data, rec)) {
+        }
+        while (lwrb_mq_get(&mq, out, sizeof(out)) == rec) {
+            moved++;
+        }
+    }
+    return (now_ns() - t0) / moved;
+}
+
+static void *producer(void *arg) {
+    producer_t *p = arg;
+
+    for (uint32_t i = 0; i < p->count; i++) {
+        while (!lwrb_mq_put(&mq, data, p->rec)) {
+            p->retries++;
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/* ns per record, producer thread against this one */
+static double bench_two_threads(size_t rec, uint32_t count, uint32_t *retries) {
+    producer_t p = { .rec = rec, .count = count };
+    uint8_t out[256];
+    uint32_t moved = 0;
+    double t0;
+
+    lwrb_mq_init(&mq, ring, sizeof(ring));
+    t0 = now_ns();
+    CHECK_EQ(hal_stub_thread_create(&p.thread, producer, &p), 0);
+    while (moved < count) {
+        if (lwrb_mq_get(&mq, out, sizeof(out)) == rec) {
+            moved++;
+        } else {
+            sched_yield();
+        }
+    }
+    pthread_join(p.thread, NULL);
+    *retries = p.retries;
+    return (now_ns() - t0) / moved;
+}
+
+int test_main(void) {
+    uint32_t seed = 19, retries;
+    double ns1, ns2;
+
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)test_rand(&seed);
+    }
+
+    printf("%8s  %22s  %22s\n", "record", "one thread", "two threads");
+    for (size_t i = 0; i < sizeof(rec_sizes) / sizeof(rec_sizes[0]); i++) {
+        size_t rec = rec_sizes[i];
+        uint32_t count = BENCH_BYTES / 4 / rec;
+
+        ns1 = bench_one_thread(rec, count);
+        ns2 = bench_two_threads(rec, count, &retries);
+        CHECK_EQ(lwrb_mq_count(&mq), 0);
+        printf("%8lu  %6.1f ns %8.1f MB/s  %6.1f ns %8.1f MB/s  (%lu retries)\n", (unsigned long)rec,
+               ns1, rec * 1e3 / ns1, ns2, rec * 1e3 / ns2, (unsigned long)retries);
+    }
+    return TEST_RESULT();
+}
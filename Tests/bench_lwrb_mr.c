@@ -0,0 +1,115 @@
+/*
+ * bench_lwrb_mr.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Host cost of fanning one byte stream out to three readers: one lwrb_mr
+ *  written once and read in place by every reader, against a copy of the
+ *  stream written into one lwrb per reader. The ratio is the point.
+ */
+
+#include "hal_stub.h"
+#include "test.h"
+#include "lwrb.h"
+#include "lwrb_mr.h"
+#include <time.h>
+
+TEST_DEFINE();
+
+#define READERS         3
+#define RING_SIZE       1024
+#define CHUNK           48
+#define BENCH_BYTES     (64U * 1024 * 1024)
+
+static uint8_t data[4096];
+
+static double now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* What a reader does with a block in place, e.g. hand it to a DMA */
+static uint32_t consume(const uint8_t *p, size_t len) {
+    uint32_t sum = 0;
+
+    for (size_t i = 0; i < len; i += 16) {
+        sum += p[i];
+    }
+    return sum + (uint32_t)len;
+}
+
+static double bench_mr(uint32_t *sum) {
+    static uint8_t ring[RING_SIZE];
+    lwrb_mr_reader_t readers[READERS];
+    lwrb_mr_t rb;
+    size_t written = 0, off = 0, len;
+    double t0;
+
+    lwrb_mr_init(&rb, ring, sizeof(ring));
+    for (int i = 0; i < READERS; i++) {
+        lwrb_mr_attach(&rb, &readers[i], 0);
+    }
+    *sum = 0;
+    t0 = now_ns();
+    while (written < BENCH_BYTES) {
+        while (lwrb_mr_get_free(&rb) >= CHUNK) {
+            written += lwrb_mr_write(&rb, &data[off], CHUNK);
+            off = (off + CHUNK) & (sizeof(data) - 1);
+        }
+        for (int i = 0; i < READERS; i++) {
+            while ((len = lwrb_mr_get_linear_block_read_length(&rb, &readers[i])) > 0) {
+                *sum += consume(lwrb_mr_get_linear_block_read_address(&rb, &readers[i]), len);
+                lwrb_mr_skip(&rb, &readers[i], len);
+            }
+        }
+    }
+    return (now_ns() - t0) / written;
+}
+
+static double bench_copies(uint32_t *sum) {
+    static uint8_t rings[READERS][RING_SIZE + 1];
+    lwrb_t rb[READERS];
+    size_t written = 0, off = 0, len;
+    double t0;
+
+    for (int i = 0; i < READERS; i++) {
+        lwrb_init(&rb[i], rings[i], sizeof(rings[i]));
+    }
+    *sum = 0;
+    t0 = now_ns();
+    while (written < BENCH_BYTES) {
+        while (lwrb_get_free(&rb[0]) >= CHUNK) {
+            for (int i = 0; i < READERS; i++) {
+                lwrb_write(&rb[i], &data[off], CHUNK);
+            }
+            written += CHUNK;
+            off = (off + CHUNK) & (sizeof(data) - 1);
+        }
+        for (int i = 0; i < READERS; i++) {
+            while ((len = lwrb_get_linear_block_read_length(&rb[i])) > 0) {
+                *sum += consume(lwrb_get_linear_block_read_address(&rb[i]), len);
+                lwrb_skip(&rb[i], len);
+            }
+        }
+    }
+    return (now_ns() - t0) / written;
+}
+
+int test_main(void) {
+    uint32_t seed = 11, sum_mr, sum_copies;
+    double ns_mr, ns_copies;
+
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)test_rand(&seed);
+    }
+
+    ns_copies = bench_copies(&sum_copies);
+    ns_mr = bench_mr(&sum_mr);
+    CHECK(sum_mr != 0 && sum_copies != 0);
+
+    printf("fan-out to %d readers: %d lwrb copies %.3f ns/byte, one lwrb_mr %.3f ns/byte, %.2fx\n",
+           READERS, READERS, ns_copies, ns_mr, ns_copies / ns_mr);
+    return TEST_RESULT();
+}
@@ -0,0 +1,31 @@
+/*
+ * lwrb_memcpy.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  lwrb.c built again with LWRB_USE_WORD_COPY 0 and every function renamed
+ *  lwrb_memcpy_*, so one bench can run both copy paths side by side.
+ */
+
+#define LWRB_USE_WORD_COPY                  0
+
+#define lwrb_init                           lwrb_memcpy_init
+#define lwrb_is_ready                       lwrb_memcpy_is_ready
+#define lwrb_free                           lwrb_memcpy_free
+#define lwrb_set_evt_fn                     lwrb_memcpy_set_evt_fn
+#define lwrb_write                          lwrb_memcpy_write
+#define lwrb_read                           lwrb_memcpy_read
+#define lwrb_peek                           lwrb_memcpy_peek
+#define lwrb_get_free                       lwrb_memcpy_get_free
+#define lwrb_get_full                       lwrb_memcpy_get_full
+#define lwrb_reset                          lwrb_memcpy_reset
+#define lwrb_get_linear_block_read_address  lwrb_memcpy_get_linear_block_read_address
+#define lwrb_get_linear_block_read_length   lwrb_memcpy_get_linear_block_read_length
+#define lwrb_skip                           lwrb_memcpy_skip
+#define lwrb_get_linear_block_write_address lwrb_memcpy_get_linear_block_write_address
+#define lwrb_get_linear_block_write_length  lwrb_memcpy_get_linear_block_write_length
+#define lwrb_advance                        lwrb_memcpy_advance
+#define lwrb_reserve                        lwrb_memcpy_reserve
+#define lwrb_commit                         lwrb_memcpy_commit
+
+#include "../Core/Src/lwrb.c"
@@ -0,0 +1,908 @@
+/*
+ * hal_stub.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Behaviour behind the host HAL stand-in: a virtual clock with deferred
+ *  interrupt events, PRIMASK as a process-wide lock, I2C1 with attachable
+ *  slaves, USART3 capture, the CRC unit fed by MDMA, and both flash banks
+ *  mapped at their real addresses.
+ *
+ *  The firmware passes buffer addresses to the HAL as uint32_t, so the test
+ *  is linked non-PIE (statics below 4 GB) and runs on threads whose stacks
+ *  are mapped below 4 GB too.
+ */
+
+#define _GNU_SOURCE
+#include "hal_stub.h"
+#include "main.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#define NS_PER_MS               1000000ULL
+#define NS_PER_S                1000000000ULL
+#define POLL_NS                 1000ULL     /* Cost of one trip round a polling loop */
+#define EVENT_MAX               32
+#define I2C_MAX_NBYTES          255U        /* NBYTES reload, one I2C interrupt each */
+#define MDMA_MAX_BLOCK          65536U
+#define MDMA_NS_PER_BYTE        2ULL
+#define FLASH_BANK_SIZE         0x00100000UL
+#define FLASH_WORD_SIZE         (FLASH_NB_32BITWORD_IN_FLASHWORD * 4U)
+#define THREAD_STACK_SIZE       (1U << 20)
+
+uint32_t SystemCoreClock = 1000000000UL;
+CoreDebug_Type hal_stub_coredebug;
+GPIO_TypeDef hal_stub_gpio[8];
+
+static CRC_TypeDef crc_unit;
+static DMA_HandleTypeDef hdma_usart3_tx;
+
+CRC_HandleTypeDef hcrc = { .Instance = &crc_unit };
+MDMA_HandleTypeDef hmdma_crc;
+I2C_HandleTypeDef hi2c1 = { .Instance = I2C1, .State = HAL_I2C_STATE_READY };
+UART_HandleTypeDef huart3 = {
+    .Instance = USART3, .gState = HAL_UART_STATE_READY, .RxState = HAL_UART_STATE_READY,
+    .hdmatx = &hdma_usart3_tx,
+};
+TIM_HandleTypeDef htim12;
+
+/* Kept up by the I2C1 handlers in stm32h7xx_it.c, and the tick, when linked in */
+extern volatile uint32_t i2c1_irq_count __attribute__((weak));
+extern uint64_t util_cycles(void) __attribute__((weak));
+
+/* ---- PRIMASK ---- */
+
+static pthread_mutex_t primask_lock = PTHREAD_MUTEX_INITIALIZER;
+static __thread bool primask_held;
+static __thread bool in_event;
+
+uint32_t __get_PRIMASK(void) {
+    return primask_held ? 1U : 0U;
+}
+
+/* Non-zero inside an event, as in a handler */
+uint32_t __get_IPSR(void) {
+    return in_event ? 16U : 0U;
+}
+
+void __disable_irq(void) {
+    if (!primask_held) {
+        pthread_mutex_lock(&primask_lock);
+        primask_held = true;
+    }
+}
+
+void __enable_irq(void) {
+    // A handler always returns with the mask it was entered with
+    if (primask_held && !in_event) {
+        primask_held = false;
+        pthread_mutex_unlock(&primask_lock);
+    }
+}
+
+void __set_PRIMASK(uint32_t primask) {
+    if (primask & 1U) {
+        __disable_irq();
+    } else {
+        __enable_irq();
+    }
+}
+
+uint32_t __RBIT(uint32_t value) {
+    uint32_t r = 0;
+
+    for (int i = 0; i < 32; i++) {
+        r = (r << 1) | (value & 1U);
+        value >>= 1;
+    }
+    return r;
+}
+
+/* ---- Virtual clock and events ---- */
+
+typedef struct {
+    bool used;
+    uint64_t due;
+    uint64_t seq;
+    hal_stub_event_fn fn;
+    void *arg;
+} event_t;
+
+static uint64_t clock_ns;
+static uint64_t clock_second;
+static pthread_mutex_t event_lock = PTHREAD_MUTEX_INITIALIZER;
+static event_t events[EVENT_MAX];
+static uint64_t event_seq;
+static bool irq_enabled[160];
+
+uint64_t hal_stub_now(void) {
+    return __atomic_load_n(&clock_ns, __ATOMIC_ACQUIRE);
+}
+
+/* Moves the clock forward to t, never back */
+static void clock_reach(uint64_t t) {
+    uint64_t cur = hal_stub_now();
+
+    while (cur < t && !__atomic_compare_exchange_n(&clock_ns, &cur, t, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+    }
+}
+
+static bool can_interrupt(void) {
+    return !primask_held && !in_event;
+}
+
+static void run_event(const event_t *e) {
+    __disable_irq();
+    in_event = true;
+    e->fn(e->arg);
+    in_event = false;
+    primask_held = false;
+    pthread_mutex_unlock(&primask_lock);
+}
+
+/* Earliest event due by `limit`, taken off the queue */
+static bool take_event(uint64_t limit, event_t *out) {
+    event_t *best = NULL;
+
+    pthread_mutex_lock(&event_lock);
+    for (int i = 0; i < EVENT_MAX; i++) {
+        event_t *e = &events[i];
+        if (e->used && e->due <= limit &&
+            (best == NULL || e->due < best->due || (e->due == best->due && e->seq < best->seq))) {
+            best = e;
+        }
+    }
+    if (best != NULL) {
+        *out = *best;
+        best->used = false;
+    }
+    pthread_mutex_unlock(&event_lock);
+    return best != NULL;
+}
+
+/* The 1 s tick keeps util_cycles() ahead of CYCCNT wrapping, as the HAL tick does on target */
+static void tick(void) {
+    uint64_t second = hal_stub_now() / NS_PER_S;
+    uint64_t last = __atomic_load_n(&clock_second, __ATOMIC_ACQUIRE);
+
+    if (second != last && __atomic_compare_exchange_n(&clock_second, &last, second, false,
+                                                      __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        if (util_cycles != NULL) {
+            util_cycles();
+        }
+    }
+}
+
+void hal_stub_advance(uint64_t ns) {
+    uint64_t target = hal_stub_now() + ns;
+    event_t e;
+
+    if (!can_interrupt()) {
+        clock_reach(target);
+        return;
+    }
+    for (;;) {
+        uint64_t step = hal_stub_now() + NS_PER_S;
+
+        if (step > target) {
+            step = target;
+        }
+        if (take_event(step, &e)) {
+            clock_reach(e.due);
+            tick();
+            run_event(&e);
+            continue;
+        }
+        clock_reach(step);
+        tick();
+        if (step >= target) {
+            break;
+        }
+    }
+}
+
+void hal_stub_poll(void) {
+    hal_stub_advance(POLL_NS);
+}
+
+/* Jump to the next pending event and run it */
+bool hal_stub_run_next(void) {
+    event_t e;
+
+    if (!can_interrupt() || !take_event(UINT64_MAX, &e)) {
+        return false;
+    }
+    clock_reach(e.due);
+    tick();
+    run_event(&e);
+    return true;
+}
+
+void hal_stub_run_all(void) {
+    while (hal_stub_run_next()) {
+    }
+}
+
+void hal_stub_schedule(uint64_t delay_ns, hal_stub_event_fn fn, void *arg) {
+    pthread_mutex_lock(&event_lock);
+    for (int i = 0; i < EVENT_MAX; i++) {
+        if (!events[i].used) {
+            events[i] = (event_t){ true, hal_stub_now() + delay_ns, event_seq++, fn, arg };
+            pthread_mutex_unlock(&event_lock);
+            return;
+        }
+    }
+    pthread_mutex_unlock(&event_lock);
+    fprintf(stderr, "hal_stub: event queue full\n");
+    abort();
+}
+
+void hal_stub_cancel(hal_stub_event_fn fn, void *arg) {
+    pthread_mutex_lock(&event_lock);
+    for (int i = 0; i < EVENT_MAX; i++) {
+        if (events[i].used && events[i].fn == fn && events[i].arg == arg) {
+            events[i].used = false;
+        }
+    }
+    pthread_mutex_unlock(&event_lock);
+}
+
+/* Raise an interrupt now; it stays pending while PRIMASK is set */
+void hal_stub_irq(hal_stub_event_fn fn, void *arg) {
+    hal_stub_schedule(0, fn, arg);
+    hal_stub_advance(0);
+}
+
+/* Sleep until the next event or SysTick, whichever comes first */
+void hal_stub_wfi(void) {
+    uint64_t next_tick = (hal_stub_now() / NS_PER_MS + 1) * NS_PER_MS;
+    event_t e;
+
+    if (!can_interrupt()) {
+        hal_stub_advance(POLL_NS);
+        return;
+    }
+    if (take_event(next_tick, &e)) {
+        clock_reach(e.due);
+        tick();
+        run_event(&e);
+        return;
+    }
+    clock_reach(next_tick);
+    tick();
+}
+
+uint32_t HAL_GetTick(void) {
+    hal_stub_poll();
+    return (uint32_t)(hal_stub_now() / NS_PER_MS);
+}
+
+void HAL_Delay(uint32_t Delay) {
+    hal_stub_advance((uint64_t)Delay * NS_PER_MS);
+}
+
+DWT_Type *hal_stub_dwt(void) {
+    static __thread DWT_Type dwt;
+
+    dwt.CYCCNT = (uint32_t)hal_stub_now();
+    return &dwt;
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority) {
+    UNUSED(IRQn);
+    UNUSED(PreemptPriority);
+    UNUSED(SubPriority);
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn) {
+    irq_enabled[IRQn] = true;
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn) {
+    irq_enabled[IRQn] = false;
+}
+
+bool hal_stub_irq_enabled(IRQn_Type irqn) {
+    return irq_enabled[irqn];
+}
+
+/* ---- GPIO ---- */
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState) {
+    if (PinState == GPIO_PIN_SET) {
+        GPIOx->ODR |= GPIO_Pin;
+    } else {
+        GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+    }
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+    return (GPIOx->ODR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+/* ---- I2C1 ---- */
+
+static const hal_stub_i2c_dev_t *i2c_devs[128];
+static uint32_t i2c_clock_hz = 400000;
+static hal_stub_i2c_stats_t i2c_stats;
+static bool i2c_open;                   /* Last piece ended without a STOP */
+static bool i2c_open_read;
+static uint8_t i2c_open_addr;
+
+static struct {
+    I2C_HandleTypeDef *hi2c;
+    uint16_t addr;
+    uint16_t reg;
+    uint8_t *data;
+    uint16_t len;
+    uint32_t opts;
+    bool read;
+    bool mem;
+} i2c_xfer;
+
+void hal_stub_i2c_attach(uint8_t addr7, const hal_stub_i2c_dev_t *dev) {
+    i2c_devs[addr7 & 0x7F] = dev;
+}
+
+void hal_stub_i2c_set_clock(uint32_t hz) {
+    i2c_clock_hz = hz;
+}
+
+void hal_stub_i2c_get_stats(hal_stub_i2c_stats_t *stats) {
+    *stats = i2c_stats;
+}
+
+/* Nine clocks per byte, plus the address byte after every START */
+static uint64_t i2c_time(size_t bytes, int starts) {
+    return (uint64_t)(bytes + (size_t)starts) * 9ULL * NS_PER_S / i2c_clock_hz;
+}
+
+static void i2c_count_irqs(uint32_t n) {
+    if (&i2c1_irq_count != NULL) {
+        i2c1_irq_count += n;
+    }
+}
+
+/* One direction of one transfer; non-zero on NACK, after which the master sends STOP */
+static int i2c_piece(uint16_t addr, uint8_t *data, size_t len, bool read, bool first, bool stop) {
+    uint8_t addr7 = (uint8_t)((addr >> 1) & 0x7F);
+    const hal_stub_i2c_dev_t *dev = i2c_devs[addr7];
+    bool start = first || !i2c_open || i2c_open_read != read || i2c_open_addr != addr7;
+    int ret;
+
+    if (dev == NULL) {
+        ret = -1;
+    } else if (read) {
+        ret = dev->read(dev->ctx, data, len, start, stop);
+    } else {
+        ret = dev->write(dev->ctx, data, len, start, stop);
+    }
+    if (ret != 0) {
+        i2c_stats.nacks++;
+        i2c_open = false;
+        return ret;
+    }
+    i2c_stats.bytes += (uint32_t)len;
+    i2c_open = !stop;
+    i2c_open_read = read;
+    i2c_open_addr = addr7;
+    return 0;
+}
+
+static HAL_StatusTypeDef i2c_begin(I2C_HandleTypeDef *hi2c, HAL_I2C_StateTypeDef state) {
+    if (hi2c->State != HAL_I2C_STATE_READY) {
+        return HAL_BUSY;
+    }
+    hi2c->State = state;
+    hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+    i2c_stats.transfers++;
+    return HAL_OK;
+}
+
+static HAL_StatusTypeDef i2c_end(I2C_HandleTypeDef *hi2c, int ret, uint64_t ns) {
+    hi2c->State = HAL_I2C_STATE_READY;
+    hal_stub_advance(ns);
+    if (ret != 0) {
+        hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+        return HAL_ERROR;
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                          uint16_t Size, uint32_t Timeout) {
+    UNUSED(Timeout);
+    if (i2c_begin(hi2c, HAL_I2C_STATE_BUSY_TX) != HAL_OK) {
+        return HAL_BUSY;
+    }
+    return i2c_end(hi2c, i2c_piece(DevAddress, pData, Size, false, true, true), i2c_time(Size, 1));
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                         uint16_t Size, uint32_t Timeout) {
+    UNUSED(Timeout);
+    if (i2c_begin(hi2c, HAL_I2C_STATE_BUSY_RX) != HAL_OK) {
+        return HAL_BUSY;
+    }
+    return i2c_end(hi2c, i2c_piece(DevAddress, pData, Size, true, true, true), i2c_time(Size, 1));
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                    uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+    uint8_t buf[1 + 256];
+
+    UNUSED(Timeout);
+    if (MemAddSize != I2C_MEMADD_SIZE_8BIT || Size > 256) {
+        return HAL_ERROR;
+    }
+    if (i2c_begin(hi2c, HAL_I2C_STATE_BUSY_TX) != HAL_OK) {
+        return HAL_BUSY;
+    }
+    buf[0] = (uint8_t)MemAddress;
+    memcpy(&buf[1], pData, Size);
+    return i2c_end(hi2c, i2c_piece(DevAddress, buf, 1U + Size, false, true, true), i2c_time(1U + Size, 1));
+}
+
+static int i2c_mem_read(uint16_t DevAddress, uint16_t MemAddress, uint8_t *pData, uint16_t Size) {
+    uint8_t reg = (uint8_t)MemAddress;
+    int ret = i2c_piece(DevAddress, &reg, 1, false, true, false);
+
+    return (ret != 0) ? ret : i2c_piece(DevAddress, pData, Size, true, true, true);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                   uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+    UNUSED(Timeout);
+    if (MemAddSize != I2C_MEMADD_SIZE_8BIT) {
+        return HAL_ERROR;
+    }
+    if (i2c_begin(hi2c, HAL_I2C_STATE_BUSY_RX) != HAL_OK) {
+        return HAL_BUSY;
+    }
+    return i2c_end(hi2c, i2c_mem_read(DevAddress, MemAddress, pData, Size), i2c_time(1U + Size, 2));
+}
+
+/* Sequential transfer options: does the frame open with a START, and end with a STOP? */
+static bool i2c_first(uint32_t opts) {
+    return opts == I2C_FIRST_FRAME || opts == I2C_FIRST_AND_NEXT_FRAME || opts == I2C_FIRST_AND_LAST_FRAME;
+}
+
+static bool i2c_last(uint32_t opts) {
+    return opts == I2C_LAST_FRAME || opts == I2C_FIRST_AND_LAST_FRAME;
+}
+
+/* Completion interrupt of an IT or DMA transfer */
+static void i2c_xfer_done(void *arg) {
+    I2C_HandleTypeDef *hi2c = arg;
+    int ret;
+
+    if (i2c_xfer.mem) {
+        ret = i2c_mem_read(i2c_xfer.addr, i2c_xfer.reg, i2c_xfer.data, i2c_xfer.len);
+    } else {
+        ret = i2c_piece(i2c_xfer.addr, i2c_xfer.data, i2c_xfer.len, i2c_xfer.read,
+                        i2c_first(i2c_xfer.opts), i2c_last(i2c_xfer.opts));
+    }
+    hi2c->State = HAL_I2C_STATE_READY;
+    if (ret != 0) {
+        hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+        HAL_I2C_ErrorCallback(hi2c);
+    } else if (i2c_xfer.mem) {
+        HAL_I2C_MemRxCpltCallback(hi2c);
+    } else if (i2c_xfer.read) {
+        HAL_I2C_MasterRxCpltCallback(hi2c);
+    } else {
+        HAL_I2C_MasterTxCpltCallback(hi2c);
+    }
+}
+
+static HAL_StatusTypeDef i2c_start_async(I2C_HandleTypeDef *hi2c, uint16_t addr, uint8_t *data, uint16_t len,
+                                         uint32_t opts, bool read, bool dma) {
+    uint8_t addr7 = (uint8_t)((addr >> 1) & 0x7F);
+    bool start = i2c_first(opts) || !i2c_open || i2c_open_read != read || i2c_open_addr != addr7;
+    uint64_t ns = i2c_time(len, start ? 1 : 0);
+
+    if (i2c_begin(hi2c, read ? HAL_I2C_STATE_BUSY_RX : HAL_I2C_STATE_BUSY_TX) != HAL_OK) {
+        return HAL_BUSY;
+    }
+    i2c_xfer = (typeof(i2c_xfer)){ hi2c, addr, 0, data, len, opts, read, false };
+    hal_stub_schedule(ns, i2c_xfer_done, hi2c);
+
+    if (dma) {
+        // One I2C interrupt per NBYTES reload, one DMA transfer complete
+        i2c_count_irqs((len + I2C_MAX_NBYTES - 1) / I2C_MAX_NBYTES + 1);
+    } else {
+        // Interrupt-driven transfers are only ever spun on: finish them before returning
+        i2c_count_irqs(len + 1U);
+        hal_stub_advance(ns);
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Seq_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                                 uint16_t Size, uint32_t XferOptions) {
+    return i2c_start_async(hi2c, DevAddress, pData, Size, XferOptions, false, false);
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Seq_Receive_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                                uint16_t Size, uint32_t XferOptions) {
+    return i2c_start_async(hi2c, DevAddress, pData, Size, XferOptions, true, false);
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Seq_Transmit_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                                  uint16_t Size, uint32_t XferOptions) {
+    return i2c_start_async(hi2c, DevAddress, pData, Size, XferOptions, false, true);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                       uint16_t MemAddSize, uint8_t *pData, uint16_t Size) {
+    if (MemAddSize != I2C_MEMADD_SIZE_8BIT) {
+        return HAL_ERROR;
+    }
+    if (i2c_begin(hi2c, HAL_I2C_STATE_BUSY_RX) != HAL_OK) {
+        return HAL_BUSY;
+    }
+    i2c_xfer = (typeof(i2c_xfer)){ hi2c, DevAddress, MemAddress, pData, Size, I2C_FIRST_AND_LAST_FRAME, true, true };
+    hal_stub_schedule(i2c_time(1U + Size, 2), i2c_xfer_done, hi2c);
+    i2c_count_irqs((Size + I2C_MAX_NBYTES - 1) / I2C_MAX_NBYTES + 1);
+    return HAL_OK;
+}
+
+HAL_I2C_StateTypeDef HAL_I2C_GetState(I2C_HandleTypeDef *hi2c) {
+    return hi2c->State;
+}
+
+uint32_t HAL_I2C_GetError(I2C_HandleTypeDef *hi2c) {
+    return hi2c->ErrorCode;
+}
+
+/* ---- USART3 ---- */
+
+static pthread_mutex_t uart_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t uart_baud = 115200;
+static uint8_t uart_out[1U << 20];
+static size_t uart_out_len;
+static bool uart_fail;
+static const uint8_t *uart_dma_data;
+static uint16_t uart_dma_len;
+static __thread bool uart_in_callback;
+static hal_stub_uart_stats_t uart_stats;
+
+void hal_stub_uart_set_baud(uint32_t baud) {
+    uart_baud = baud;
+}
+
+void hal_stub_uart_get_stats(hal_stub_uart_stats_t *stats) {
+    *stats = uart_stats;
+}
+
+void hal_stub_uart_fail_next(void) {
+    uart_fail = true;
+}
+
+static void uart_capture(const uint8_t *data, size_t len) {
+    pthread_mutex_lock(&uart_lock);
+    if (len > sizeof(uart_out) - uart_out_len) {
+        len = sizeof(uart_out) - uart_out_len;
+    }
+    memcpy(&uart_out[uart_out_len], data, len);
+    uart_out_len += len;
+    pthread_mutex_unlock(&uart_lock);
+}
+
+/* Everything sent since the last call; returns the byte count, which may exceed cap */
+size_t hal_stub_uart_take(uint8_t *buf, size_t cap) {
+    size_t len;
+
+    pthread_mutex_lock(&uart_lock);
+    len = uart_out_len;
+    if (buf != NULL) {
+        memcpy(buf, uart_out, (len < cap) ? len : cap);
+    }
+    uart_out_len = 0;
+    pthread_mutex_unlock(&uart_lock);
+    return len;
+}
+
+static uint64_t uart_time(size_t len) {
+    return (uint64_t)len * 10ULL * NS_PER_S / uart_baud;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+    UNUSED(Timeout);
+    if (huart->gState != HAL_UART_STATE_READY) {
+        return HAL_BUSY;
+    }
+    uart_capture(pData, Size);
+    hal_stub_advance(uart_time(Size));
+    return HAL_OK;
+}
+
+static void uart_dma_done(void *arg) {
+    UART_HandleTypeDef *huart = arg;
+
+    if (uart_fail) {
+        uart_fail = false;
+        huart->ErrorCode = 0x10U;       /* HAL_UART_ERROR_DMA */
+        huart->gState = HAL_UART_STATE_READY;
+        uart_in_callback = true;
+        HAL_UART_ErrorCallback(huart);
+        uart_in_callback = false;
+        return;
+    }
+    uart_capture(uart_dma_data, uart_dma_len);
+    huart->gState = HAL_UART_STATE_READY;
+    uart_in_callback = true;
+    HAL_UART_TxCpltCallback(huart);
+    uart_in_callback = false;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size) {
+    if (huart->gState != HAL_UART_STATE_READY) {
+        return HAL_BUSY;
+    }
+    if (pData == NULL || Size == 0) {
+        return HAL_ERROR;
+    }
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+    huart->ErrorCode = 0;
+    uart_dma_data = pData;
+    uart_dma_len = Size;
+    uart_stats.dma_setups++;
+    uart_stats.dma_chained += uart_in_callback ? 1U : 0U;
+    uart_stats.dma_bytes += Size;
+    hal_stub_schedule(uart_time(Size), uart_dma_done, huart);
+    return HAL_OK;
+}
+
+/* ---- CRC unit and MDMA ---- */
+
+static uint32_t crc_unit_width(void) {
+    switch (crc_unit.CR & 0x18U) {
+    case CRC_POLYLENGTH_16B:
+        return 16;
+    case CRC_POLYLENGTH_8B:
+        return 8;
+    case CRC_POLYLENGTH_7B:
+        return 7;
+    default:
+        return 32;
+    }
+}
+
+/* Message bits enter MSB first (LSB first with byte inversion); DR holds the register */
+static void crc_unit_feed(const uint8_t *data, size_t len) {
+    uint32_t width = crc_unit_width();
+    uint32_t mask = (width == 32) ? 0xFFFFFFFFU : ((1U << width) - 1);
+    uint32_t top = 1U << (width - 1);
+    uint32_t reg = crc_unit.DR & mask;
+
+    while (len-- > 0) {
+        uint8_t b = *data++;
+        if ((crc_unit.CR & 0x60U) == CRC_INPUTDATA_INVERSION_BYTE) {
+            b = (uint8_t)(__RBIT(b) >> 24);
+        }
+        for (int i = 7; i >= 0; i--) {
+            bool feedback = ((reg & top) != 0) ^ (((b >> i) & 1U) != 0);
+            reg = (reg << 1) & mask;
+            if (feedback) {
+                reg ^= crc_unit.POL & mask;
+            }
+        }
+    }
+    crc_unit.DR = reg;
+}
+
+HAL_StatusTypeDef HAL_CRC_Init(CRC_HandleTypeDef *h) {
+    if (h->Init.DefaultPolynomialUse == DEFAULT_POLYNOMIAL_ENABLE) {
+        h->Instance->POL = 0x04C11DB7U;
+        h->Instance->CR = CRC_POLYLENGTH_32B;
+    } else {
+        h->Instance->POL = h->Init.GeneratingPolynomial;
+        h->Instance->CR = h->Init.CRCLength;
+    }
+    h->Instance->INIT = (h->Init.DefaultInitValueUse == DEFAULT_INIT_VALUE_ENABLE) ? 0xFFFFFFFFU : h->Init.InitValue;
+    h->Instance->CR |= h->Init.InputDataInversionMode | h->Init.OutputDataInversionMode;
+    __HAL_CRC_DR_RESET(h);
+    return HAL_OK;
+}
+
+uint32_t HAL_CRC_Accumulate(CRC_HandleTypeDef *h, uint32_t pBuffer[], uint32_t BufferLength) {
+    uint32_t width = crc_unit_width();
+
+    // Byte input format: BufferLength counts bytes
+    crc_unit_feed((const uint8_t *)pBuffer, BufferLength);
+    if (h->Instance->CR & CRC_OUTPUTDATA_INVERSION_ENABLE) {
+        return __RBIT(h->Instance->DR) >> (32 - width);
+    }
+    return h->Instance->DR;
+}
+
+static struct {
+    bool busy;
+    uint32_t src;
+    uint32_t dst;
+    uint32_t len;
+} mdma;
+
+HAL_StatusTypeDef HAL_MDMA_RegisterCallback(MDMA_HandleTypeDef *hmdma, HAL_MDMA_CallbackIDTypeDef CallbackID,
+                                            void (*pCallback)(MDMA_HandleTypeDef *_hmdma)) {
+    if (CallbackID == HAL_MDMA_XFER_CPLT_CB_ID) {
+        hmdma->XferCpltCallback = pCallback;
+    } else if (CallbackID == HAL_MDMA_XFER_ERROR_CB_ID) {
+        hmdma->XferErrorCallback = pCallback;
+    } else {
+        return HAL_ERROR;
+    }
+    return HAL_OK;
+}
+
+static void mdma_done(void *arg) {
+    MDMA_HandleTypeDef *hmdma = arg;
+
+    mdma.busy = false;
+    if (mdma.dst == (uint32_t)(uintptr_t)&crc_unit.DR) {
+        crc_unit_feed((const uint8_t *)(uintptr_t)mdma.src, mdma.len);
+    } else {
+        memmove((void *)(uintptr_t)mdma.dst, (const void *)(uintptr_t)mdma.src, mdma.len);
+    }
+    if (hmdma->XferCpltCallback != NULL) {
+        hmdma->XferCpltCallback(hmdma);
+    }
+}
+
+HAL_StatusTypeDef HAL_MDMA_Start_IT(MDMA_HandleTypeDef *hmdma, uint32_t SrcAddress, uint32_t DstAddress,
+                                    uint32_t BlockDataLength, uint32_t BlockCount) {
+    if (mdma.busy) {
+        return HAL_BUSY;
+    }
+    if (BlockDataLength == 0 || BlockDataLength > MDMA_MAX_BLOCK || BlockCount != 1) {
+        return HAL_ERROR;
+    }
+    mdma.busy = true;
+    mdma.src = SrcAddress;
+    mdma.dst = DstAddress;
+    mdma.len = BlockDataLength;
+    hal_stub_schedule(BlockDataLength * MDMA_NS_PER_BYTE, mdma_done, hmdma);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_MDMA_Abort(MDMA_HandleTypeDef *hmdma) {
+    hal_stub_cancel(mdma_done, hmdma);
+    mdma.busy = false;
+    return HAL_OK;
+}
+
+/* ---- Flash ---- */
+
+static bool flash_locked = true;
+
+static void flash_map(void) {
+    void *p = mmap((void *)FLASH_BANK1_BASE, 2 * FLASH_BANK_SIZE, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+    if (p != (void *)FLASH_BANK1_BASE) {
+        perror("hal_stub: flash mapping");
+        exit(1);
+    }
+    hal_stub_flash_erase_all();
+}
+
+void hal_stub_flash_erase_all(void) {
+    memset((void *)FLASH_BANK1_BASE, 0xFF, 2 * FLASH_BANK_SIZE);
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void) {
+    flash_locked = false;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void) {
+    flash_locked = true;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *SectorError) {
+    uint32_t base = (pEraseInit->Banks == FLASH_BANK_2) ? FLASH_BANK2_BASE : FLASH_BANK1_BASE;
+
+    *SectorError = pEraseInit->Sector;
+    if (flash_locked || pEraseInit->TypeErase != FLASH_TYPEERASE_SECTORS ||
+        pEraseInit->Sector + pEraseInit->NbSectors > FLASH_BANK_SIZE / FLASH_SECTOR_SIZE) {
+        return HAL_ERROR;
+    }
+    memset((void *)(uintptr_t)(base + pEraseInit->Sector * FLASH_SECTOR_SIZE), 0xFF,
+           pEraseInit->NbSectors * FLASH_SECTOR_SIZE);
+    *SectorError = 0xFFFFFFFFU;
+    return HAL_OK;
+}
+
+/* One 256-bit flash word, which must still be erased */
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t FlashAddress, uint32_t DataAddress) {
+    uint8_t *dst = (uint8_t *)(uintptr_t)FlashAddress;
+
+    if (flash_locked || TypeProgram != FLASH_TYPEPROGRAM_FLASHWORD || (FlashAddress % FLASH_WORD_SIZE) != 0 ||
+        FlashAddress < FLASH_BANK1_BASE || FlashAddress > FLASH_END - FLASH_WORD_SIZE + 1) {
+        return HAL_ERROR;
+    }
+    for (uint32_t i = 0; i < FLASH_WORD_SIZE; i++) {
+        if (dst[i] != 0xFF) {
+            return HAL_ERROR;
+        }
+    }
+    memcpy(dst, (const void *)(uintptr_t)DataAddress, FLASH_WORD_SIZE);
+    return HAL_OK;
+}
+
+/* ---- Default callbacks, overridden by the firmware modules that own them ---- */
+
+__attribute__((weak)) void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c) {
+    UNUSED(hi2c);
+}
+
+__attribute__((weak)) void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c) {
+    UNUSED(hi2c);
+}
+
+__attribute__((weak)) void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c) {
+    UNUSED(hi2c);
+}
+
+__attribute__((weak)) void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
+    UNUSED(hi2c);
+}
+
+__attribute__((weak)) void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+    UNUSED(huart);
+}
+
+__attribute__((weak)) void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
+    UNUSED(huart);
+}
+
+__attribute__((weak)) void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) {
+    UNUSED(GPIO_Pin);
+}
+
+void Error_Handler(void) {
+    fprintf(stderr, "Error_Handler\n");
+    abort();
+}
+
+/* ---- Test entry ---- */
+
+int hal_stub_thread_create(pthread_t *thread, void *(*fn)(void *), void *arg) {
+    pthread_attr_t attr;
+    void *stack;
+    int ret;
+
+    stack = mmap(NULL, THREAD_STACK_SIZE, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT | MAP_STACK, -1, 0);
+    if (stack == MAP_FAILED) {
+        return -1;
+    }
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, stack, THREAD_STACK_SIZE);
+    ret = pthread_create(thread, &attr, fn, arg);
+    pthread_attr_destroy(&attr);
+    return ret;
+}
+
+static void *test_thread(void *arg) {
+    *(int *)arg = test_main();
+    return NULL;
+}
+
+int main(void) {
+    pthread_t thread;
+    int ret = 1;
+
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    flash_map();
+    if (hal_stub_thread_create(&thread, test_thread, &ret) != 0) {
+        perror("hal_stub: test thread");
+        return 1;
+    }
+    pthread_join(thread, NULL);
+    return ret;
+}
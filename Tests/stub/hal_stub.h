@@ -0,0 +1,74 @@
+/*
+ * hal_stub.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Test-side controls of the host HAL stand-in. Time is virtual: it only
+ *  moves when the firmware waits (HAL_Delay, HAL_GetTick polls, __WFI) or a
+ *  test advances it, and "interrupts" are events that fire at their due time
+ *  from those waits, never while PRIMASK is set or inside another event.
+ *  One nanosecond of virtual time is one DWT cycle (SystemCoreClock 1 GHz).
+ */
+
+#ifndef HAL_STUB_H_
+#define HAL_STUB_H_
+
+#include "stm32h7xx_hal.h"
+#include <pthread.h>
+
+/* Entry point of every test program; runs on a stack below 4 GB */
+int test_main(void);
+
+/* Extra firmware threads, also on stacks below 4 GB */
+int hal_stub_thread_create(pthread_t *thread, void *(*fn)(void *), void *arg);
+
+/* Virtual clock and interrupt events */
+typedef void (*hal_stub_event_fn)(void *arg);
+
+uint64_t hal_stub_now(void);
+void hal_stub_advance(uint64_t ns);
+void hal_stub_poll(void);
+bool hal_stub_run_next(void);
+void hal_stub_run_all(void);
+void hal_stub_schedule(uint64_t delay_ns, hal_stub_event_fn fn, void *arg);
+void hal_stub_cancel(hal_stub_event_fn fn, void *arg);
+void hal_stub_irq(hal_stub_event_fn fn, void *arg);
+bool hal_stub_irq_enabled(IRQn_Type irqn);
+
+/*
+ * I2C1 slaves, by 7-bit address. Each call carries one direction of one
+ * transfer; `start` is set on the first piece after a (repeated) START and
+ * `stop` on the piece that ends with a STOP. Returning non-zero NACKs.
+ */
+typedef struct {
+    int (*write)(void *ctx, const uint8_t *data, size_t len, bool start, bool stop);
+    int (*read)(void *ctx, uint8_t *data, size_t len, bool start, bool stop);
+    void *ctx;
+} hal_stub_i2c_dev_t;
+
+typedef struct {
+    uint32_t transfers;                 /* Calls into a HAL I2C transfer function */
+    uint32_t bytes;                     /* Data bytes moved, excluding addresses */
+    uint32_t nacks;
+} hal_stub_i2c_stats_t;
+
+void hal_stub_i2c_attach(uint8_t addr7, const hal_stub_i2c_dev_t *dev);
+void hal_stub_i2c_set_clock(uint32_t hz);
+void hal_stub_i2c_get_stats(hal_stub_i2c_stats_t *stats);
+
+/* USART3: what went out on the wire, and a one-shot transfer error */
+typedef struct {
+    uint32_t dma_setups;                /* HAL_UART_Transmit_DMA calls that started a transfer */
+    uint32_t dma_chained;               /* Of those, started from a completion callback */
+    uint64_t dma_bytes;
+} hal_stub_uart_stats_t;
+
+void hal_stub_uart_set_baud(uint32_t baud);
+void hal_stub_uart_get_stats(hal_stub_uart_stats_t *stats);
+size_t hal_stub_uart_take(uint8_t *buf, size_t cap);
+void hal_stub_uart_fail_next(void);
+
+/* Flash banks as seen through the HAL */
+void hal_stub_flash_erase_all(void);
+
+#endif /* HAL_STUB_H_ */
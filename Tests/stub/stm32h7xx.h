@@ -0,0 +1,15 @@
+/*
+ * stm32h7xx.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Host stand-in for the device header, for code that includes it directly
+ *  (the USB device configuration); everything it needs is in the HAL stub.
+ */
+
+#ifndef STM32H7XX_STUB_H_
+#define STM32H7XX_STUB_H_
+
+#include "stm32h7xx_hal.h"
+
+#endif /* STM32H7XX_STUB_H_ */
@@ -0,0 +1,300 @@
+/*
+ * stm32h7xx_hal.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Host stand-in for the STM32H7 HAL: just the types, macros and calls the
+ *  firmware modules under test use. The behaviour behind them (virtual
+ *  clock, I2C slaves, CRC unit, MDMA, flash) lives in hal_stub.c.
+ */
+
+#ifndef STM32H7XX_HAL_STUB_H_
+#define STM32H7XX_HAL_STUB_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define UNUSED(x)                       ((void)(x))
+#define WRITE_REG(reg, val)             ((reg) = (val))
+#define READ_REG(reg)                   ((reg))
+#define HAL_MAX_DELAY                   0xFFFFFFFFU
+#define __IO                            volatile
+#define __PACKED                        __attribute__((packed))
+#define __STATIC_INLINE                 static inline
+
+typedef enum {
+    HAL_OK       = 0x00U,
+    HAL_ERROR    = 0x01U,
+    HAL_BUSY     = 0x02U,
+    HAL_TIMEOUT  = 0x03U,
+} HAL_StatusTypeDef;
+
+typedef enum {
+    EXTI3_IRQn          = 9,
+    DMA1_Stream0_IRQn   = 11,
+    DMA1_Stream1_IRQn   = 12,
+    DMA1_Stream2_IRQn   = 13,
+    DMA1_Stream3_IRQn   = 14,
+    I2C1_EV_IRQn        = 31,
+    I2C1_ER_IRQn        = 32,
+    USART3_IRQn         = 39,
+    EXTI15_10_IRQn      = 40,
+    OTG_FS_IRQn         = 101,
+    MDMA_IRQn           = 122,
+} IRQn_Type;
+
+extern uint32_t SystemCoreClock;
+
+/* Cortex-M core: PRIMASK is a process-wide lock, DWT counts virtual ns */
+uint32_t __get_PRIMASK(void);
+uint32_t __get_IPSR(void);
+void __set_PRIMASK(uint32_t primask);
+void __disable_irq(void);
+void __enable_irq(void);
+uint32_t __RBIT(uint32_t value);
+#define __DSB()                         __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __DMB()                         __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __ISB()                         __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __NOP()                         do { } while (0)
+void hal_stub_wfi(void);
+#define __WFI()                         hal_stub_wfi()
+
+typedef struct {
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+typedef struct {
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+    volatile uint32_t LAR;
+} DWT_Type;
+
+extern CoreDebug_Type hal_stub_coredebug;
+DWT_Type *hal_stub_dwt(void);
+#define CoreDebug                       (&hal_stub_coredebug)
+#define DWT                             (hal_stub_dwt())
+#define CoreDebug_DEMCR_TRCENA_Msk      (1UL << 24)
+#define DWT_CTRL_CYCCNTENA_Msk          (1UL << 0)
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn);
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+
+/* GPIO */
+typedef struct {
+    volatile uint32_t ODR;
+} GPIO_TypeDef;
+
+typedef enum {
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+extern GPIO_TypeDef hal_stub_gpio[8];
+#define GPIOA                           (&hal_stub_gpio[0])
+#define GPIOB                           (&hal_stub_gpio[1])
+#define GPIOC                           (&hal_stub_gpio[2])
+#define GPIOD                           (&hal_stub_gpio[3])
+#define GPIOG                           (&hal_stub_gpio[6])
+
+#define GPIO_PIN_0                      ((uint16_t)0x0001)
+#define GPIO_PIN_3                      ((uint16_t)0x0008)
+#define GPIO_PIN_9                      ((uint16_t)0x0200)
+#define GPIO_PIN_13                     ((uint16_t)0x2000)
+#define GPIO_PIN_14                     ((uint16_t)0x4000)
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin);
+#define __HAL_GPIO_EXTI_CLEAR_IT(pin)   ((void)(pin))
+
+/* DMA handles only carry the interrupt enables logging.c touches */
+typedef struct {
+    uint32_t Instance;
+    uint32_t it;
+} DMA_HandleTypeDef;
+
+#define DMA_IT_HT                       (1U << 1)
+#define __HAL_DMA_DISABLE_IT(h, i)      ((h)->it &= ~(uint32_t)(i))
+
+/* I2C */
+typedef enum {
+    HAL_I2C_STATE_RESET     = 0x00U,
+    HAL_I2C_STATE_READY     = 0x20U,
+    HAL_I2C_STATE_BUSY      = 0x24U,
+    HAL_I2C_STATE_BUSY_TX   = 0x21U,
+    HAL_I2C_STATE_BUSY_RX   = 0x22U,
+} HAL_I2C_StateTypeDef;
+
+typedef struct {
+    uint32_t Timing;
+} I2C_InitTypeDef;
+
+typedef struct __I2C_HandleTypeDef {
+    uint32_t Instance;
+    I2C_InitTypeDef Init;
+    volatile HAL_I2C_StateTypeDef State;
+    volatile uint32_t ErrorCode;
+    DMA_HandleTypeDef *hdmatx;
+    DMA_HandleTypeDef *hdmarx;
+} I2C_HandleTypeDef;
+
+#define I2C1                            (0x40005400UL)
+#define HAL_I2C_ERROR_NONE              (0x00000000U)
+#define HAL_I2C_ERROR_AF                (0x00000004U)
+#define I2C_MEMADD_SIZE_8BIT            (0x00000001U)
+#define I2C_MEMADD_SIZE_16BIT           (0x00000002U)
+
+#define I2C_FIRST_FRAME                 (0x00000000U)
+#define I2C_FIRST_AND_NEXT_FRAME        (0x00000001U)
+#define I2C_NEXT_FRAME                  (0x00000002U)
+#define I2C_FIRST_AND_LAST_FRAME        (0x00000003U)
+#define I2C_LAST_FRAME                  (0x00000004U)
+#define I2C_LAST_FRAME_NO_STOP          (0x00000005U)
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                          uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                         uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                    uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                   uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Read_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                       uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Master_Seq_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                                 uint16_t Size, uint32_t XferOptions);
+HAL_StatusTypeDef HAL_I2C_Master_Seq_Receive_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                                uint16_t Size, uint32_t XferOptions);
+HAL_StatusTypeDef HAL_I2C_Master_Seq_Transmit_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                                  uint16_t Size, uint32_t XferOptions);
+HAL_I2C_StateTypeDef HAL_I2C_GetState(I2C_HandleTypeDef *hi2c);
+uint32_t HAL_I2C_GetError(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
+
+/* UART */
+typedef enum {
+    HAL_UART_STATE_RESET    = 0x00U,
+    HAL_UART_STATE_READY    = 0x20U,
+    HAL_UART_STATE_BUSY_TX  = 0x21U,
+} HAL_UART_StateTypeDef;
+
+typedef struct __UART_HandleTypeDef {
+    uint32_t Instance;
+    volatile HAL_UART_StateTypeDef gState;
+    volatile HAL_UART_StateTypeDef RxState;
+    volatile uint32_t ErrorCode;
+    DMA_HandleTypeDef *hdmatx;
+    DMA_HandleTypeDef *hdmarx;
+} UART_HandleTypeDef;
+
+#define USART3                          (0x40004800UL)
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size);
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart);
+
+/* TIM */
+typedef struct {
+    uint32_t Instance;
+} TIM_HandleTypeDef;
+
+/* CRC unit */
+typedef struct {
+    volatile uint32_t DR;
+    volatile uint32_t IDR;
+    volatile uint32_t CR;
+    uint32_t RESERVED;
+    volatile uint32_t INIT;
+    volatile uint32_t POL;
+} CRC_TypeDef;
+
+typedef struct {
+    uint8_t DefaultPolynomialUse;
+    uint8_t DefaultInitValueUse;
+    uint32_t GeneratingPolynomial;
+    uint32_t CRCLength;
+    uint32_t InitValue;
+    uint32_t InputDataInversionMode;
+    uint32_t OutputDataInversionMode;
+} CRC_InitTypeDef;
+
+typedef struct {
+    CRC_TypeDef *Instance;
+    CRC_InitTypeDef Init;
+    uint32_t InputDataFormat;
+} CRC_HandleTypeDef;
+
+#define DEFAULT_POLYNOMIAL_ENABLE       ((uint8_t)0x00U)
+#define DEFAULT_POLYNOMIAL_DISABLE      ((uint8_t)0x01U)
+#define DEFAULT_INIT_VALUE_ENABLE       ((uint8_t)0x00U)
+#define DEFAULT_INIT_VALUE_DISABLE      ((uint8_t)0x01U)
+#define CRC_POLYLENGTH_32B              0x00000000U
+#define CRC_POLYLENGTH_16B              0x00000008U
+#define CRC_POLYLENGTH_8B               0x00000010U
+#define CRC_POLYLENGTH_7B               0x00000018U
+#define CRC_INPUTDATA_INVERSION_NONE    0x00000000U
+#define CRC_INPUTDATA_INVERSION_BYTE    0x00000020U
+#define CRC_OUTPUTDATA_INVERSION_DISABLE 0x00000000U
+#define CRC_OUTPUTDATA_INVERSION_ENABLE 0x00000080U
+#define CRC_INPUTDATA_FORMAT_BYTES      0x00000001U
+
+#define __HAL_CRC_DR_RESET(h)           ((h)->Instance->DR = (h)->Instance->INIT)
+
+HAL_StatusTypeDef HAL_CRC_Init(CRC_HandleTypeDef *hcrc);
+uint32_t HAL_CRC_Accumulate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength);
+
+/* MDMA: one channel, transfers land on the next serviced interrupt */
+typedef struct __MDMA_HandleTypeDef {
+    uint32_t Instance;
+    void (*XferCpltCallback)(struct __MDMA_HandleTypeDef *hmdma);
+    void (*XferErrorCallback)(struct __MDMA_HandleTypeDef *hmdma);
+} MDMA_HandleTypeDef;
+
+typedef enum {
+    HAL_MDMA_XFER_CPLT_CB_ID = 0x00U,
+    HAL_MDMA_XFER_ERROR_CB_ID = 0x05U,
+} HAL_MDMA_CallbackIDTypeDef;
+
+HAL_StatusTypeDef HAL_MDMA_RegisterCallback(MDMA_HandleTypeDef *hmdma, HAL_MDMA_CallbackIDTypeDef CallbackID,
+                                            void (*pCallback)(MDMA_HandleTypeDef *_hmdma));
+HAL_StatusTypeDef HAL_MDMA_Start_IT(MDMA_HandleTypeDef *hmdma, uint32_t SrcAddress, uint32_t DstAddress,
+                                    uint32_t BlockDataLength, uint32_t BlockCount);
+HAL_StatusTypeDef HAL_MDMA_Abort(MDMA_HandleTypeDef *hmdma);
+
+/* Flash: 2 banks of 8 x 128 KB sectors, mapped at the real addresses */
+#define FLASH_BANK1_BASE                (0x08000000UL)
+#define FLASH_BANK2_BASE                (0x08100000UL)
+#define FLASH_END                       (0x081FFFFFUL)
+#define FLASH_SECTOR_SIZE               0x00020000UL
+#define FLASH_NB_32BITWORD_IN_FLASHWORD 8U
+#define FLASH_BANK_1                    0x01U
+#define FLASH_BANK_2                    0x02U
+#define FLASH_TYPEERASE_SECTORS         0x00U
+#define FLASH_VOLTAGE_RANGE_3           0x00000020U
+#define FLASH_TYPEPROGRAM_FLASHWORD     0x01U
+
+typedef struct {
+    uint32_t TypeErase;
+    uint32_t Banks;
+    uint32_t Sector;
+    uint32_t NbSectors;
+    uint32_t VoltageRange;
+} FLASH_EraseInitTypeDef;
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *SectorError);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t FlashAddress, uint32_t DataAddress);
+
+#define D1_AXISRAM_BASE                 (0x24000000UL)
+
+#endif /* STM32H7XX_HAL_STUB_H_ */
@@ -0,0 +1,12 @@
+/*
+ * stm32h7xx_nucleo.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  The board support package is not used by the modules under test.
+ */
+
+#ifndef STM32H7XX_NUCLEO_STUB_H_
+#define STM32H7XX_NUCLEO_STUB_H_
+
+#endif /* STM32H7XX_NUCLEO_STUB_H_ */
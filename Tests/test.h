@@ -0,0 +1,46 @@
+/*
+ * test.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Minimal checks for the host tests: a failed CHECK reports and counts,
+ *  the test carries on, and test_main() returns TEST_RESULT().
+ */
+
+#ifndef TEST_H_
+#define TEST_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+extern int test_failures;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            test_failures++; \
+        } \
+    } while (0)
+
+#define CHECK_EQ(a, b) do { \
+        long long a_ = (long long)(a), b_ = (long long)(b); \
+        if (a_ != b_) { \
+            printf("%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #a, #b, a_, b_); \
+            test_failures++; \
+        } \
+    } while (0)
+
+#define TEST_DEFINE()   int test_failures
+#define TEST_RESULT()   (printf("%s: %d failure(s)\n", __FILE__, test_failures), test_failures != 0)
+
+/* Deterministic xorshift32, so a failure reproduces */
+static inline uint32_t test_rand(uint32_t *state) {
+    uint32_t x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+#endif /* TEST_H_ */
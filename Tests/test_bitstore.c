@@ -0,0 +1,235 @@
+/*
+ * test_bitstore.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Bitstream slots in the stub's flash: Lattice header parsing, programming
+ *  and indexing raw and XLZ4 slots, lookups by name and CRC, and streaming
+ *  a slot while another one is re-indexed.
+ */
+
+#include "hal_stub.h"
+#include "test.h"
+#include "bitstore.h"
+#include "utils.h"
+#include <string.h>
+
+TEST_DEFINE();
+
+#define IMAGE_MAX       60000
+
+static uint8_t image[IMAGE_MAX];
+static uint8_t container[IMAGE_MAX + 64];
+static uint8_t out[IMAGE_MAX];
+
+/* Lattice header followed by `len` bytes of pseudo-random bitstream */
+static uint32_t make_image(uint8_t *buf, const char *name, uint16_t crc, uint32_t len) {
+    char strs[160];
+    uint32_t n = 2, seed = crc | 1U;
+    int slen;
+
+    buf[0] = 0xFF;
+    buf[1] = 0x00;
+    slen = snprintf(strs, sizeof(strs), "Design name: %s.ncd%cPart: LIF-MD6000-6UMG64I%c"
+                    "Date: Fri Oct 16 12:00:00 2026%cBitstream CRC: 0x%04X%c",
+                    name, 0, 0, 0, crc, 0);
+    memcpy(&buf[n], strs, (size_t)slen);
+    n += (uint32_t)slen;
+    buf[n++] = 0xFF;
+    while (n < len) {
+        buf[n++] = (uint8_t)test_rand(&seed);
+    }
+    return len;
+}
+
+static void put16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+/* XLZ4 container of stored (uncompressed) blocks */
+static uint32_t pack_stored(const uint8_t *src, uint32_t len, uint16_t block_size) {
+    uint32_t n = 12;
+
+    memcpy(container, "XLZ4", 4);
+    memcpy(&container[4], &len, 4);
+    put16(&container[8], block_size);
+    put16(&container[10], util_crc16(src, len));
+    for (uint32_t off = 0; off < len; off += block_size) {
+        uint32_t blen = (len - off < block_size) ? len - off : block_size;
+        put16(&container[n], (uint16_t)(0x8000 | blen));
+        memcpy(&container[n + 2], &src[off], blen);
+        n += 2 + blen;
+    }
+    return n;
+}
+
+/* Drain a source; returns the bytes produced, or -1 if a chunk failed */
+static int drain(fpga_source_t *src, uint8_t *dst, size_t done) {
+    while (done < src->total) {
+        const uint8_t *chunk;
+        int len = src->acquire(src, &chunk);
+
+        if (len <= 0) {
+            return -1;
+        }
+        memcpy(&dst[done], chunk, (size_t)len);
+        done += (size_t)len;
+        src->release(src);
+    }
+    return (int)done;
+}
+
+static void test_parse_header(void) {
+    bitstore_entry_t e;
+
+    memset(&e, 0, sizeof(e));
+    make_image(image, "blinky", 0x1A2B, 400);
+    CHECK_EQ(bitstore_parse_header(image, 400, &e), 0);
+    CHECK(strcmp(e.name, "blinky") == 0);
+    CHECK(strcmp(e.part, "LIF-MD6000-6UMG64I") == 0);
+    CHECK(strcmp(e.date, "Fri Oct 16 12:00:00 2026") == 0);
+    CHECK_EQ(e.crc, 0x1A2B);
+
+    // Overlong values are cut to the field size
+    memset(&e, 0, sizeof(e));
+    make_image(image, "a_design_name_well_over_thirty_two_characters", 0x0001, 400);
+    CHECK_EQ(bitstore_parse_header(image, 400, &e), 0);
+    CHECK_EQ(strlen(e.name), BITSTORE_NAME_LEN - 1);
+
+    // Wrong preamble, a string running off the end, no design name
+    memset(&e, 0, sizeof(e));
+    image[0] = 0x00;
+    CHECK_EQ(bitstore_parse_header(image, 400, &e), -1);
+    make_image(image, "blinky", 0x1A2B, 400);
+    CHECK_EQ(bitstore_parse_header(image, 10, &e), -1);
+    memcpy(&image[2], "Xesign", 6);
+    memset(&e, 0, sizeof(e));
+    CHECK_EQ(bitstore_parse_header(image, 400, &e), -1);
+}
+
+static void check_slot(uint32_t slot, const char *name, uint16_t crc, const uint8_t *raw, uint32_t len) {
+    const bitstore_entry_t *e = bitstore_entry(slot);
+    fpga_source_t *src;
+
+    CHECK(e != NULL);
+    if (e == NULL) {
+        return;
+    }
+    CHECK(strcmp(e->name, name) == 0);
+    CHECK_EQ(e->crc, crc);
+    CHECK_EQ(e->image_crc, util_crc16(raw, len));
+    CHECK_EQ(bitstore_find_by_name(name), (int)slot);
+    CHECK_EQ(bitstore_find_by_crc(crc), (int)slot);
+
+    src = bitstore_source(slot);
+    CHECK(src != NULL && src->has_crc && src->total == len);
+    CHECK_EQ(src->crc16, e->image_crc);
+    memset(out, 0, len);
+    CHECK_EQ(drain(src, out, 0), (int)len);
+    CHECK(memcmp(out, raw, len) == 0);
+}
+
+static void test_slots(void) {
+    static uint8_t alpha[50000], gamma[20000];
+    const bitstore_entry_t *e;
+    uint32_t clen;
+
+    bitstore_init();
+    for (uint32_t slot = 0; slot < BITSTORE_NUM_SLOTS; slot++) {
+        CHECK(bitstore_entry(slot) == NULL);
+    }
+    CHECK_EQ(bitstore_find_by_name("alpha"), -1);
+    CHECK(bitstore_source(0) == NULL);
+
+    // Raw image: stored and indexed as is
+    make_image(alpha, "alpha", 0x1111, sizeof(alpha));
+    CHECK_EQ(bitstore_program(0, alpha, sizeof(alpha)), HAL_OK);
+    e = bitstore_entry(0);
+    CHECK(e != NULL && !e->compressed);
+    CHECK(e != NULL && e->image == (const uint8_t *)(BITSTORE_BASE + BITSTORE_HDR_SIZE));
+    CHECK(e != NULL && e->slot_crc == util_crc16(alpha, sizeof(alpha)));
+    check_slot(0, "alpha", 0x1111, alpha, sizeof(alpha));
+
+    // XLZ4 container: header from the first block, image CRC from the container
+    make_image(gamma, "gamma", 0x3333, sizeof(gamma));
+    clen = pack_stored(gamma, sizeof(gamma), 4096);
+    CHECK_EQ(bitstore_program(1, container, clen), HAL_OK);
+    e = bitstore_entry(1);
+    CHECK(e != NULL && e->compressed && e->image_len == clen);
+    CHECK(e != NULL && e->slot_crc == util_crc16(container, clen));
+    check_slot(1, "gamma", 0x3333, gamma, sizeof(gamma));
+
+    // CRC 0x1119 and 0x1111 share a hash bucket
+    make_image(image, "delta", 0x1119, 3000);
+    CHECK_EQ(bitstore_program(2, image, 3000), HAL_OK);
+    check_slot(2, "delta", 0x1119, image, 3000);
+    CHECK_EQ(bitstore_find_by_crc(0x1111), 0);
+    CHECK_EQ(bitstore_find_by_crc(0x4444), -1);
+
+    // Reprogramming replaces the old design
+    make_image(image, "epsilon", 0x5555, 5000);
+    CHECK_EQ(bitstore_program(2, image, 5000), HAL_OK);
+    CHECK_EQ(bitstore_find_by_name("delta"), -1);
+    CHECK_EQ(bitstore_find_by_crc(0x1119), -1);
+    check_slot(2, "epsilon", 0x5555, image, 5000);
+
+    // No Lattice header: stored but not indexed
+    memset(image, 0x5A, 1000);
+    CHECK_EQ(bitstore_program(3, image, 1000), HAL_OK);
+    CHECK(bitstore_entry(3) == NULL);
+    CHECK(bitstore_source(3) == NULL);
+
+    // Bad arguments leave the store alone
+    CHECK_EQ(bitstore_program(BITSTORE_NUM_SLOTS, alpha, 100), HAL_ERROR);
+    CHECK_EQ(bitstore_program(0, alpha, 0), HAL_ERROR);
+    CHECK_EQ(bitstore_program(0, NULL, 100), HAL_ERROR);
+    CHECK_EQ(bitstore_program(0, alpha, BITSTORE_MAX_IMAGE + 1), HAL_ERROR);
+    CHECK(bitstore_entry(BITSTORE_NUM_SLOTS) == NULL);
+
+    // A reboot finds the same index in flash
+    bitstore_init();
+    check_slot(0, "alpha", 0x1111, alpha, sizeof(alpha));
+    check_slot(1, "gamma", 0x3333, gamma, sizeof(gamma));
+    make_image(image, "epsilon", 0x5555, 5000);
+    check_slot(2, "epsilon", 0x5555, image, 5000);
+    CHECK(bitstore_entry(3) == NULL);
+}
+
+/* Indexing an XLZ4 slot must not disturb a compressed slot being streamed */
+static void test_reindex_while_streaming(void) {
+    static uint8_t gamma[20000], zeta[9000];
+    fpga_source_t *src;
+    const uint8_t *chunk;
+    uint32_t clen;
+    int len;
+
+    make_image(gamma, "gamma", 0x3333, sizeof(gamma));
+    src = bitstore_source(1);
+    CHECK(src != NULL);
+    if (src == NULL) {
+        return;
+    }
+    len = src->acquire(src, &chunk);
+    CHECK(len > 0);
+    memcpy(out, chunk, (size_t)len);
+    src->release(src);
+
+    make_image(zeta, "zeta", 0x6666, sizeof(zeta));
+    clen = pack_stored(zeta, sizeof(zeta), 2048);
+    CHECK_EQ(bitstore_program(3, container, clen), HAL_OK);
+    CHECK_EQ(bitstore_find_by_name("zeta"), 3);
+
+    CHECK_EQ(drain(src, out, (size_t)len), (int)sizeof(gamma));
+    CHECK(memcmp(out, gamma, sizeof(gamma)) == 0);
+    check_slot(3, "zeta", 0x6666, zeta, sizeof(zeta));
+}
+
+int test_main(void) {
+    hal_stub_flash_erase_all();
+
+    test_parse_header();
+    test_slots();
+    test_reindex_while_streaming();
+    return TEST_RESULT();
+}
@@ -0,0 +1,210 @@
+/*
+ * test_cdc_upload.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Bitstream upload over USB CDC, end to end: a host streams "XLNK" + image
+ *  into the OUT endpoint as fast as the device arms it, the main loop hands
+ *  the upload to the CrossLink loader as main.c does, and the simulated
+ *  slave (xlink_sim.c) checks what arrives. The endpoint is NAKed through
+ *  the reset hold and the erase, so slow erases must not trip the upload
+ *  timeout, while a host that really stops sending still must. Reports the
+ *  end-to-end programming time, in virtual time.
+ */
+
+#include "hal_stub.h"
+#include "test.h"
+#include "crosslink.h"
+#include "usbd_cdc_if.h"
+#include "utils.h"
+#include "xlink_sim.h"
+#include <stdlib.h>
+#include <string.h>
+
+TEST_DEFINE();
+
+#define USB_PACKET_NS           64000U          /* 64 byte packets at ~1 MB/s */
+#define USB_IN_NS               20000U
+#define UPLOAD_LIMIT_MS         10000U
+
+/* The built-in image, defined by crosslink.c from bitstream_lz4.h; only its size is used */
+extern const uint8_t bitstream_lz4[];
+
+typedef struct {
+    const char *name;
+    xlink_config_t xlink;
+    uint32_t host_stop;                 /* Image bytes the host sends before going quiet, 0 = all */
+} upload_config_t;
+
+static const upload_config_t configs[] = {
+    { "30 ms erase",        { "1 MHz", 1000000,   30,  2 }, 0 },
+    { "1 s erase",          { "1 MHz", 1000000, 1000, 20 }, 0 },
+    { "1.8 s erase",        { "1 MHz", 1000000, 1800, 20 }, 0 },
+    { "host stops at 64 KB", { "1 MHz", 1000000,  30,  2 }, 64U * 1024 },
+};
+
+/* ---- USB device stand-in: the CDC class calls, driven by the host model ---- */
+
+USBD_HandleTypeDef hUsbDeviceFS;
+static USBD_CDC_HandleTypeDef cdc_class;
+
+typedef struct {
+    uint8_t stream[CDC_UPLOAD_HDR_SIZE + XLINK_IMAGE_MAX];
+    size_t len;                         /* Bytes the host will send */
+    size_t pos;
+    uint8_t *rx_buf;
+    bool armed;
+    uint8_t *tx_buf;
+    uint32_t tx_len;
+    char reply[64];
+    size_t reply_len;
+    uint64_t reply_ns;
+} usb_host_t;
+
+static usb_host_t host;
+
+static void usb_out_packet(void *arg) {
+    uint32_t len = (uint32_t)(host.len - host.pos);
+
+    UNUSED(arg);
+    if (len > CDC_DATA_FS_OUT_PACKET_SIZE) {
+        len = CDC_DATA_FS_OUT_PACKET_SIZE;
+    }
+    host.armed = false;
+    memcpy(host.rx_buf, &host.stream[host.pos], len);
+    host.pos += len;
+    USBD_Interface_fops_FS.Receive(host.rx_buf, &len);
+}
+
+static void usb_in_done(void *arg) {
+    uint32_t len = host.tx_len;
+
+    UNUSED(arg);
+    if (host.reply_len + len < sizeof(host.reply)) {
+        memcpy(&host.reply[host.reply_len], host.tx_buf, len);
+        host.reply_len += len;
+        host.reply[host.reply_len] = '\0';
+        host.reply_ns = hal_stub_now();
+    }
+    cdc_class.TxState = 0;
+    USBD_Interface_fops_FS.TransmitCplt(host.tx_buf, &len, 0x81);
+}
+
+uint8_t USBD_CDC_SetRxBuffer(USBD_HandleTypeDef *pdev, uint8_t *pbuff) {
+    UNUSED(pdev);
+    host.rx_buf = pbuff;
+    return USBD_OK;
+}
+
+/* The host sends its next packet as soon as the endpoint is armed; it is NAKed until then */
+uint8_t USBD_CDC_ReceivePacket(USBD_HandleTypeDef *pdev) {
+    UNUSED(pdev);
+    host.armed = true;
+    if (host.pos < host.len) {
+        hal_stub_schedule(USB_PACKET_NS, usb_out_packet, NULL);
+    }
+    return USBD_OK;
+}
+
+uint8_t USBD_CDC_SetTxBuffer(USBD_HandleTypeDef *pdev, uint8_t *pbuff, uint32_t length) {
+    UNUSED(pdev);
+    host.tx_buf = pbuff;
+    host.tx_len = length;
+    return USBD_OK;
+}
+
+uint8_t USBD_CDC_TransmitPacket(USBD_HandleTypeDef *pdev) {
+    UNUSED(pdev);
+    cdc_class.TxState = 1;
+    hal_stub_schedule(USB_IN_NS, usb_in_done, NULL);
+    return USBD_OK;
+}
+
+/* ---- Runs ---- */
+
+static void run(const upload_config_t *cfg, uint32_t image_len) {
+    uint32_t seed = 23, image_crc, upload_start = 0;
+    unsigned long reply_bytes = 0, reply_ms = 0;
+    bool upload_active = false;
+    char reply_status[8] = "";
+    uint8_t *image = &host.stream[CDC_UPLOAD_HDR_SIZE];
+    uint64_t t0;
+
+    // Random content: the slave only checks the length and CRC
+    for (uint32_t i = 0; i < image_len; i++) {
+        image[i] = (uint8_t)test_rand(&seed);
+    }
+    image_crc = util_crc16(image, image_len);
+    memcpy(host.stream, CDC_UPLOAD_MAGIC, 4);
+    memcpy(&host.stream[4], &image_len, sizeof(image_len));
+    host.stream[8] = (uint8_t)image_crc;
+    host.stream[9] = (uint8_t)(image_crc >> 8);
+    host.len = CDC_UPLOAD_HDR_SIZE + (cfg->host_stop ? cfg->host_stop : image_len);
+    host.pos = 0;
+    host.reply_len = 0;
+    xlink_sim_reset(&cfg->xlink, image_len, (uint16_t)image_crc);
+
+    // The device armed the endpoint when the port opened
+    t0 = hal_stub_now();
+    USBD_CDC_ReceivePacket(&hUsbDeviceFS);
+
+    // main.c's loop, reduced to the upload
+    while (host.reply_len == 0 && hal_stub_now() - t0 < UPLOAD_LIMIT_MS * 1000000ULL) {
+        fpga_source_t *upload = CDC_Upload_Request();
+        if (upload != NULL) {
+            if (fpga_configure_start(upload) == HAL_OK) {
+                upload_start = HAL_GetTick();
+                upload_active = true;
+            } else {
+                CDC_Upload_Complete(-1, 0);
+            }
+        }
+        fpga_configure_process();
+        if (upload_active && !fpga_configure_busy()) {
+            upload_active = false;
+            CDC_Upload_Complete((fpga_configure_state() == FPGA_CFG_DONE) ? 0 : -1, HAL_GetTick() - upload_start);
+        }
+        // The loop spins rather than sleeps, so it sees a re-armed endpoint before the host does
+        hal_stub_poll();
+    }
+    // Let the host drain anything still in flight before the next run
+    hal_stub_run_all();
+
+    sscanf(host.reply, "XLNK %7s %lu bytes %lu ms", reply_status, &reply_bytes, &reply_ms);
+    printf("== %s (erase busy %lu ms): reply \"%s %lu bytes %lu ms\", %.1f ms end to end, %.1f KB/s\n\n",
+           cfg->name, (unsigned long)cfg->xlink.erase_ms, reply_status, reply_bytes, reply_ms,
+           (host.reply_ns - t0) / 1e6, reply_bytes / 1.024 / ((host.reply_ns - t0) / 1e6));
+
+    CHECK(host.reply_len > 0);
+    if (cfg->host_stop == 0) {
+        CHECK(strcmp(reply_status, "OK") == 0);
+        CHECK_EQ(reply_bytes, image_len);
+        CHECK_EQ(fpga_configure_state(), FPGA_CFG_DONE);
+        CHECK(xlink.image_ok);
+        CHECK(xlink.exited);
+        CHECK_EQ(xlink.image_len, image_len);
+    } else {
+        // A host that stops sending is given up on after the timeout, and nothing is activated
+        CHECK(strcmp(reply_status, "FAIL") == 0);
+        CHECK_EQ(reply_bytes, cfg->host_stop);
+        CHECK_EQ(fpga_configure_state(), FPGA_CFG_ERROR);
+        CHECK(!xlink.image_ok);
+        CHECK(hal_stub_now() - t0 >= (uint64_t)CDC_UPLOAD_TIMEOUT_MS * 1000000ULL);
+    }
+}
+
+int test_main(void) {
+    uint32_t image_len;
+
+    util_cycles_init();
+    xlink_sim_attach();
+    hUsbDeviceFS.pClassData = &cdc_class;
+    USBD_Interface_fops_FS.Init();
+
+    // As large as the built-in image once decompressed
+    memcpy(&image_len, &bitstream_lz4[4], sizeof(image_len));
+    for (size_t i = 0; i < sizeof(configs) / sizeof(configs[0]); i++) {
+        run(&configs[i], image_len);
+    }
+    return TEST_RESULT();
+}
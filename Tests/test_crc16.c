@@ -0,0 +1,165 @@
+/*
+ * test_crc16.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  util_crc16 slicing-by-8 against the byte-wise table, the generic CRC
+ *  engines against the catalogue check values, and MDMA-fed CRC jobs.
+ */
+
+#include "hal_stub.h"
+#include "test.h"
+#include "crc.h"
+#include "utils.h"
+#include <string.h>
+
+TEST_DEFINE();
+
+static const uint8_t check_msg[] = "123456789";
+static uint8_t data[200000];
+
+static void test_check_values(void) {
+    CHECK_EQ(util_crc16(check_msg, 9), 0x29B1);
+    CHECK_EQ(util_crc16_bytewise(check_msg, 9), 0x29B1);
+    CHECK_EQ(util_crc16(check_msg, 0), 0xFFFF);
+
+    for (int e = CRC_ENGINE_SW; e <= CRC_ENGINE_HW; e++) {
+        CHECK_EQ(crc_compute(&crc16_ccitt_false, e, check_msg, 9), 0x29B1);
+        CHECK_EQ(crc_compute(&crc16_modbus, e, check_msg, 9), 0x4B37);
+        CHECK_EQ(crc_compute(&crc32_iso_hdlc, e, check_msg, 9), 0xCBF43926);
+    }
+    CHECK_EQ(util_hw_crc16(check_msg, 9), 0x29B1);
+}
+
+/* Every length and alignment the 8-byte loop and its tail can see */
+static void test_slicing(void) {
+    uint32_t seed = 0x12345678;
+
+    for (uint32_t len = 0; len <= 64; len++) {
+        for (uint32_t off = 0; off < 8; off++) {
+            CHECK_EQ(util_crc16(&data[off], len), util_crc16_bytewise(&data[off], len));
+        }
+    }
+    for (int i = 0; i < 2000; i++) {
+        uint32_t off = test_rand(&seed) % 64;
+        uint32_t len = test_rand(&seed) % 4096;
+        uint32_t split = len ? test_rand(&seed) % len : 0;
+        uint16_t whole = util_crc16_bytewise(&data[off], len);
+
+        CHECK_EQ(util_crc16(&data[off], len), whole);
+        CHECK_EQ(util_crc16_update(util_crc16_update(0xFFFF, &data[off], split), &data[off + split], len - split),
+                 whole);
+    }
+}
+
+/* A context may switch engines between updates */
+static void test_engines(void) {
+    const crc_params_t *params[] = { &crc16_ccitt_false, &crc16_modbus, &crc32_iso_hdlc };
+    uint32_t seed = 0xCAFEF00D;
+
+    for (size_t p = 0; p < sizeof(params) / sizeof(params[0]); p++) {
+        for (int i = 0; i < 200; i++) {
+            uint32_t len = test_rand(&seed) % 3000;
+            uint32_t split = len ? test_rand(&seed) % len : 0;
+            uint32_t sw = crc_compute(params[p], CRC_ENGINE_SW, data, len);
+            crc_ctx_t ctx;
+
+            CHECK_EQ(crc_compute(params[p], CRC_ENGINE_HW, data, len), sw);
+
+            crc_init(&ctx, params[p], CRC_ENGINE_SW);
+            crc_update(&ctx, data, split);
+            ctx.engine = CRC_ENGINE_HW;
+            crc_update(&ctx, &data[split], len - split);
+            CHECK_EQ(crc_final(&ctx), sw);
+        }
+    }
+}
+
+static int job_calls;
+static uint32_t job_result;
+
+static void job_cb(crc_job_t *job, uint32_t crc) {
+    (void)job;
+    job_calls++;
+    job_result = crc;
+}
+
+static void job_wait(crc_job_t *job) {
+    while (job->status == HAL_BUSY && hal_stub_run_next()) {
+    }
+}
+
+/* Jobs longer than one MDMA block, queued behind each other and behind a claimed unit */
+static void test_jobs(void) {
+    crc_ctx_t ctx_a, ctx_b, holder;
+    crc_job_t a = {0}, b = {0};
+    crc_job_stats_t stats;
+
+    crc_init(&ctx_a, &crc16_ccitt_false, CRC_ENGINE_HW);
+    a.ctx = &ctx_a;
+    a.data = data;
+    a.len = 150000;
+    a.cb = job_cb;
+    CHECK_EQ(crc_job_submit(&a), HAL_OK);
+    CHECK_EQ(a.status, HAL_BUSY);
+    CHECK_EQ(crc_job_submit(&a), HAL_ERROR);
+    job_wait(&a);
+    CHECK_EQ(a.status, HAL_OK);
+    CHECK_EQ(job_calls, 1);
+    CHECK_EQ(job_result, util_crc16(data, 150000));
+
+    // Continue the same context with a second chunk
+    a.data = &data[150000];
+    a.len = 50000;
+    CHECK_EQ(crc_job_submit(&a), HAL_OK);
+    job_wait(&a);
+    CHECK_EQ(job_result, util_crc16(data, 200000));
+
+    // Two jobs on different polynomials, queued while the unit is held
+    crc_init(&holder, &crc32_iso_hdlc, CRC_ENGINE_HW);
+    CHECK(crc_hw_claim(&holder));
+    crc_init(&ctx_a, &crc16_modbus, CRC_ENGINE_HW);
+    crc_init(&ctx_b, &crc32_iso_hdlc, CRC_ENGINE_HW);
+    a = (crc_job_t){ .ctx = &ctx_a, .data = data, .len = 70000, .cb = job_cb };
+    b = (crc_job_t){ .ctx = &ctx_b, .data = &data[1], .len = 70001, .cb = job_cb };
+    CHECK_EQ(crc_job_submit(&a), HAL_OK);
+    CHECK_EQ(crc_job_submit(&b), HAL_OK);
+    CHECK(!hal_stub_run_next());
+    crc_hw_release(&holder);
+    job_wait(&b);
+    CHECK_EQ(a.status, HAL_OK);
+    CHECK_EQ(b.status, HAL_OK);
+    CHECK_EQ(crc_final(&ctx_a), crc_compute(&crc16_modbus, CRC_ENGINE_SW, data, 70000));
+    CHECK_EQ(job_result, crc_compute(&crc32_iso_hdlc, CRC_ENGINE_SW, &data[1], 70001));
+
+    // A cancelled job never calls back and frees the unit
+    job_calls = 0;
+    crc_init(&ctx_a, &crc16_ccitt_false, CRC_ENGINE_HW);
+    a = (crc_job_t){ .ctx = &ctx_a, .data = data, .len = 100000, .cb = job_cb };
+    CHECK_EQ(crc_job_submit(&a), HAL_OK);
+    crc_job_cancel(&a);
+    hal_stub_run_all();
+    CHECK_EQ(a.status, HAL_ERROR);
+    CHECK_EQ(job_calls, 0);
+    CHECK(crc_hw_claim(&holder));
+    crc_hw_release(&holder);
+
+    crc_job_get_stats(&stats);
+    CHECK_EQ(stats.jobs, 4);
+    CHECK_EQ(stats.bytes, 150000 + 50000 + 70000 + 70001);
+}
+
+int test_main(void) {
+    uint32_t seed = 1;
+
+    util_cycles_init();
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)test_rand(&seed);
+    }
+
+    test_check_values();
+    test_slicing();
+    test_engines();
+    test_jobs();
+    return TEST_RESULT();
+}
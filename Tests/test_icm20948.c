@@ -0,0 +1,371 @@
+/*
+ * test_icm20948.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  ICM-20948 driver against a register-file model on the stub I2C bus:
+ *  ICM_FifoParse on its own, the register shadow's transaction savings,
+ *  data-ready sampling and FIFO drains.
+ */
+
+#include "hal_stub.h"
+#include "test.h"
+#include "ICM20948.h"
+#include "crosslink.h"
+#include "utils.h"
+#include <string.h>
+
+TEST_DEFINE();
+
+/* ---- Register-file model ---- */
+
+typedef struct {
+    uint8_t regs[4][128];
+    uint8_t bank;
+    uint8_t ptr;
+    uint8_t fifo[ICM_FIFO_SIZE];
+    uint16_t fifo_count;
+    uint16_t fifo_head;
+    uint32_t resets;
+    uint32_t fifo_resets;
+} icm_model_t;
+
+static icm_model_t icm;
+
+static void icm_model_reset(icm_model_t *m) {
+    memset(m->regs, 0, sizeof(m->regs));
+    m->regs[0][ICM20948_WHO_AM_I_REG] = ICM20948_EXPECTED_ID;
+    m->regs[0][ICM20948_PWR_MGMT_1] = 0x41;
+    m->bank = 0;
+    m->fifo_count = 0;
+    m->fifo_head = 0;
+}
+
+static void icm_model_write_reg(icm_model_t *m, uint8_t reg, uint8_t val) {
+    if (reg == ICM20948_REG_BANK_SEL) {
+        m->bank = (val >> 4) & 0x03;
+        return;
+    }
+    m->regs[m->bank][reg & 0x7F] = val;
+    if (m->bank != 0) {
+        return;
+    }
+    if (reg == ICM20948_PWR_MGMT_1 && (val & 0x80)) {
+        icm_model_reset(m);
+        m->resets++;
+    } else if (reg == ICM20948_FIFO_RST && (val & 0x1F)) {
+        m->fifo_count = 0;
+        m->fifo_head = 0;
+        m->fifo_resets++;
+    }
+}
+
+static uint8_t icm_model_read_reg(icm_model_t *m, uint8_t reg) {
+    if (reg == ICM20948_REG_BANK_SEL) {
+        return (uint8_t)(m->bank << 4);
+    }
+    if (m->bank == 0 && reg == ICM20948_FIFO_COUNTH) {
+        return (uint8_t)((m->fifo_count >> 8) & 0x1F);
+    }
+    if (m->bank == 0 && reg == ICM20948_FIFO_COUNTL) {
+        return (uint8_t)m->fifo_count;
+    }
+    return m->regs[m->bank][reg & 0x7F];
+}
+
+static int icm_model_write(void *ctx, const uint8_t *data, size_t len, bool start, bool stop) {
+    icm_model_t *m = ctx;
+
+    (void)stop;
+    if (start && len > 0) {
+        m->ptr = *data++;
+        len--;
+    }
+    while (len-- > 0) {
+        icm_model_write_reg(m, m->ptr++, *data++);
+    }
+    return 0;
+}
+
+/* Reads auto-increment, except from FIFO_R_W which pops the FIFO */
+static int icm_model_read(void *ctx, uint8_t *data, size_t len, bool start, bool stop) {
+    icm_model_t *m = ctx;
+
+    (void)start;
+    (void)stop;
+    while (len-- > 0) {
+        if (m->bank == 0 && m->ptr == ICM20948_FIFO_R_W) {
+            *data++ = m->fifo_count ? m->fifo[m->fifo_head++ % ICM_FIFO_SIZE] : 0xFF;
+            m->fifo_count -= m->fifo_count ? 1 : 0;
+        } else {
+            *data++ = icm_model_read_reg(m, m->ptr++);
+        }
+    }
+    return 0;
+}
+
+static const hal_stub_i2c_dev_t icm_dev = { icm_model_write, icm_model_read, &icm };
+
+/* Frame i of a test FIFO: accel then gyro, big endian */
+static void frame_values(uint16_t i, int16_t v[6]) {
+    for (int k = 0; k < 6; k++) {
+        v[k] = (int16_t)(i * 16 + k - 3000);
+    }
+}
+
+static void fifo_fill(uint8_t *buf, uint16_t frames) {
+    int16_t v[6];
+
+    for (uint16_t i = 0; i < frames; i++) {
+        frame_values(i, v);
+        for (int k = 0; k < 6; k++) {
+            buf[i * ICM_FIFO_FRAME + 2 * k] = (uint8_t)((uint16_t)v[k] >> 8);
+            buf[i * ICM_FIFO_FRAME + 2 * k + 1] = (uint8_t)v[k];
+        }
+    }
+}
+
+static bool batch_ok(const ICM_FifoBatch *batch, uint16_t frames) {
+    int16_t v[6];
+
+    for (uint16_t i = 0; i < frames; i++) {
+        frame_values(i, v);
+        if (batch->accel[i].x != v[0] || batch->accel[i].y != v[1] || batch->accel[i].z != v[2] ||
+            batch->gyro[i].x != v[3] || batch->gyro[i].y != v[4] || batch->gyro[i].z != v[5]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* ---- Bus arbiter, normally in crosslink.c ---- */
+
+static i2c_bus_owner_t bus_owner = I2C_BUS_FREE;
+
+bool i2c_bus_claim(i2c_bus_owner_t owner) {
+    if (bus_owner != I2C_BUS_FREE && bus_owner != owner) {
+        return false;
+    }
+    bus_owner = owner;
+    return true;
+}
+
+void i2c_bus_release(i2c_bus_owner_t owner) {
+    if (bus_owner == owner) {
+        bus_owner = I2C_BUS_FREE;
+    }
+}
+
+i2c_bus_owner_t i2c_bus_owner(void) {
+    return bus_owner;
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
+    ICM_I2C_ErrorCallback(hi2c);
+}
+
+static void exti(void *arg) {
+    (void)arg;
+    ICM_EXTI_Callback();
+}
+
+/* ---- Tests ---- */
+
+static ICM_FifoBatch batch;
+static uint8_t fifo_buf[ICM_FIFO_SIZE];
+
+static void test_fifo_parse(void) {
+    fifo_fill(fifo_buf, ICM_FIFO_MAX_FRAMES);
+
+    CHECK_EQ(ICM_FifoParse(fifo_buf, 120, 120, &batch), 10);
+    CHECK(!batch.overflow);
+    CHECK(batch_ok(&batch, 10));
+
+    // Not a whole number of frames: the FIFO lost alignment
+    CHECK_EQ(ICM_FifoParse(fifo_buf, 120, 125, &batch), 10);
+    CHECK(batch.overflow);
+
+    // Within one frame of full: snapshot mode stopped writing
+    CHECK_EQ(ICM_FifoParse(fifo_buf, 4092, 4092, &batch), 341);
+    CHECK(batch.overflow);
+    CHECK(batch_ok(&batch, 341));
+    CHECK_EQ(ICM_FifoParse(fifo_buf, 4080, 4080, &batch), 340);
+    CHECK(!batch.overflow);
+
+    // Fewer bytes read than counted, and nothing at all
+    CHECK_EQ(ICM_FifoParse(fifo_buf, 60, 120, &batch), 5);
+    CHECK_EQ(ICM_FifoParse(fifo_buf, 0, 0, &batch), 0);
+    CHECK(!batch.overflow);
+    CHECK_EQ(batch.frames, 0);
+}
+
+static uint32_t transactions(void) {
+    ICM_BusStats stats;
+
+    ICM_GetBusStats(&stats);
+    return stats.transactions;
+}
+
+/* Accel, gyro, temperature and mag per sample; only the first one reconfigures SLV0 */
+static void test_shadow(void) {
+    ICM_BusStats stats;
+    ICM_Axis3D v;
+    uint32_t t0;
+
+    icm_model_reset(&icm);
+    CHECK_EQ(ICM_WHOAMI(), ICM20948_EXPECTED_ID);
+    CHECK_EQ(ICM_Init(), HAL_OK);
+    CHECK_EQ(icm.resets, 1);
+    icm.regs[0][ICM20948_ACCEL_XOUT_H] = 0x12;
+    icm.regs[0][ICM20948_ACCEL_XOUT_L] = 0x34;
+    icm.regs[0][ICM20948_EXT_SENS_DATA_00] = 0x78;
+    icm.regs[0][ICM20948_EXT_SENS_DATA_01] = 0x56;
+    CHECK_EQ(icm.bank, 0);
+    CHECK_EQ(icm.regs[2][ICM20948_ACCEL_CONFIG], 0x06);
+    CHECK_EQ(icm.regs[3][ICM20948_I2C_SLV0_CTRL], 0x81);
+
+    // Re-selecting bank 0 at the end of init is already in effect
+    ICM_GetBusStats(&stats);
+    CHECK(stats.bank_skipped >= 1);
+
+    for (int sample = 0; sample < 3; sample++) {
+        t0 = transactions();
+        CHECK_EQ(ICM_ReadAccel(&v), HAL_OK);
+        CHECK_EQ(v.x, 0x1234);
+        CHECK_EQ(ICM_ReadGyro(&v), HAL_OK);
+        ICM_ReadTemperature();
+        CHECK_EQ(ICM_ReadMag(&v), HAL_OK);
+        CHECK_EQ(v.x, 0x5678);
+        CHECK_EQ(transactions() - t0, sample == 0 ? 9 : 4);
+    }
+    CHECK_EQ(icm.regs[3][ICM20948_I2C_SLV0_ADDR], 0x80 | AK09916_ADDRESS);
+    CHECK_EQ(icm.regs[3][ICM20948_I2C_SLV0_CTRL], 0x86);
+    CHECK_EQ(icm.bank, 0);
+
+    // Only WHO_AM_I and the temperature bytes are read back, the rest comes from the shadow
+    t0 = transactions();
+    ICM_DumpRegisters();
+    CHECK_EQ(transactions() - t0, 3);
+    CHECK_EQ(icm.bank, 0);
+}
+
+static void test_drdy(void) {
+    ICM_SamplingStats stats;
+    ICM_Sample sample;
+    uint64_t edge;
+
+    for (int i = 0; i < ICM_BURST_LEN; i++) {
+        icm.regs[0][ICM_BURST_REG + i] = (uint8_t)(0x10 + i);
+    }
+    CHECK_EQ(ICM_StartSampling(), HAL_OK);
+    CHECK(hal_stub_irq_enabled(ICM_INT_EXTI_IRQn));
+    CHECK_EQ(icm.regs[0][ICM20948_INT_ENABLE_1], 0x01);
+    CHECK(bus_owner == I2C_BUS_FREE);
+
+    // One edge, one burst read
+    edge = util_cycles();
+    hal_stub_irq(exti, NULL);
+    CHECK(bus_owner == I2C_BUS_IMU);
+    CHECK(!ICM_GetSample(&sample));
+    hal_stub_run_all();
+    CHECK(bus_owner == I2C_BUS_FREE);
+    CHECK(ICM_GetSample(&sample));
+    CHECK_EQ(sample.timestamp, edge);
+    CHECK_EQ(sample.accel.x, 0x1011);
+    CHECK_EQ(sample.gyro.z, 0x1A1B);
+    CHECK_EQ(sample.temp, 0x1C1D);
+    CHECK_EQ(sample.mag.x, 0x1F1E);
+    CHECK_EQ(sample.mag_status, 0x10 + 21);
+
+    // An edge during the read is an overrun, one while the FPGA holds the bus is skipped
+    hal_stub_irq(exti, NULL);
+    hal_stub_irq(exti, NULL);
+    hal_stub_run_all();
+    CHECK(i2c_bus_claim(I2C_BUS_FPGA));
+    hal_stub_irq(exti, NULL);
+    i2c_bus_release(I2C_BUS_FPGA);
+
+    // A NACKed read counts as an error and frees the bus
+    hal_stub_i2c_attach(ICM20948_ADDR, NULL);
+    hal_stub_irq(exti, NULL);
+    hal_stub_run_all();
+    hal_stub_i2c_attach(ICM20948_ADDR, &icm_dev);
+    CHECK(bus_owner == I2C_BUS_FREE);
+
+    ICM_GetSamplingStats(&stats);
+    CHECK_EQ(stats.samples, 2);
+    CHECK_EQ(stats.overruns, 1);
+    CHECK_EQ(stats.bus_busy, 1);
+    CHECK_EQ(stats.errors, 1);
+
+    ICM_StopSampling();
+    CHECK(!hal_stub_irq_enabled(ICM_INT_EXTI_IRQn));
+    CHECK_EQ(icm.regs[0][ICM20948_INT_ENABLE_1], 0x00);
+}
+
+/* Poll ICM_FifoProcess like the main loop, servicing interrupts in between */
+static bool fifo_poll(uint32_t max_ms) {
+    uint64_t end = hal_stub_now() + (uint64_t)max_ms * 1000000ULL;
+
+    while (hal_stub_now() < end) {
+        if (ICM_FifoProcess(&batch)) {
+            return true;
+        }
+        if (!hal_stub_run_next()) {
+            HAL_Delay(1);
+        }
+    }
+    return false;
+}
+
+static void test_fifo_drain(void) {
+    ICM_SamplingStats stats;
+
+    CHECK_EQ(ICM_StartFifo(0), HAL_ERROR);
+    CHECK_EQ(ICM_StartFifo(20), HAL_OK);
+    CHECK_EQ(icm.regs[0][ICM20948_FIFO_EN_2], 0x1E);
+    CHECK_EQ(icm.fifo_resets, 1);
+
+    // Not due before ~20 frames at 1125 Hz have had time to collect
+    fifo_fill(icm.fifo, 25);
+    icm.fifo_count = 25 * ICM_FIFO_FRAME;
+    CHECK(!ICM_FifoProcess(&batch));
+    CHECK_EQ(icm.fifo_count, 25 * ICM_FIFO_FRAME);
+    CHECK(fifo_poll(50));
+    CHECK_EQ(batch.frames, 25);
+    CHECK(!batch.overflow);
+    CHECK(batch_ok(&batch, 25));
+    CHECK_EQ(icm.fifo_count, 0);
+
+    // A full FIFO, ~92 ms on the bus: drained, flagged, then reset to realign
+    fifo_fill(icm.fifo, 341);
+    icm.fifo_count = 4092;
+    icm.fifo_head = 0;
+    CHECK(fifo_poll(200));
+    CHECK_EQ(batch.frames, 341);
+    CHECK(batch.overflow);
+    CHECK(batch_ok(&batch, 341));
+    CHECK(!fifo_poll(5));
+    CHECK_EQ(icm.fifo_resets, 2);
+
+    ICM_GetSamplingStats(&stats);
+    CHECK_EQ(stats.batches, 2);
+    CHECK_EQ(stats.samples, 25 + 341);
+    CHECK_EQ(stats.fifo_overflows, 1);
+    CHECK_EQ(stats.errors, 0);
+
+    ICM_StopSampling();
+    CHECK_EQ(icm.regs[0][ICM20948_FIFO_EN_2], 0x00);
+    CHECK(bus_owner == I2C_BUS_FREE);
+}
+
+int test_main(void) {
+    util_cycles_init();
+    hal_stub_i2c_attach(ICM20948_ADDR, &icm_dev);
+
+    test_fifo_parse();
+    test_shadow();
+    test_drdy();
+    test_fifo_drain();
+    return TEST_RESULT();
+}
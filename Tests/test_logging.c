@@ -0,0 +1,312 @@
+/*
+ * test_logging.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Multi-producer stress of the log ring: producer threads stand in for
+ *  thread code and ISRs logging at once, while the test thread services
+ *  the UART TX DMA interrupts. Every line that reaches the wire must be
+ *  intact and in order per producer, and every line that does not must be
+ *  accounted for in the drop counters. Then a second sink next to the
+ *  UART: fan-out, lapping a slow sink, detaching mid-transfer and errors.
+ *  Last, UART DMA setups per KB logged, against the 32 per KB the old
+ *  32-byte transfer cap needed.
+ */
+
+#include "hal_stub.h"
+#include "test.h"
+#include "logging.h"
+#include "utils.h"
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+TEST_DEFINE();
+
+#define PRODUCERS       4
+#define MESSAGES        20000
+#define LINE_MAX        64
+
+typedef struct {
+    pthread_t thread;
+    unsigned id;
+} producer_t;
+
+static producer_t producers[PRODUCERS];
+static volatile int producers_done;
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+    logging_UART_TxCpltCallback(huart);
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
+    logging_UART_ErrorCallback(huart);
+}
+
+static size_t payload_len(unsigned id, unsigned seq) {
+    return (seq * 7U + id) % 40U;
+}
+
+static char payload_char(unsigned id, unsigned seq, size_t k) {
+    return (char)('a' + (seq + id + k) % 26U);
+}
+
+static void *producer(void *arg) {
+    producer_t *p = arg;
+    char payload[LINE_MAX];
+
+    for (unsigned seq = 0; seq < MESSAGES; seq++) {
+        size_t n = payload_len(p->id, seq);
+
+        for (size_t k = 0; k < n; k++) {
+            payload[k] = payload_char(p->id, seq, k);
+        }
+        payload[n] = '\0';
+        log_printf_policy(LOG_POLICY_DROP_NEWEST, "T%u %06u %s\n", p->id, seq, payload);
+        if ((seq & 63U) == 0) {
+            sched_yield();
+        }
+    }
+    __atomic_add_fetch(&producers_done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static unsigned next_seq[PRODUCERS];
+static uint32_t lines, bad_lines, out_of_order;
+static uint64_t wire_bytes;
+
+static void check_line(const char *line, size_t len) {
+    unsigned id, seq;
+    int off = 0;
+
+    if (sscanf(line, "T%u %6u %n", &id, &seq, &off) != 2 || off != 10 || id >= PRODUCERS ||
+        len != (size_t)off + payload_len(id, seq)) {
+        bad_lines++;
+        return;
+    }
+    for (size_t k = 0; k < payload_len(id, seq); k++) {
+        if (line[off + k] != payload_char(id, seq, k)) {
+            bad_lines++;
+            return;
+        }
+    }
+    if (seq < next_seq[id]) {
+        out_of_order++;
+    }
+    next_seq[id] = seq + 1;
+    lines++;
+}
+
+/* Split what came out of the UART into lines; a partial one is carried over */
+static void collect(void) {
+    static char carry[LINE_MAX * 2];
+    static size_t carry_len;
+    static uint8_t chunk[1U << 16];
+    size_t n;
+
+    while ((n = hal_stub_uart_take(chunk, sizeof(chunk))) > 0) {
+        wire_bytes += n;
+        for (size_t i = 0; i < n; i++) {
+            if (chunk[i] == '\n') {
+                carry[carry_len] = '\0';
+                check_line(carry, carry_len);
+                carry_len = 0;
+            } else if (carry_len < sizeof(carry) - 1) {
+                carry[carry_len++] = (char)chunk[i];
+            } else {
+                bad_lines++;
+                carry_len = 0;
+            }
+        }
+    }
+}
+
+static void test_producers(void) {
+    logging_stats_t stats;
+    uint64_t sent;
+
+    for (unsigned i = 0; i < PRODUCERS; i++) {
+        producers[i].id = i;
+        CHECK_EQ(hal_stub_thread_create(&producers[i].thread, producer, &producers[i]), 0);
+    }
+
+    // This thread is the interrupt context: it completes UART DMA transfers as they come due
+    while (__atomic_load_n(&producers_done, __ATOMIC_ACQUIRE) < PRODUCERS) {
+        if (!hal_stub_run_next()) {
+            sched_yield();
+        }
+        collect();
+    }
+    for (unsigned i = 0; i < PRODUCERS; i++) {
+        pthread_join(producers[i].thread, NULL);
+    }
+    hal_stub_run_all();
+    collect();
+
+    logging_get_stats(&stats);
+    sent = (uint64_t)PRODUCERS * MESSAGES;
+    printf("%lu lines on the wire, %lu dropped, %llu bytes\n", (unsigned long)lines,
+           (unsigned long)stats.policy[LOG_POLICY_DROP_NEWEST].dropped, (unsigned long long)wire_bytes);
+    CHECK_EQ(bad_lines, 0);
+    CHECK_EQ(out_of_order, 0);
+    CHECK(lines > 0);
+    CHECK_EQ(stats.policy[LOG_POLICY_DROP_NEWEST].messages, sent);
+    CHECK_EQ(lines + stats.policy[LOG_POLICY_DROP_NEWEST].dropped, sent);
+    CHECK_EQ(stats.written, wire_bytes);
+}
+
+/* ---- Sinks sharing the ring ---- */
+
+static uint8_t mem_out[1U << 16];
+static size_t mem_len;
+static uint64_t mem_delay_ns;
+
+static void mem_done(void *arg) {
+    logging_sink_done(arg);
+}
+
+static int mem_send(log_sink_t *sink, const uint8_t *data, size_t len) {
+    memcpy(&mem_out[mem_len], data, len);
+    mem_len += len;
+    hal_stub_schedule(mem_delay_ns, mem_done, sink);
+    return HAL_OK;
+}
+
+static log_sink_t mem_sink = {
+    .name = "mem",
+    .send = mem_send,
+};
+
+static uint8_t uart_out[1U << 16];
+static char expect[1U << 16];
+
+static size_t uart_take_all(void) {
+    return hal_stub_uart_take(uart_out, sizeof(uart_out));
+}
+
+/* Bytes queued, or 0 if the line was dropped */
+static size_t log_line(unsigned i) {
+    int n = log_printf_policy(LOG_POLICY_DROP_NEWEST, "line %04u ................................\n", i);
+    return (n > 0) ? (size_t)n : 0;
+}
+
+static void test_sinks(void) {
+    logging_stats_t before, after;
+    size_t n, len = 0;
+
+    hal_stub_run_all();
+    uart_take_all();
+    logging_get_stats(&before);
+
+    // Both sinks get the whole stream
+    hal_stub_uart_set_baud(10000000);
+    mem_delay_ns = 1000;
+    CHECK(logging_sink_attach(&mem_sink));
+    for (unsigned i = 0; i < 10; i++) {
+        len += log_line(i);
+    }
+    hal_stub_run_all();
+    CHECK_EQ(mem_len, len);
+    CHECK_EQ(uart_take_all(), len);
+    CHECK(memcmp(mem_out, uart_out, len) == 0);
+
+    // A UART slower than the log rate is lapped by the faster sink instead of holding the ring
+    hal_stub_uart_set_baud(1000000);
+    mem_len = 0;
+    len = 0;
+    for (unsigned i = 0; i < 100; i++) {
+        CHECK(log_line(i) > 0);
+        len += snprintf(&expect[len], sizeof(expect) - len, "line %04u ................................\n", i);
+        hal_stub_advance(200000);
+    }
+    CHECK_EQ(mem_len, len);
+    CHECK(memcmp(mem_out, expect, len) == 0);
+    hal_stub_run_all();
+    n = uart_take_all();
+    CHECK(n > 0 && n < len);
+    CHECK(n > 0 && n < len && memcmp(&uart_out[n - 43], &expect[len - 43], 43) == 0);
+
+    // Detached mid-transfer: the span completes, then the sink stops holding the ring
+    hal_stub_uart_set_baud(10000000);
+    mem_delay_ns = 1000000;
+    mem_len = 0;
+    log_line(100);
+    logging_sink_detach(&mem_sink);
+    for (unsigned i = 101; i < 200; i++) {
+        CHECK(log_line(i) > 0);
+        hal_stub_advance(100000);
+    }
+    hal_stub_run_all();
+    CHECK_EQ(mem_len, 43);
+    CHECK_EQ(uart_take_all(), 100 * 43);
+
+    // A failed UART transfer loses its span only
+    hal_stub_uart_fail_next();
+    log_line(200);
+    hal_stub_run_all();
+    log_line(201);
+    hal_stub_run_all();
+    CHECK_EQ(uart_take_all(), 43);
+    CHECK(memcmp(uart_out, "line 0201", 9) == 0);
+
+    logging_get_stats(&after);
+    CHECK_EQ(after.policy[LOG_POLICY_DROP_NEWEST].dropped, before.policy[LOG_POLICY_DROP_NEWEST].dropped);
+}
+
+/* ---- UART DMA setups per KB ---- */
+
+#define DMA_BURST_LINES     20          /* 860 bytes, within the 1 KB ring */
+#define DMA_LOG_BYTES       (64U * 1024)
+
+/* Logs DMA_LOG_BYTES in bursts of `burst` lines, draining the UART between bursts */
+static void dma_setups(const char *name, unsigned burst, double *per_kb, double *chained_pct) {
+    hal_stub_uart_stats_t before, after;
+    size_t len = 0, n;
+
+    hal_stub_run_all();
+    uart_take_all();
+    hal_stub_uart_get_stats(&before);
+    for (unsigned i = 0; len < DMA_LOG_BYTES; i++) {
+        len += log_line(i);
+        if ((i + 1) % burst == 0) {
+            hal_stub_run_all();
+        }
+    }
+    hal_stub_run_all();
+    n = uart_take_all();
+    hal_stub_uart_get_stats(&after);
+
+    CHECK_EQ(n, len);
+    CHECK_EQ(after.dma_bytes - before.dma_bytes, len);
+    *per_kb = (after.dma_setups - before.dma_setups) * 1024.0 / len;
+    *chained_pct = 100.0 * (after.dma_chained - before.dma_chained) / (after.dma_setups - before.dma_setups);
+    printf("%-22s  %8lu bytes  %6lu setups  %5.1f/KB  %5.1f%% chained\n", name, (unsigned long)len,
+           (unsigned long)(after.dma_setups - before.dma_setups), *per_kb, *chained_pct);
+}
+
+static void test_dma_setups(void) {
+    double burst_kb, burst_chained, trickle_kb, trickle_chained;
+
+    hal_stub_uart_set_baud(921600);
+    // A burst starts one transfer; the rest is chained from the completion callback in 256-byte blocks
+    dma_setups("20-line bursts", DMA_BURST_LINES, &burst_kb, &burst_chained);
+    // One line at a time on an idle UART: one setup per line, plus the rest of a line split by the wrap
+    dma_setups("one line at a time", 1, &trickle_kb, &trickle_chained);
+    printf("old 32-byte cap: 32.0/KB at best\n");
+
+    CHECK(burst_kb < 8.0);
+    CHECK(burst_chained > 50.0);
+    CHECK(trickle_kb < 32.0);
+    CHECK(trickle_chained < 10.0);
+}
+
+int test_main(void) {
+    util_cycles_init();
+    hal_stub_uart_set_baud(10000000);
+    init_dma_logging();
+
+    test_producers();
+    test_sinks();
+    test_dma_setups();
+    return TEST_RESULT();
+}
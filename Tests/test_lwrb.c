@@ -0,0 +1,149 @@
+/*
+ * test_lwrb.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  LwRB word copy at every alignment, reserve/commit across the wrap, and a
+ *  randomized run against a reference FIFO.
+ */
+
+#include "hal_stub.h"
+#include "test.h"
+#include "lwrb.h"
+#include <string.h>
+
+TEST_DEFINE();
+
+#define GUARD           16
+#define GUARD_BYTE      0xA5
+
+static uint8_t pattern[4096];
+
+static bool guards_ok(const uint8_t *area, size_t size) {
+    for (size_t i = 0; i < GUARD; i++) {
+        if (area[i] != GUARD_BYTE || area[GUARD + size + i] != GUARD_BYTE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Put the empty ring's read and write pointers at `pos` */
+static void ring_seek(lwrb_t *rb, size_t pos) {
+    lwrb_reset(rb);
+    lwrb_advance(rb, pos);
+    lwrb_skip(rb, pos);
+}
+
+/* Every source, ring and destination alignment, short and long lengths, wrapping or not */
+static void test_word_copy(void) {
+    static uint8_t area[GUARD + 257 + GUARD];
+    static uint8_t dst[GUARD + 300 + GUARD];
+    static const size_t lens[] = { 0, 1, 3, 4, 7, 8, 15, 16, 17, 31, 32, 33, 63, 100, 200, 255, 256 };
+    lwrb_t rb;
+
+    memset(area, GUARD_BYTE, sizeof(area));
+    lwrb_init(&rb, &area[GUARD], 257);
+
+    for (size_t pos = 0; pos < 257; pos += (pos < 16 || pos > 240) ? 1 : 13) {
+        for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+            for (size_t a = 0; a < 8; a++) {
+                size_t len = lens[l];
+                size_t b = (a * 3) & 7;
+
+                ring_seek(&rb, pos);
+                memset(dst, GUARD_BYTE, sizeof(dst));
+                CHECK_EQ(lwrb_write(&rb, &pattern[a], len), len);
+                CHECK_EQ(lwrb_get_full(&rb), len);
+                CHECK_EQ(lwrb_read(&rb, &dst[GUARD + b], len), len);
+                CHECK(memcmp(&dst[GUARD + b], &pattern[a], len) == 0);
+                CHECK(dst[GUARD + b - 1] == GUARD_BYTE && dst[GUARD + b + len] == GUARD_BYTE);
+                CHECK(guards_ok(area, 257));
+            }
+        }
+    }
+}
+
+static void test_reserve_commit(void) {
+    static uint8_t area[GUARD + 16 + GUARD];
+    uint8_t out[16];
+    lwrb_span_t span;
+    lwrb_t rb;
+
+    memset(area, GUARD_BYTE, sizeof(area));
+    lwrb_init(&rb, &area[GUARD], 16);
+    ring_seek(&rb, 10);
+
+    // 12 bytes from offset 10 of a 16 byte ring: 6 at the end, 6 at the start
+    CHECK_EQ(lwrb_reserve(&rb, 12, &span), 12);
+    CHECK(span.data[0] == &area[GUARD + 10] && span.len[0] == 6);
+    CHECK(span.data[1] == &area[GUARD] && span.len[1] == 6);
+    CHECK_EQ(lwrb_get_full(&rb), 0);
+    memcpy(span.data[0], pattern, 6);
+    memcpy(span.data[1], &pattern[6], 6);
+    CHECK_EQ(lwrb_commit(&rb, 12), 12);
+    CHECK_EQ(lwrb_read(&rb, out, sizeof(out)), 12);
+    CHECK(memcmp(out, pattern, 12) == 0);
+
+    // Capped at the free space (size - 1), and nothing to reserve when full
+    CHECK_EQ(lwrb_reserve(&rb, 100, &span), 15);
+    CHECK_EQ(span.len[0] + span.len[1], 15);
+    CHECK_EQ(lwrb_commit(&rb, 4), 4);
+    CHECK_EQ(lwrb_reserve(&rb, 100, &span), 11);
+    CHECK_EQ(lwrb_commit(&rb, 100), 11);
+    CHECK_EQ(lwrb_reserve(&rb, 1, &span), 0);
+    CHECK(span.data[0] == NULL && span.len[0] == 0 && span.len[1] == 0);
+    CHECK_EQ(lwrb_reserve(&rb, 0, &span), 0);
+    CHECK(guards_ok(area, 16));
+}
+
+/* Random writes and reads against a plain FIFO */
+static void test_random(void) {
+    static uint8_t ring[97];
+    static uint8_t model[1 << 16];
+    static uint8_t tmp[128];
+    size_t head = 0, tail = 0;
+    uint32_t seed = 42;
+    lwrb_t rb;
+
+    lwrb_init(&rb, ring, sizeof(ring));
+    for (int i = 0; i < 20000; i++) {
+        size_t n = test_rand(&seed) % 64;
+
+        if (test_rand(&seed) & 1) {
+            size_t room = sizeof(ring) - 1 - (head - tail);
+            size_t put = (n < room) ? n : room;
+            for (size_t k = 0; k < n; k++) {
+                tmp[k] = (uint8_t)test_rand(&seed);
+            }
+            CHECK_EQ(lwrb_write(&rb, tmp, n), put);
+            for (size_t k = 0; k < put; k++) {
+                model[head++ & 0xFFFF] = tmp[k];
+            }
+        } else {
+            size_t avail = head - tail;
+            size_t get = (n < avail) ? n : avail;
+            bool ok = true;
+            CHECK_EQ(lwrb_read(&rb, tmp, n), get);
+            for (size_t k = 0; k < get; k++) {
+                ok &= tmp[k] == model[tail++ & 0xFFFF];
+            }
+            CHECK(ok);
+        }
+        CHECK_EQ(lwrb_get_full(&rb), head - tail);
+        CHECK_EQ(lwrb_get_free(&rb), sizeof(ring) - 1 - (head - tail));
+    }
+}
+
+int test_main(void) {
+    uint32_t seed = 3;
+
+    for (size_t i = 0; i < sizeof(pattern); i++) {
+        pattern[i] = (uint8_t)test_rand(&seed);
+    }
+
+    test_word_copy();
+    test_reserve_commit();
+    test_random();
+    return TEST_RESULT();
+}
@@ -0,0 +1,250 @@
+/*
+ * test_lwrb_mq.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  lwrb_mq record queue: framing, drops, peek/release across the wrap,
+ *  reserve/commit, a randomized run against a reference queue, and a
+ *  producer thread against the consumer with records checked whole and
+ *  every one that is missing accounted for in the drop count.
+ */
+
+#include "hal_stub.h"
+#include "test.h"
+#include "lwrb_mq.h"
+#include <sched.h>
+#include <string.h>
+
+TEST_DEFINE();
+
+static uint8_t pattern[4096];
+
+static size_t span_copy(const lwrb_span_t *span, uint8_t *out) {
+    memcpy(out, span->data[0], span->len[0]);
+    if (span->len[1] > 0) {
+        memcpy(&out[span->len[0]], span->data[1], span->len[1]);
+    }
+    return span->len[0] + span->len[1];
+}
+
+static void test_mq(void) {
+    static uint8_t ring[64];
+    lwrb_span_t spans[8];
+    lwrb_span_t span;
+    uint8_t out[64];
+    lwrb_mq_t mq;
+
+    CHECK(lwrb_mq_init(&mq, ring, sizeof(ring)));
+    CHECK_EQ(lwrb_mq_count(&mq), 0);
+    CHECK_EQ(lwrb_mq_get(&mq, out, sizeof(out)), 0);
+
+    // 63 usable bytes: three 19-byte records (21 with the prefix) fit, a fourth does not
+    for (int i = 0; i < 3; i++) {
+        CHECK(lwrb_mq_put(&mq, &pattern[i * 19], 19));
+    }
+    CHECK(!lwrb_mq_put(&mq, pattern, 1));
+    CHECK_EQ(mq.dropped, 1);
+    CHECK(!lwrb_mq_put(&mq, pattern, 0));
+    CHECK_EQ(mq.dropped, 1);
+    CHECK_EQ(lwrb_mq_count(&mq), 3);
+
+    CHECK_EQ(lwrb_mq_peek(&mq, 2, &span), 19);
+    CHECK_EQ(span_copy(&span, out), 19);
+    CHECK(memcmp(out, &pattern[38], 19) == 0);
+    CHECK_EQ(lwrb_mq_peek(&mq, 3, &span), 0);
+
+    CHECK_EQ(lwrb_mq_get(&mq, out, 10), 10);
+    CHECK(memcmp(out, pattern, 10) == 0);
+    CHECK_EQ(lwrb_mq_count(&mq), 2);
+
+    // The next records wrap, one of them with its length prefix split across the end
+    CHECK(lwrb_mq_put(&mq, &pattern[100], 19));
+    CHECK_EQ(lwrb_mq_release(&mq, 1), 1);
+    CHECK(lwrb_mq_put(&mq, &pattern[200], 4));
+    CHECK(lwrb_mq_put(&mq, &pattern[300], 7));
+    CHECK_EQ(lwrb_mq_peek_batch(&mq, spans, 8), 4);
+    CHECK_EQ(span_copy(&spans[0], out), 19);
+    CHECK(memcmp(out, &pattern[38], 19) == 0);
+    CHECK_EQ(span_copy(&spans[1], out), 19);
+    CHECK(memcmp(out, &pattern[100], 19) == 0);
+    CHECK_EQ(span_copy(&spans[2], out), 4);
+    CHECK(memcmp(out, &pattern[200], 4) == 0);
+    CHECK_EQ(span_copy(&spans[3], out), 7);
+    CHECK(memcmp(out, &pattern[300], 7) == 0);
+    CHECK_EQ(lwrb_mq_peek_batch(&mq, spans, 2), 2);
+    CHECK_EQ(lwrb_mq_release(&mq, 10), 4);
+    CHECK_EQ(lwrb_mq_count(&mq), 0);
+
+    // Reserve in place, commit fewer bytes than reserved
+    CHECK_EQ(lwrb_mq_reserve(&mq, 30, &span), 30);
+    CHECK_EQ(lwrb_mq_count(&mq), 0);
+    memcpy(span.data[0], &pattern[400], span.len[0]);
+    if (span.len[1] > 0) {
+        memcpy(span.data[1], &pattern[400 + span.len[0]], span.len[1]);
+    }
+    CHECK(lwrb_mq_commit(&mq, 12));
+    CHECK_EQ(lwrb_mq_get(&mq, out, sizeof(out)), 12);
+    CHECK(memcmp(out, &pattern[400], 12) == 0);
+    CHECK_EQ(lwrb_mq_reserve(&mq, 62, &span), 0);
+    CHECK_EQ(mq.dropped, 2);
+}
+
+/* Random records through every wrap position */
+static void test_mq_random(void) {
+    static uint8_t ring[211];
+    static uint16_t lens[256];
+    static uint32_t offs[256];
+    uint8_t out[80];
+    size_t head = 0, tail = 0, used = 0;
+    uint32_t seed = 7, dropped = 0;
+    lwrb_mq_t mq;
+
+    lwrb_mq_init(&mq, ring, sizeof(ring));
+    for (int i = 0; i < 20000; i++) {
+        if (test_rand(&seed) % 3 != 0) {
+            uint16_t len = (uint16_t)(1 + test_rand(&seed) % 70);
+            uint32_t off = test_rand(&seed) % 1024;
+            bool fits = used + LWRB_MQ_HDR_SIZE + len <= sizeof(ring) - 1;
+
+            CHECK_EQ(lwrb_mq_put(&mq, &pattern[off], len), fits);
+            if (fits) {
+                lens[head & 255] = len;
+                offs[head & 255] = off;
+                head++;
+                used += LWRB_MQ_HDR_SIZE + len;
+            } else {
+                dropped++;
+            }
+        } else if (tail < head) {
+            uint16_t len = lens[tail & 255];
+            CHECK_EQ(lwrb_mq_get(&mq, out, sizeof(out)), len);
+            CHECK(memcmp(out, &pattern[offs[tail & 255]], len) == 0);
+            used -= LWRB_MQ_HDR_SIZE + len;
+            tail++;
+        } else {
+            CHECK_EQ(lwrb_mq_get(&mq, out, sizeof(out)), 0);
+        }
+        CHECK_EQ(lwrb_mq_count(&mq), head - tail);
+    }
+    CHECK_EQ(mq.dropped, dropped);
+}
+
+/* ---- Producer thread ---- */
+
+#define MT_RECORDS      200000
+#define MT_REC_MAX      100
+
+typedef struct {
+    pthread_t thread;
+    bool retry;                         /* Put again until it fits instead of dropping */
+    uint32_t failed;                    /* Puts that did not fit */
+} mt_producer_t;
+
+static lwrb_mq_t mt_mq;
+static uint8_t mt_ring[1024];
+static volatile int mt_done;
+
+static size_t mt_len(uint32_t seq) {
+    return 4 + (seq * 13U) % (MT_REC_MAX - 4);
+}
+
+static void mt_record(uint8_t *rec, uint32_t seq) {
+    memcpy(rec, &seq, sizeof(seq));
+    memcpy(&rec[4], &pattern[seq % 1024], mt_len(seq) - 4);
+}
+
+/* Half the records through lwrb_mq_put, half built in place */
+static bool mt_put(uint32_t seq) {
+    uint8_t rec[MT_REC_MAX];
+    size_t len = mt_len(seq);
+    lwrb_span_t span;
+
+    mt_record(rec, seq);
+    if (seq & 1) {
+        return lwrb_mq_put(&mt_mq, rec, len);
+    }
+    if (lwrb_mq_reserve(&mt_mq, len, &span) != len) {
+        return false;
+    }
+    memcpy(span.data[0], rec, span.len[0]);
+    if (span.len[1] > 0) {
+        memcpy(span.data[1], &rec[span.len[0]], span.len[1]);
+    }
+    return lwrb_mq_commit(&mt_mq, len);
+}
+
+static void *mt_producer(void *arg) {
+    mt_producer_t *p = arg;
+
+    for (uint32_t seq = 0; seq < MT_RECORDS; seq++) {
+        while (!mt_put(seq)) {
+            p->failed++;
+            if (!p->retry) {
+                break;
+            }
+            sched_yield();
+        }
+        if ((seq & 63) == 0) {
+            sched_yield();
+        }
+    }
+    __atomic_store_n(&mt_done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+/* Records arrive whole and in order; what is missing was counted as dropped */
+static void test_threads(bool retry) {
+    mt_producer_t producer = { .retry = retry };
+    uint8_t rec[MT_REC_MAX], want[MT_REC_MAX];
+    uint32_t received = 0, bad = 0, seq, next = 0;
+    size_t len;
+    bool done = false;
+
+    mt_done = 0;
+    lwrb_mq_init(&mt_mq, mt_ring, sizeof(mt_ring));
+    CHECK_EQ(hal_stub_thread_create(&producer.thread, mt_producer, &producer), 0);
+
+    while (!done || lwrb_mq_count(&mt_mq) > 0) {
+        len = lwrb_mq_get(&mt_mq, rec, sizeof(rec));
+        if (len == 0) {
+            // The last record may have been dropped: stop once the producer is gone and the queue empty
+            done = __atomic_load_n(&mt_done, __ATOMIC_ACQUIRE) != 0;
+            sched_yield();
+            continue;
+        }
+        memcpy(&seq, rec, sizeof(seq));
+        received++;
+        if (seq < next || seq >= MT_RECORDS || len != mt_len(seq)) {
+            bad++;
+            continue;
+        }
+        mt_record(want, seq);
+        bad += memcmp(rec, want, len) != 0;
+        next = seq + 1;
+    }
+    pthread_join(producer.thread, NULL);
+
+    printf("producer %s: %lu records received, %lu puts did not fit\n", retry ? "retrying" : "dropping",
+           (unsigned long)received, (unsigned long)producer.failed);
+    CHECK_EQ(bad, 0);
+    CHECK_EQ(mt_mq.dropped, producer.failed);
+    if (retry) {
+        CHECK_EQ(received, MT_RECORDS);
+    } else {
+        CHECK_EQ(received + producer.failed, MT_RECORDS);
+    }
+}
+
+int test_main(void) {
+    uint32_t seed = 3;
+
+    for (size_t i = 0; i < sizeof(pattern); i++) {
+        pattern[i] = (uint8_t)test_rand(&seed);
+    }
+
+    test_mq();
+    test_mq_random();
+    test_threads(false);
+    test_threads(true);
+    return TEST_RESULT();
+}
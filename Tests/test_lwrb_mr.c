@@ -0,0 +1,239 @@
+/*
+ * test_lwrb_mr.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Multi-reader ring: fan-out to several readers, free space held by the
+ *  slowest one, lossy readers skipping ahead, claim/commit across the wrap
+ *  and out of order, and writer threads claiming concurrently.
+ */
+
+#include "hal_stub.h"
+#include "test.h"
+#include "lwrb_mr.h"
+#include <sched.h>
+#include <string.h>
+
+TEST_DEFINE();
+
+static uint8_t pattern[4096];
+
+/* Put the empty ring's write position and every attached reader at `pos` */
+static void ring_seek(lwrb_mr_t *rb, size_t pos) {
+    rb->w = rb->w_claim = rb->w_done = pos;
+    for (size_t i = 0; i < LWRB_MR_MAX_READERS; i++) {
+        if (rb->readers[i] != NULL) {
+            rb->readers[i]->r = pos;
+        }
+    }
+}
+
+static void test_fanout(void) {
+    static uint8_t ring[64];
+    lwrb_mr_reader_t a, b, c, extra[LWRB_MR_MAX_READERS];
+    uint8_t out[64];
+    lwrb_mr_t rb;
+    int attached = 0;
+
+    CHECK(!lwrb_mr_init(&rb, ring, 48));
+    CHECK(lwrb_mr_init(&rb, ring, sizeof(ring)));
+    CHECK(lwrb_mr_attach(&rb, &a, 0));
+    CHECK(lwrb_mr_attach(&rb, &b, 0));
+    CHECK(lwrb_mr_attach(&rb, &c, 0));
+    CHECK_EQ(lwrb_mr_get_free(&rb), 64);
+
+    // Every reader gets the same bytes; all of the buffer is usable
+    CHECK_EQ(lwrb_mr_write(&rb, pattern, 40), 40);
+    CHECK_EQ(lwrb_mr_get_full(&rb, &a), 40);
+    CHECK_EQ(lwrb_mr_read(&rb, &a, out, sizeof(out)), 40);
+    CHECK(memcmp(out, pattern, 40) == 0);
+    CHECK_EQ(lwrb_mr_read(&rb, &b, out, 10), 10);
+    CHECK(memcmp(out, pattern, 10) == 0);
+
+    // Free space is what the slowest reader leaves
+    CHECK_EQ(lwrb_mr_get_free(&rb), 24);
+    CHECK_EQ(lwrb_mr_write(&rb, &pattern[40], 40), 24);
+    CHECK_EQ(lwrb_mr_write(&rb, pattern, 1), 0);
+    CHECK_EQ(lwrb_mr_skip(&rb, &c, 30), 30);
+    CHECK_EQ(lwrb_mr_get_free(&rb), 10);
+
+    // A linear block stops at the end of the buffer
+    CHECK_EQ(lwrb_mr_get_linear_block_read_length(&rb, &c), 34);
+    CHECK(lwrb_mr_get_linear_block_read_address(&rb, &c) == &ring[30]);
+    CHECK_EQ(lwrb_mr_skip(&rb, &c, 100), 34);
+    CHECK_EQ(lwrb_mr_get_full(&rb, &a), 24);
+    CHECK_EQ(lwrb_mr_read(&rb, &b, out, sizeof(out)), 54);
+    CHECK(memcmp(out, &pattern[10], 54) == 0);
+
+    // A detached reader holds nothing back; a new one starts at the write position
+    lwrb_mr_detach(&rb, &a);
+    CHECK_EQ(lwrb_mr_get_free(&rb), 64);
+    CHECK(lwrb_mr_attach(&rb, &a, 0));
+    CHECK_EQ(lwrb_mr_get_full(&rb, &a), 0);
+    for (size_t i = 0; i < LWRB_MR_MAX_READERS; i++) {
+        attached += lwrb_mr_attach(&rb, &extra[i], 0);
+    }
+    CHECK_EQ(attached, LWRB_MR_MAX_READERS - 3);
+}
+
+static void test_lossy(void) {
+    static uint8_t ring[32];
+    lwrb_mr_reader_t slow, fast;
+    uint8_t out[32];
+    lwrb_mr_t rb;
+
+    lwrb_mr_init(&rb, ring, sizeof(ring));
+    CHECK(lwrb_mr_attach(&rb, &slow, 1));
+    CHECK(lwrb_mr_attach(&rb, &fast, 0));
+
+    // The lossy reader never holds the writer back
+    for (int i = 0; i < 4; i++) {
+        CHECK_EQ(lwrb_mr_write(&rb, &pattern[i * 20], 20), 20);
+        CHECK_EQ(lwrb_mr_read(&rb, &fast, out, 20), 20);
+        CHECK(memcmp(out, &pattern[i * 20], 20) == 0);
+    }
+
+    // Overrun: it skips to the oldest byte still there and counts what it lost
+    CHECK_EQ(lwrb_mr_get_full(&rb, &slow), 32);
+    CHECK_EQ(slow.lost, 48);
+    CHECK_EQ(lwrb_mr_read(&rb, &slow, out, sizeof(out)), 32);
+    CHECK(memcmp(out, &pattern[48], 32) == 0);
+    CHECK_EQ(lwrb_mr_write(&rb, &pattern[80], 5), 5);
+    CHECK_EQ(lwrb_mr_read(&rb, &slow, out, sizeof(out)), 5);
+    CHECK(memcmp(out, &pattern[80], 5) == 0);
+    CHECK_EQ(slow.lost, 48);
+}
+
+static void test_claim_commit(void) {
+    static uint8_t ring[16];
+    lwrb_mr_reader_t reader;
+    lwrb_span_t s1, s2;
+    uint8_t out[16];
+    lwrb_mr_t rb;
+
+    lwrb_mr_init(&rb, ring, sizeof(ring));
+    lwrb_mr_attach(&rb, &reader, 0);
+    ring_seek(&rb, 10);
+
+    // 12 bytes from offset 10 of a 16 byte ring: 6 at the end, 6 at the start
+    CHECK_EQ(lwrb_mr_claim(&rb, 12, 12, &s1), 12);
+    CHECK(s1.data[0] == &ring[10] && s1.len[0] == 6);
+    CHECK(s1.data[1] == ring && s1.len[1] == 6);
+    CHECK_EQ(lwrb_mr_get_free(&rb), 4);
+    CHECK_EQ(lwrb_mr_get_full(&rb, &reader), 0);
+
+    // Short of space: min decides between a partial claim and none
+    CHECK_EQ(lwrb_mr_claim(&rb, 8, 5, &s2), 0);
+    CHECK(s2.data[0] == NULL && s2.len[0] == 0 && s2.len[1] == 0);
+    CHECK_EQ(lwrb_mr_claim(&rb, 8, 4, &s2), 4);
+    CHECK(s2.data[0] == &ring[6] && s2.len[0] == 4 && s2.len[1] == 0);
+
+    // The later claim commits first: nothing is visible until the earlier one is in
+    memcpy(s2.data[0], &pattern[12], 4);
+    lwrb_mr_commit(&rb, 4);
+    CHECK_EQ(lwrb_mr_get_full(&rb, &reader), 0);
+    memcpy(s1.data[0], pattern, 6);
+    memcpy(s1.data[1], &pattern[6], 6);
+    lwrb_mr_commit(&rb, 12);
+    CHECK_EQ(lwrb_mr_get_full(&rb, &reader), 16);
+    CHECK_EQ(lwrb_mr_read(&rb, &reader, out, sizeof(out)), 16);
+    CHECK(memcmp(out, pattern, 16) == 0);
+
+    CHECK_EQ(lwrb_mr_claim(&rb, 0, 0, &s1), 0);
+    CHECK_EQ(lwrb_mr_claim(&rb, 4, 4, NULL), 0);
+}
+
+/* ---- Concurrent writers ---- */
+
+#define WRITERS         4
+#define RECORDS         50000
+#define REC_SIZE        12
+
+typedef struct {
+    pthread_t thread;
+    uint8_t id;
+} writer_t;
+
+static writer_t writers[WRITERS];
+static lwrb_mr_t mt_ring;
+static uint8_t mt_data[256];
+
+static void make_record(uint8_t *rec, uint8_t id, uint32_t seq) {
+    rec[0] = id;
+    memcpy(&rec[1], &seq, sizeof(seq));
+    for (size_t k = 5; k < REC_SIZE; k++) {
+        rec[k] = (uint8_t)(seq * 31U + id + k);
+    }
+}
+
+static void *writer(void *arg) {
+    writer_t *wr = arg;
+    uint8_t rec[REC_SIZE];
+    lwrb_span_t span;
+
+    for (uint32_t seq = 0; seq < RECORDS; seq++) {
+        make_record(rec, wr->id, seq);
+        while (lwrb_mr_claim(&mt_ring, REC_SIZE, REC_SIZE, &span) == 0) {
+            sched_yield();
+        }
+        memcpy(span.data[0], rec, span.len[0]);
+        if (span.len[1] > 0) {
+            memcpy(span.data[1], &rec[span.len[0]], span.len[1]);
+        }
+        lwrb_mr_commit(&mt_ring, REC_SIZE);
+    }
+    return NULL;
+}
+
+/* Records from every writer arrive whole and in order per writer */
+static void test_threads(void) {
+    lwrb_mr_reader_t reader;
+    uint8_t rec[REC_SIZE], want[REC_SIZE];
+    uint32_t next[WRITERS] = { 0 }, bad = 0, total = 0;
+    uint32_t seq;
+
+    lwrb_mr_init(&mt_ring, mt_data, sizeof(mt_data));
+    lwrb_mr_attach(&mt_ring, &reader, 0);
+    for (uint8_t i = 0; i < WRITERS; i++) {
+        writers[i].id = i;
+        CHECK_EQ(hal_stub_thread_create(&writers[i].thread, writer, &writers[i]), 0);
+    }
+
+    while (total < WRITERS * RECORDS) {
+        if (lwrb_mr_get_full(&mt_ring, &reader) < REC_SIZE) {
+            sched_yield();
+            continue;
+        }
+        lwrb_mr_read(&mt_ring, &reader, rec, REC_SIZE);
+        memcpy(&seq, &rec[1], sizeof(seq));
+        total++;
+        if (rec[0] >= WRITERS) {
+            bad++;
+            continue;
+        }
+        make_record(want, rec[0], seq);
+        bad += seq != next[rec[0]] || memcmp(rec, want, REC_SIZE) != 0;
+        next[rec[0]] = seq + 1;
+    }
+    for (int i = 0; i < WRITERS; i++) {
+        pthread_join(writers[i].thread, NULL);
+    }
+    CHECK_EQ(bad, 0);
+    CHECK_EQ(total, WRITERS * RECORDS);
+    CHECK_EQ(mt_ring.w, mt_ring.w_claim);
+    CHECK_EQ(lwrb_mr_get_full(&mt_ring, &reader), 0);
+}
+
+int test_main(void) {
+    uint32_t seed = 5;
+
+    for (size_t i = 0; i < sizeof(pattern); i++) {
+        pattern[i] = (uint8_t)test_rand(&seed);
+    }
+
+    test_fanout();
+    test_lossy();
+    test_claim_commit();
+    test_threads();
+    return TEST_RESULT();
+}
@@ -0,0 +1,305 @@
+/*
+ * test_lz4.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  lz4_block_decompress on hand-built sequences and malformed blocks, random
+ *  round trips through a small greedy compressor, and XLZ4 containers
+ *  through fpga_source_init_lz4.
+ */
+
+#include "hal_stub.h"
+#include "test.h"
+#include "fpga_source.h"
+#include "lz4_block.h"
+#include "utils.h"
+#include <string.h>
+
+TEST_DEFINE();
+
+#define DATA_MAX        20000
+
+static uint8_t raw[DATA_MAX];
+static uint8_t packed[DATA_MAX + DATA_MAX / 255 + 64];
+static uint8_t out[DATA_MAX];
+
+static int decode(const uint8_t *src, size_t len, size_t cap) {
+    return lz4_block_decompress(src, len, out, cap);
+}
+
+/* ---- Greedy compressor (the same block format Tools/bitpack.py writes) ---- */
+
+static uint8_t *put_len(uint8_t *op, size_t n) {
+    while (n >= 255) {
+        *op++ = 255;
+        n -= 255;
+    }
+    *op++ = (uint8_t)n;
+    return op;
+}
+
+static uint8_t *emit(uint8_t *op, const uint8_t *lit, size_t lit_len, size_t match_len, size_t offset) {
+    uint8_t *token = op++;
+
+    *token = (uint8_t)((lit_len < 15 ? lit_len : 15) << 4);
+    if (lit_len >= 15) {
+        op = put_len(op, lit_len - 15);
+    }
+    memcpy(op, lit, lit_len);
+    op += lit_len;
+    if (match_len == 0) {
+        return op;
+    }
+    *token |= (uint8_t)(match_len - 4 < 15 ? match_len - 4 : 15);
+    *op++ = (uint8_t)offset;
+    *op++ = (uint8_t)(offset >> 8);
+    if (match_len - 4 >= 15) {
+        op = put_len(op, match_len - 4 - 15);
+    }
+    return op;
+}
+
+static size_t compress(const uint8_t *src, size_t len, uint8_t *dst) {
+    static uint32_t table[4096];        /* Position + 1 of the last 4-byte key with this hash */
+    size_t pos = 0, anchor = 0;
+    uint8_t *op = dst;
+
+    memset(table, 0, sizeof(table));
+    while (len >= 13 && pos + 12 <= len) {
+        uint32_t key;
+        uint32_t h;
+        size_t cand;
+
+        memcpy(&key, &src[pos], 4);
+        h = (key * 2654435761U) >> 20;
+        cand = table[h];
+        table[h] = (uint32_t)pos + 1;
+        if (cand == 0 || pos - (cand - 1) > 0xFFFF || memcmp(&src[cand - 1], &src[pos], 4) != 0) {
+            pos++;
+            continue;
+        }
+        cand--;
+
+        // Matches may overlap the bytes they produce; the last 5 bytes stay literal
+        size_t match_len = 4;
+        while (pos + match_len < len - 5 && src[cand + match_len] == src[pos + match_len]) {
+            match_len++;
+        }
+        op = emit(op, &src[anchor], pos - anchor, match_len, pos - cand);
+        pos += match_len;
+        anchor = pos;
+    }
+    op = emit(op, &src[anchor], len - anchor, 0, 0);
+    return (size_t)(op - dst);
+}
+
+/* ---- Hand-built blocks ---- */
+
+static void test_sequences(void) {
+    static const uint8_t literals[] = { 0x50, 'h', 'e', 'l', 'l', 'o' };
+    static const uint8_t run[] = { 0x16, 'a', 0x01, 0x00, 0x00 };
+    static const uint8_t pair[] = { 0x2F, 'a', 'b', 0x02, 0x00, 255, 10, 0x10, 'z' };
+    static uint8_t long_lit[3 + 300];
+    size_t n = 0;
+
+    CHECK_EQ(decode(literals, sizeof(literals), sizeof(out)), 5);
+    CHECK(memcmp(out, "hello", 5) == 0);
+    CHECK_EQ(decode(literals, sizeof(literals), 5), 5);
+    CHECK_EQ(decode(literals, 0, sizeof(out)), 0);
+
+    // Offset 1: a run of the previous byte, overlapping its own output
+    CHECK_EQ(decode(run, sizeof(run), sizeof(out)), 11);
+    CHECK(memcmp(out, "aaaaaaaaaaa", 11) == 0);
+
+    // Match length 4 + 15 + 255 + 10 through two extension bytes
+    CHECK_EQ(decode(pair, sizeof(pair), sizeof(out)), 2 + 284 + 1);
+    for (int i = 0; i < 286; i++) {
+        CHECK_EQ(out[i], "ab"[i & 1]);
+    }
+    CHECK_EQ(out[286], 'z');
+
+    // 300 literals: 15 + 255 + 30
+    long_lit[n++] = 0xF0;
+    long_lit[n++] = 255;
+    long_lit[n++] = 30;
+    for (int i = 0; i < 300; i++) {
+        long_lit[n++] = (uint8_t)i;
+    }
+    CHECK_EQ(decode(long_lit, n, sizeof(out)), 300);
+    CHECK_EQ(out[299], (uint8_t)299);
+
+    // Exactly 15 literals still takes a (zero) extension byte
+    uint8_t fifteen[2 + 15] = { 0xF0, 0 };
+    CHECK_EQ(decode(fifteen, sizeof(fifteen), sizeof(out)), 15);
+}
+
+static void test_malformed(void) {
+    static const uint8_t offset_zero[] = { 0x14, 'x', 0x00, 0x00, 0x00 };
+    static const uint8_t offset_before[] = { 0x24, 'x', 'y', 0x03, 0x00, 0x00 };
+    static const uint8_t short_literals[] = { 0x50, 'a', 'b' };
+    static const uint8_t short_offset[] = { 0x14, 'x', 0x01 };
+    static const uint8_t short_lit_ext[] = { 0xF0 };
+    static const uint8_t short_match_ext[] = { 0x1F, 'x', 0x01, 0x00 };
+    static const uint8_t run[] = { 0x16, 'a', 0x01, 0x00, 0x00 };
+    static const uint8_t literals[] = { 0x50, 'h', 'e', 'l', 'l', 'o' };
+
+    CHECK_EQ(decode(offset_zero, sizeof(offset_zero), sizeof(out)), -1);
+    CHECK_EQ(decode(offset_before, sizeof(offset_before), sizeof(out)), -1);
+    CHECK_EQ(decode(short_literals, sizeof(short_literals), sizeof(out)), -1);
+    CHECK_EQ(decode(short_offset, sizeof(short_offset), sizeof(out)), -1);
+    CHECK_EQ(decode(short_lit_ext, sizeof(short_lit_ext), sizeof(out)), -1);
+    CHECK_EQ(decode(short_match_ext, sizeof(short_match_ext), sizeof(out)), -1);
+
+    // Output capacity: literals and matches are both bounded
+    CHECK_EQ(decode(literals, sizeof(literals), 4), -1);
+    CHECK_EQ(decode(run, sizeof(run), 11), 11);
+    CHECK_EQ(decode(run, sizeof(run), 10), -1);
+}
+
+static void fill(uint8_t *buf, size_t len, int kind, uint32_t *seed) {
+    static const char text[] = "Lattice Semiconductor Corporation Bitstream ";
+
+    for (size_t i = 0; i < len; i++) {
+        switch (kind) {
+        case 0:                                 /* Incompressible */
+            buf[i] = (uint8_t)test_rand(seed);
+            break;
+        case 1:                                 /* Runs, like the erased parts of a bitstream */
+            buf[i] = (test_rand(seed) % 64 == 0) ? (uint8_t)test_rand(seed) : (i ? buf[i - 1] : 0xFF);
+            break;
+        default:                                /* Repeated text with noise */
+            buf[i] = (test_rand(seed) % 32 == 0) ? (uint8_t)test_rand(seed) : (uint8_t)text[i % (sizeof(text) - 1)];
+            break;
+        }
+    }
+}
+
+static void test_round_trip(void) {
+    uint32_t seed = 0xBADC0DE;
+
+    for (int i = 0; i < 300; i++) {
+        size_t len = test_rand(&seed) % DATA_MAX;
+        size_t plen;
+
+        fill(raw, len, i % 3, &seed);
+        plen = compress(raw, len, packed);
+        CHECK_EQ(decode(packed, plen, len), (int)len);
+        CHECK(memcmp(out, raw, len) == 0);
+        if (len > 0) {
+            CHECK_EQ(decode(packed, plen, len - 1), -1);
+            CHECK_EQ(decode(packed, plen - 1, len), -1);
+        }
+    }
+}
+
+/* ---- XLZ4 containers ---- */
+
+static uint8_t image[DATA_MAX + 2 * (DATA_MAX / 256 + 1) + 1024];
+
+static void put16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static size_t pack(const uint8_t *src, size_t len, uint16_t block_size) {
+    size_t n = 12;
+
+    memcpy(image, "XLZ4", 4);
+    image[4] = (uint8_t)len;
+    image[5] = (uint8_t)(len >> 8);
+    image[6] = (uint8_t)(len >> 16);
+    image[7] = (uint8_t)(len >> 24);
+    put16(&image[8], block_size);
+    put16(&image[10], util_crc16(src, (uint32_t)len));
+
+    for (size_t off = 0; off < len; off += block_size) {
+        size_t blen = (len - off < block_size) ? len - off : block_size;
+        size_t plen = compress(&src[off], blen, &image[n + 2]);
+
+        if (plen >= blen) {
+            memcpy(&image[n + 2], &src[off], blen);
+            put16(&image[n], (uint16_t)(0x8000 | blen));
+            plen = blen;
+        } else {
+            put16(&image[n], (uint16_t)plen);
+        }
+        n += 2 + plen;
+    }
+    return n;
+}
+
+/* Drain a source; returns the bytes produced, or -1 if a chunk failed */
+static int drain(fpga_source_t *src, uint8_t *dst) {
+    size_t total = 0;
+
+    while (total < src->total) {
+        const uint8_t *chunk;
+        int len = src->acquire(src, &chunk);
+
+        if (len <= 0) {
+            return -1;
+        }
+        memcpy(&dst[total], chunk, (size_t)len);
+        total += (size_t)len;
+        src->release(src);
+    }
+    return (int)total;
+}
+
+static void test_container(void) {
+    static fpga_lz4_source_t src;
+    static fpga_raw_source_t raw_src;
+    const uint8_t *chunk;
+    uint32_t seed = 99;
+    size_t n;
+
+    // Compressible blocks with one incompressible (stored) block in the middle
+    fill(raw, DATA_MAX, 2, &seed);
+    fill(&raw[8192], 4096, 0, &seed);
+    n = pack(raw, DATA_MAX, 4096);
+    CHECK_EQ(fpga_source_init_lz4(&src, image, n), 0);
+    CHECK_EQ(src.base.total, DATA_MAX);
+    CHECK(src.base.has_crc);
+    CHECK_EQ(src.base.crc16, util_crc16(raw, DATA_MAX));
+    CHECK_EQ(drain(&src.base, out), DATA_MAX);
+    CHECK(memcmp(out, raw, DATA_MAX) == 0);
+    CHECK_EQ(src.base.acquire(&src.base, &chunk), -1);
+
+    // A truncated image fails on the block it cuts into
+    CHECK_EQ(fpga_source_init_lz4(&src, image, n - 1), 0);
+    CHECK_EQ(drain(&src.base, out), -1);
+
+    // A block that decodes short of the block size is an error
+    n = pack(raw, 1000, 4096);
+    image[4] = (uint8_t)(1001 & 0xFF);
+    image[5] = (uint8_t)(1001 >> 8);
+    CHECK_EQ(fpga_source_init_lz4(&src, image, n), 0);
+    CHECK_EQ(src.base.acquire(&src.base, &chunk), -1);
+
+    // Bad magic, block size 0 or above FPGA_LZ4_BLOCK_MAX
+    n = pack(raw, 1000, 512);
+    image[0] = 'x';
+    CHECK_EQ(fpga_source_init_lz4(&src, image, n), -1);
+    image[0] = 'X';
+    put16(&image[8], 0);
+    CHECK_EQ(fpga_source_init_lz4(&src, image, n), -1);
+    put16(&image[8], FPGA_LZ4_BLOCK_MAX + 1);
+    CHECK_EQ(fpga_source_init_lz4(&src, image, n), -1);
+    CHECK_EQ(fpga_source_init_lz4(&src, image, 11), -1);
+
+    // Raw images are handed out in place, FPGA_RAW_CHUNK_SIZE at a time
+    CHECK_EQ(fpga_source_init_raw(&raw_src, raw, DATA_MAX), 0);
+    CHECK_EQ(raw_src.base.acquire(&raw_src.base, &chunk), FPGA_RAW_CHUNK_SIZE);
+    CHECK(chunk == raw);
+    CHECK_EQ(fpga_source_init_raw(&raw_src, raw, DATA_MAX), 0);
+    CHECK_EQ(drain(&raw_src.base, out), DATA_MAX);
+    CHECK(memcmp(out, raw, DATA_MAX) == 0);
+}
+
+int test_main(void) {
+    test_sequences();
+    test_malformed();
+    test_round_trip();
+    test_container();
+    return TEST_RESULT();
+}
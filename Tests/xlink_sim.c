@@ -0,0 +1,170 @@
+/*
+ * xlink_sim.c
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "xlink_sim.h"
+#include "hal_stub.h"
+#include "ICM20948.h"
+#include "utils.h"
+#include <string.h>
+
+xlink_t xlink;
+static uint8_t xlink_image[XLINK_IMAGE_MAX];
+
+static bool xlink_busy(const xlink_t *x) {
+    return hal_stub_now() < x->busy_until;
+}
+
+static uint32_t xlink_status(const xlink_t *x) {
+    uint32_t status = x->status;
+
+    if (xlink_busy(x)) {
+        status |= XLINK_STATUS_BUSY;
+    } else if (x->image_ok) {
+        status |= XLINK_STATUS_DONE;
+    }
+    return status;
+}
+
+/* The write carrying the bitstream has ended */
+static void xlink_program_end(xlink_t *x) {
+    x->in_bitstream = false;
+    x->programming = false;
+    x->image_ok = x->image_len == x->image_want && util_crc16(xlink_image, (uint32_t)x->image_len) == x->image_crc;
+    if (!x->image_ok) {
+        x->status |= XLINK_STATUS_FAIL;
+    }
+    x->busy_until = hal_stub_now() + (uint64_t)x->cfg->done_ms * 1000000ULL;
+}
+
+/* Returns non-zero to NACK */
+static int xlink_execute(xlink_t *x) {
+    static const uint8_t key[] = { 0xFF, 0xA4, 0xC6, 0xF4, 0x8A };
+
+    x->cmd_pending = false;
+    if (x->cmd_len == sizeof(key) && memcmp(x->cmd, key, sizeof(key)) == 0) {
+        // Only taken while the device is held in reset
+        x->activated = HAL_GPIO_ReadPin(GPIOC, GPIO_PIN_9) == GPIO_PIN_RESET;
+        return x->activated ? 0 : -1;
+    }
+    if (!x->activated || x->cmd_len != 4) {
+        return -1;
+    }
+
+    switch (x->cmd[0]) {
+    case 0xE0:
+    case 0x3C:
+    case 0xC0:
+        x->read_cmd = x->cmd[0];
+        return 0;
+    case 0xC6:
+        x->enabled = true;
+        return 0;
+    case 0x0E:
+        if (!x->enabled) {
+            return -1;
+        }
+        x->erased = true;
+        x->image_ok = false;
+        x->status &= ~XLINK_STATUS_FAIL;
+        x->busy_until = hal_stub_now() + (uint64_t)x->cfg->erase_ms * 1000000ULL;
+        return 0;
+    case 0x46:
+        if (!x->erased || xlink_busy(x)) {
+            x->status |= XLINK_STATUS_FAIL;
+            return 0;
+        }
+        x->programming = true;
+        return 0;
+    case 0x26:
+        x->exited = x->image_ok;
+        return 0;
+    default:
+        return -1;
+    }
+}
+
+static int xlink_write(void *ctx, const uint8_t *data, size_t len, bool start, bool stop) {
+    xlink_t *x = ctx;
+
+    if (start) {
+        x->cmd_len = 0;
+    }
+    for (size_t i = 0; i < len; i++) {
+        if (x->in_bitstream) {
+            if (x->image_len < sizeof(xlink_image)) {
+                xlink_image[x->image_len] = data[i];
+            }
+            x->image_len++;
+        } else if (x->cmd_len < sizeof(x->cmd)) {
+            x->cmd[x->cmd_len++] = data[i];
+            x->cmd_pending = true;
+            // Program (0x7A): the rest of this write is the bitstream
+            if (x->cmd_len == 4 && x->cmd[0] == 0x7A && x->programming) {
+                x->cmd_pending = false;
+                x->in_bitstream = true;
+                x->image_len = 0;
+            }
+        } else {
+            return -1;
+        }
+    }
+    if (!stop) {
+        return 0;
+    }
+    if (x->in_bitstream) {
+        xlink_program_end(x);
+        return 0;
+    }
+    return x->cmd_pending ? xlink_execute(x) : 0;
+}
+
+static int xlink_read(void *ctx, uint8_t *data, size_t len, bool start, bool stop) {
+    xlink_t *x = ctx;
+    uint32_t value;
+
+    UNUSED(start);
+    UNUSED(stop);
+    // A command followed by a repeated START runs before its result is read
+    if (x->cmd_pending && xlink_execute(x) != 0) {
+        return -1;
+    }
+    switch (x->read_cmd) {
+    case 0xE0:
+        value = XLINK_IDCODE;
+        break;
+    case 0x3C:
+        value = xlink_status(x);
+        break;
+    case 0xC0:
+        value = XLINK_USERCODE;
+        break;
+    default:
+        return -1;
+    }
+    for (size_t i = 0; i < len; i++) {
+        data[i] = (i < 4) ? (uint8_t)(value >> (24 - 8 * i)) : 0xFF;
+    }
+    return 0;
+}
+
+static const hal_stub_i2c_dev_t xlink_dev = { xlink_write, xlink_read, &xlink };
+
+/* No IMU on the simulated bus */
+void ICM_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
+    UNUSED(hi2c);
+}
+
+void xlink_sim_attach(void) {
+    hal_stub_i2c_attach(XLINK_ADDR, &xlink_dev);
+}
+
+void xlink_sim_reset(const xlink_config_t *cfg, uint32_t image_len, uint16_t image_crc) {
+    memset(&xlink, 0, sizeof(xlink));
+    xlink.cfg = cfg;
+    xlink.image_want = image_len;
+    xlink.image_crc = image_crc;
+    hal_stub_i2c_set_clock(cfg->i2c_hz);
+}
@@ -0,0 +1,63 @@
+/*
+ * xlink_sim.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Simulated LIF-MD6000 CrossLink slave on the stub I2C bus: activation key,
+ *  IDCODE, enable, erase, status, program, usercode and exit, with the busy
+ *  times of erase and of the DONE check set per run. A test resets it with
+ *  the image it expects, configures the device, then checks what arrived.
+ */
+
+#ifndef XLINK_SIM_H_
+#define XLINK_SIM_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define XLINK_ADDR              0x40
+#define XLINK_IDCODE            0x01010043UL    /* LIF-MD6000 */
+#define XLINK_USERCODE          0x00000001UL
+#define XLINK_IMAGE_MAX         (256U * 1024)
+
+#define XLINK_STATUS_DONE       (1UL << 8)
+#define XLINK_STATUS_BUSY       (1UL << 12)
+#define XLINK_STATUS_FAIL       (1UL << 13)
+
+typedef struct {
+    const char *name;
+    uint32_t i2c_hz;
+    uint32_t erase_ms;                  /* BUSY after erase (0x0E) */
+    uint32_t done_ms;                   /* BUSY after the bitstream, before DONE */
+} xlink_config_t;
+
+typedef struct {
+    const xlink_config_t *cfg;
+    uint8_t cmd[8];
+    size_t cmd_len;
+    bool cmd_pending;                   /* Written, not yet executed */
+    uint8_t read_cmd;                   /* Command whose result a read returns */
+    bool activated;
+    bool enabled;
+    bool erased;
+    bool programming;
+    bool in_bitstream;
+    bool image_ok;
+    bool exited;
+    uint32_t status;
+    uint64_t busy_until;
+    size_t image_len;
+    uint32_t image_want;
+    uint16_t image_crc;
+} xlink_t;
+
+extern xlink_t xlink;
+
+/* Put the slave on the bus at XLINK_ADDR */
+void xlink_sim_attach(void);
+
+/* Power-on state, expecting an image of `image_len` bytes with CRC16 `image_crc` */
+void xlink_sim_reset(const xlink_config_t *cfg, uint32_t image_len, uint16_t image_crc);
+
+#endif /* XLINK_SIM_H_ */
@@ -0,0 +1,198 @@
+#!/usr/bin/env python3
+"""
+bitpack.py - pack a Lattice CrossLink bitstream for the H743 FPGA loader.
+
+The image is split into fixed-size blocks that are LZ4-block compressed
+independently, so the firmware only needs one block of RAM per stage to
+decompress and stream it to the FPGA. Container layout (little endian):
+
+    0   char[4]  magic "XLZ4"
+    4   uint32   raw image size
+    8   uint16   block size
+    10  uint16   CRC16-CCITT (poly 0x1021, init 0xFFFF) of the raw image
+    12  blocks:  uint16 length (bit 15 set = stored uncompressed), payload
+
+Usage:
+    bitpack.py input.bit  output.h [--name bitstream_lz4] [--block 4096]
+    bitpack.py bitstream.h output.h      (reads the C array of an existing header)
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+MAGIC = b"XLZ4"
+STORED = 0x8000
+
+MIN_MATCH = 4
+LAST_LITERALS = 5
+MF_LIMIT = 12
+MAX_OFFSET = 0xFFFF
+
+
+def crc16_ccitt(data, crc=0xFFFF):
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def _put_len(out, n):
+    while n >= 255:
+        out.append(255)
+        n -= 255
+    out.append(n)
+
+
+def _emit(out, literals, match_len, offset):
+    lit_len = len(literals)
+    token = (min(lit_len, 15) << 4)
+    if match_len:
+        token |= min(match_len - MIN_MATCH, 15)
+    out.append(token)
+    if lit_len >= 15:
+        _put_len(out, lit_len - 15)
+    out += literals
+    if match_len:
+        out += struct.pack("<H", offset)
+        if match_len - MIN_MATCH >= 15:
+            _put_len(out, match_len - MIN_MATCH - 15)
+
+
+def lz4_block_compress(src, chain_depth=64):
+    """Greedy LZ4 block compressor with a short hash chain."""
+    n = len(src)
+    out = bytearray()
+    anchor = 0
+    pos = 0
+    heads = {}
+    prev = [0] * n
+    match_limit = n - LAST_LITERALS
+
+    while pos + MF_LIMIT <= n:
+        key = src[pos:pos + MIN_MATCH]
+        best_len, best_off = 0, 0
+        cand = heads.get(key, -1)
+        depth = chain_depth
+        while cand >= 0 and pos - cand <= MAX_OFFSET and depth:
+            length = 0
+            while pos + length < match_limit and src[cand + length] == src[pos + length]:
+                length += 1
+            if length > best_len:
+                best_len, best_off = length, pos - cand
+            cand = prev[cand]
+            depth -= 1
+        prev[pos] = heads.get(key, -1)
+        heads[key] = pos
+
+        if best_len >= MIN_MATCH:
+            _emit(out, src[anchor:pos], best_len, best_off)
+            for p in range(pos + 1, min(pos + best_len, n - MIN_MATCH)):
+                k = src[p:p + MIN_MATCH]
+                prev[p] = heads.get(k, -1)
+                heads[k] = p
+            pos += best_len
+            anchor = pos
+        else:
+            pos += 1
+
+    _emit(out, src[anchor:], 0, 0)
+    return bytes(out)
+
+
+def lz4_block_decompress(src, size):
+    """Reference decoder, used to self-check every packed block."""
+    out = bytearray()
+    i = 0
+    while i < len(src):
+        token = src[i]
+        i += 1
+        lit = token >> 4
+        if lit == 15:
+            while True:
+                b = src[i]
+                i += 1
+                lit += b
+                if b != 255:
+                    break
+        out += src[i:i + lit]
+        i += lit
+        if i >= len(src):
+            break
+        off = src[i] | (src[i + 1] << 8)
+        i += 2
+        mlen = token & 15
+        if mlen == 15:
+            while True:
+                b = src[i]
+                i += 1
+                mlen += b
+                if b != 255:
+                    break
+        mlen += MIN_MATCH
+        for _ in range(mlen):
+            out.append(out[-off])
+    if len(out) != size:
+        raise ValueError("decoded %d bytes, expected %d" % (len(out), size))
+    return bytes(out)
+
+
+def pack(raw, block_size):
+    out = bytearray(MAGIC)
+    out += struct.pack("<IHH", len(raw), block_size, crc16_ccitt(raw))
+    for off in range(0, len(raw), block_size):
+        block = raw[off:off + block_size]
+        comp = lz4_block_compress(block)
+        if lz4_block_decompress(comp, len(block)) != block:
+            raise RuntimeError("block at 0x%X failed round trip" % off)
+        if len(comp) < len(block):
+            out += struct.pack("<H", len(comp)) + comp
+        else:
+            out += struct.pack("<H", len(block) | STORED) + block
+    return bytes(out)
+
+
+def read_input(path):
+    if path.endswith(".h") or path.endswith(".c"):
+        text = open(path).read()
+        body = text[text.index("{") + 1:text.rindex("}")]
+        return bytes(int(x, 16) for x in re.findall(r"0x([0-9A-Fa-f]{2})", body))
+    return open(path, "rb").read()
+
+
+def write_header(path, name, packed, raw_size):
+    guard = name + "_H"
+    with open(path, "w") as f:
+        f.write("#ifndef %s\n#define %s\n\n#include <stdint.h>\n\n" % (guard, guard))
+        f.write("/* Generated by Tools/bitpack.py from a %d byte bitstream, do not edit */\n" % raw_size)
+        f.write("#define %s_SIZE %d\n" % (name, len(packed)))
+        f.write("const uint8_t %s[%d] = {\n" % (name, len(packed)))
+        for i in range(0, len(packed), 12):
+            f.write(", ".join("0x%02X" % b for b in packed[i:i + 12]))
+            f.write(",\n" if i + 12 < len(packed) else "\n")
+        f.write("\n};\n\n#endif\n")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[1])
+    ap.add_argument("input", help=".bit image or C header holding the raw array")
+    ap.add_argument("output", help="C header to generate")
+    ap.add_argument("--name", default="bitstream_lz4", help="array name")
+    ap.add_argument("--block", type=int, default=4096, help="block size in bytes")
+    args = ap.parse_args()
+
+    if not 0 < args.block < STORED:
+        sys.exit("block size must be below %d" % STORED)
+
+    raw = read_input(args.input)
+    packed = pack(raw, args.block)
+    write_header(args.output, args.name, packed, len(raw))
+    print("%s: %d -> %d bytes (%.1f%%), crc16 0x%04X" % (
+        args.output, len(raw), len(packed), 100.0 * len(packed) / len(raw), crc16_ccitt(raw)))
+
+
+if __name__ == "__main__":
+    main()
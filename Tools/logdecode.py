@@ -0,0 +1,221 @@
+#!/usr/bin/env python3
+"""
+logdecode.py - decode the H743 debug UART stream (printf text mixed with
+LOGB() binary records) using the firmware ELF. Only needed for firmware
+built with -DLOGGING_BINARY=1; the default build logs plain text.
+
+Binary records (little endian, see Core/Inc/logging.h):
+
+    0xA5  uint8 nargs  uint16 format offset in .log_fmt  uint64 time  nargs x uint32
+    0xA6  uint8 len    uint32 label address              uint64 time  len bytes (hex dump)
+    0xA7  uint32 timestamp clock in Hz
+    0xA9  uint64 time of the text that follows
+
+Times are DWT cycle counts; each output line is prefixed with the time in
+seconds, using the clock from the last 0xA7 record (or --hz until one
+arrives). Everything else is passed through as text. Format strings are read from the
+non-loaded .log_fmt section; %s arguments and hex dump labels are resolved
+from the loadable sections of the same ELF.
+
+Usage:
+    logdecode.py firmware.elf /dev/ttyACM0 [--baud 115200]
+    logdecode.py firmware.elf capture.bin
+    logdecode.py firmware.elf -            (read stdin)
+    logdecode.py firmware.elf capture.bin --hz 400000000
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+SYNC = 0xA5
+SYNC_HEX = 0xA6
+SYNC_TIMEBASE = 0xA7
+SYNC_TIME = 0xA9
+SYNCS = (SYNC, SYNC_HEX, SYNC_TIMEBASE, SYNC_TIME)
+
+TIME_SIZE = 8
+DEFAULT_HZ = 480000000
+
+SHT_NOBITS = 8
+SHF_ALLOC = 0x2
+
+FMT_SPEC = re.compile(r"%([-+ #0]*)(\d+|\*)?(?:\.(\d+))?(hh|h|ll|l|z|j|t)?([diouxXcsp%])")
+
+
+class Elf:
+    """Minimal ELF32 little-endian section reader."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            data = f.read()
+        if data[:4] != b"\x7fELF" or data[4] != 1 or data[5] != 1:
+            raise ValueError("%s: not a little-endian ELF32 file" % path)
+
+        shoff, = struct.unpack_from("<I", data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x2E)
+        headers = [struct.unpack_from("<IIIIIIIIII", data, shoff + i * shentsize) for i in range(shnum)]
+        strtab = headers[shstrndx]
+        names = data[strtab[4]:strtab[4] + strtab[5]]
+
+        self.fmt = b""
+        self.alloc = []
+        for name, typ, flags, addr, offset, size, *_ in headers:
+            sname = names[name:names.index(b"\0", name)].decode()
+            body = b"" if typ == SHT_NOBITS else data[offset:offset + size]
+            if sname == ".log_fmt":
+                self.fmt = body
+            elif flags & SHF_ALLOC and body:
+                self.alloc.append((addr, body))
+        if not self.fmt:
+            print("warning: no .log_fmt section in ELF", file=sys.stderr)
+
+    def format_string(self, offset):
+        end = self.fmt.find(b"\0", offset)
+        if offset >= len(self.fmt) or end < 0:
+            return None
+        return self.fmt[offset:end].decode(errors="replace")
+
+    def c_string(self, addr):
+        for base, body in self.alloc:
+            if base <= addr < base + len(body):
+                off = addr - base
+                end = body.find(b"\0", off)
+                return body[off:end if end >= 0 else len(body)].decode(errors="replace")
+        return "<0x%08x>" % addr
+
+
+def c_format(elf, fmt, args):
+    """Render a printf format with raw 32-bit arguments."""
+    it = iter(args)
+
+    def repl(m):
+        flags, width, prec, _length, conv = m.groups()
+        if conv == "%":
+            return "%"
+        if width == "*":
+            width = str(next(it, 0))
+        spec = "%" + flags + (width or "") + ("." + prec if prec else "")
+        value = next(it, 0)
+        if conv in "di":
+            if value & 0x80000000:
+                value -= 1 << 32
+            return (spec + "d") % value
+        if conv == "c":
+            return (spec + "c") % chr(value & 0xFF)
+        if conv == "s":
+            return (spec + "s") % elf.c_string(value)
+        if conv == "p":
+            return "0x%08x" % value
+        return (spec + conv) % value
+
+    return FMT_SPEC.sub(repl, fmt)
+
+
+class Decoder:
+    def __init__(self, elf, out, hz=DEFAULT_HZ):
+        self.elf = elf
+        self.out = out
+        self.buf = bytearray()
+        self.hz = hz
+        self.time = None
+        self.line_start = True
+
+    def write(self, text):
+        """Write text, stamping each new line with the current record time."""
+        for part in text.splitlines(keepends=True):
+            if self.line_start and self.time is not None:
+                self.out.write("[%12.6f] " % (self.time / self.hz))
+            self.out.write(part)
+            self.line_start = part.endswith("\n")
+
+    def feed(self, data):
+        self.buf += data
+        while self.buf:
+            b = self.buf[0]
+            if b == SYNC:
+                if len(self.buf) < 4:
+                    return
+                nargs = self.buf[1]
+                need = 4 + TIME_SIZE + 4 * nargs
+                if len(self.buf) < need:
+                    return
+                offset, self.time = struct.unpack_from("<HQ", self.buf, 2)
+                args = struct.unpack_from("<%dI" % nargs, self.buf, 4 + TIME_SIZE)
+                fmt = self.elf.format_string(offset)
+                if fmt is None:
+                    self.write("<unknown format 0x%04x %s>\n" % (offset, " ".join("%x" % a for a in args)))
+                else:
+                    self.write(c_format(self.elf, fmt, args))
+                del self.buf[:need]
+            elif b == SYNC_HEX:
+                if len(self.buf) < 6:
+                    return
+                need = 6 + TIME_SIZE + self.buf[1]
+                if len(self.buf) < need:
+                    return
+                label, self.time = struct.unpack_from("<IQ", self.buf, 2)
+                payload = self.buf[6 + TIME_SIZE:need]
+                prefix = (self.elf.c_string(label) + ": ") if label else ""
+                self.write(prefix + "".join("%02X " % x for x in payload) + "\r\n")
+                del self.buf[:need]
+            elif b == SYNC_TIMEBASE:
+                if len(self.buf) < 5:
+                    return
+                hz, = struct.unpack_from("<I", self.buf, 1)
+                if hz:
+                    self.hz = hz
+                del self.buf[:5]
+            elif b == SYNC_TIME:
+                if len(self.buf) < 1 + TIME_SIZE:
+                    return
+                self.time, = struct.unpack_from("<Q", self.buf, 1)
+                del self.buf[:1 + TIME_SIZE]
+            else:
+                end = 0
+                while end < len(self.buf) and self.buf[end] not in SYNCS:
+                    end += 1
+                self.write(self.buf[:end].decode("latin-1"))
+                del self.buf[:end]
+        self.out.flush()
+
+
+def open_input(path, baud):
+    if path == "-":
+        return sys.stdin.buffer, lambda f: f.read1(4096) if hasattr(f, "read1") else f.read(4096)
+    if path.startswith("/dev/") or path.upper().startswith("COM"):
+        import serial  # pyserial
+        port = serial.Serial(path, baud, timeout=0.1)
+        return port, lambda f: f.read(f.in_waiting or 1)
+    return open(path, "rb"), lambda f: f.read(4096)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("elf", help="firmware ELF (with the .log_fmt section)")
+    ap.add_argument("input", nargs="?", default="-", help="serial port, capture file or - for stdin")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--hz", type=int, default=DEFAULT_HZ,
+                    help="timestamp clock until the firmware reports one (default %(default)s)")
+    args = ap.parse_args()
+
+    elf = Elf(args.elf)
+    src, read = open_input(args.input, args.baud)
+    dec = Decoder(elf, sys.stdout, args.hz)
+    is_file = not (args.input.startswith("/dev/") or args.input.upper().startswith("COM"))
+    try:
+        while True:
+            data = read(src)
+            if not data:
+                if is_file:
+                    break
+                continue
+            dec.feed(data)
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
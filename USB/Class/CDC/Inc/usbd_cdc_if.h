@@ -31,6 +31,7 @@
 #include "usbd_cdc.h"
 
 /* USER CODE BEGIN INCLUDE */
+#include "fpga_source.h"
 
 /* USER CODE END INCLUDE */
 
@@ -52,6 +53,13 @@
 #define APP_RX_DATA_SIZE  2048
 #define APP_TX_DATA_SIZE  2048
 /* USER CODE BEGIN EXPORTED_DEFINES */
+/*
+ * Bitstream upload: host sends "XLNK" + uint32 LE image length + uint16 LE
+ * CRC16-CCITT (FALSE) of the image, then the raw image
+ */
+#define CDC_UPLOAD_MAGIC          "XLNK"
+#define CDC_UPLOAD_HDR_SIZE       10U
+#define CDC_UPLOAD_TIMEOUT_MS     2000U
 
 /* USER CODE END EXPORTED_DEFINES */
 
@@ -109,6 +117,8 @@ extern USBD_CDC_ItfTypeDef USBD_Interface_fops_FS;
 uint8_t CDC_Transmit_FS(uint8_t* Buf, uint16_t Len);
 
 /* USER CODE BEGIN EXPORTED_FUNCTIONS */
+fpga_source_t *CDC_Upload_Request(void);
+void CDC_Upload_Complete(int status, uint32_t elapsed_ms);
 
 /* USER CODE END EXPORTED_FUNCTIONS */
 
@@ -22,6 +22,10 @@
 #include "usbd_cdc_if.h"
 
 /* USER CODE BEGIN INCLUDE */
+#include "main.h"
+#include "logging.h"
+#include <stdio.h>
+#include <string.h>
 
 /* USER CODE END INCLUDE */
 
@@ -49,6 +53,27 @@
   */
 
 /* USER CODE BEGIN PRIVATE_TYPES */
+/*
+ * Bitstream upload pipeline. OUT packets are gathered into two buffers:
+ * while the programmer sends one over I2C, USB fills the other. When both
+ * are owned by the programmer the OUT endpoint is simply not re-armed, so
+ * the host is NAKed until a buffer is released.
+ */
+typedef struct {
+  fpga_source_t base;
+  uint8_t *buf[2];
+  volatile uint32_t fill[2];
+  volatile uint8_t ready[2];      /* Full, waiting for or owned by the programmer */
+  volatile uint8_t rx_idx;        /* Buffer USB is filling */
+  uint8_t acq_idx;                /* Next buffer handed to the programmer */
+  uint8_t rel_idx;                /* Next buffer the programmer releases */
+  uint8_t outstanding;            /* Buffers handed out and not yet released */
+  volatile uint32_t received;
+  volatile uint32_t last_rx_tick;
+  volatile bool active;
+  volatile bool requested;
+  volatile bool stalled;          /* OUT endpoint left un-armed (NAK) */
+} cdc_upload_t;
 
 /* USER CODE END PRIVATE_TYPES */
 
@@ -62,6 +87,7 @@
   */
 
 /* USER CODE BEGIN PRIVATE_DEFINES */
+#define CDC_LOG_MAX_BURST   512U
 /* USER CODE END PRIVATE_DEFINES */
 
 /**
@@ -94,6 +120,22 @@ uint8_t UserRxBufferFS[APP_RX_DATA_SIZE];
 uint8_t UserTxBufferFS[APP_TX_DATA_SIZE];
 
 /* USER CODE BEGIN PRIVATE_VARIABLES */
+static uint8_t UserRxBufferFS2[APP_RX_DATA_SIZE];
+static cdc_upload_t cdc_upload;
+
+static int CDC_Log_Send(log_sink_t *sink, const uint8_t *data, size_t len);
+
+/* Log output while the host holds DTR (terminal open), except during uploads */
+static log_sink_t cdc_log_sink = {
+  .name = "cdc",
+  .send = CDC_Log_Send,
+  .max_burst = CDC_LOG_MAX_BURST,
+};
+static volatile bool cdc_dtr;
+
+/* Upload result waiting for the IN endpoint (0 = none) */
+static char cdc_reply[48];
+static volatile uint16_t cdc_reply_len;
 
 /* USER CODE END PRIVATE_VARIABLES */
 
@@ -128,6 +170,8 @@ static int8_t CDC_Receive_FS(uint8_t* pbuf, uint32_t *Len);
 static int8_t CDC_TransmitCplt_FS(uint8_t *pbuf, uint32_t *Len, uint8_t epnum);
 
 /* USER CODE BEGIN PRIVATE_FUNCTIONS_DECLARATION */
+static bool CDC_Upload_Receive(uint8_t* Buf, uint32_t Len);
+static void CDC_Upload_Arm(uint8_t *Buf);
 
 /* USER CODE END PRIVATE_FUNCTIONS_DECLARATION */
 
@@ -166,6 +210,10 @@ static int8_t CDC_Init_FS(void)
 static int8_t CDC_DeInit_FS(void)
 {
   /* USER CODE BEGIN 4 */
+  /* A transfer cut off by the disconnect never completes; release its span */
+  cdc_dtr = false;
+  logging_sink_detach(&cdc_log_sink);
+  logging_sink_error(&cdc_log_sink);
   return (USBD_OK);
   /* USER CODE END 4 */
 }
@@ -228,7 +276,19 @@ static int8_t CDC_Control_FS(uint8_t cmd, uint8_t* pbuf, uint16_t length)
     break;
 
     case CDC_SET_CONTROL_LINE_STATE:
-
+    {
+      USBD_SetupReqTypedef *req = (USBD_SetupReqTypedef *)pbuf;
+
+      cdc_dtr = (req->wValue & 0x0001U) != 0;
+      if (cdc_dtr && !cdc_upload.active)
+      {
+        logging_sink_attach(&cdc_log_sink);
+      }
+      else
+      {
+        logging_sink_detach(&cdc_log_sink);
+      }
+    }
     break;
 
     case CDC_SEND_BREAK:
@@ -261,6 +321,10 @@ static int8_t CDC_Control_FS(uint8_t cmd, uint8_t* pbuf, uint16_t length)
 static int8_t CDC_Receive_FS(uint8_t* Buf, uint32_t *Len)
 {
   /* USER CODE BEGIN 6 */
+  if (CDC_Upload_Receive(Buf, *Len))
+  {
+    return (USBD_OK);
+  }
   USBD_CDC_SetRxBuffer(&hUsbDeviceFS, &Buf[0]);
   USBD_CDC_ReceivePacket(&hUsbDeviceFS);
   return (USBD_OK);
@@ -311,12 +375,191 @@ static int8_t CDC_TransmitCplt_FS(uint8_t *Buf, uint32_t *Len, uint8_t epnum)
   UNUSED(Buf);
   UNUSED(Len);
   UNUSED(epnum);
+  if (cdc_reply_len != 0 && CDC_Transmit_FS((uint8_t *)cdc_reply, cdc_reply_len) == USBD_OK)
+  {
+    cdc_reply_len = 0;
+  }
+  logging_sink_done(&cdc_log_sink);
   /* USER CODE END 13 */
   return result;
 }
 
 /* USER CODE BEGIN PRIVATE_FUNCTIONS_IMPLEMENTATION */
 
+static int CDC_Log_Send(log_sink_t *sink, const uint8_t *data, size_t len)
+{
+  UNUSED(sink);
+  return (CDC_Transmit_FS((uint8_t *)data, (uint16_t)len) == USBD_OK) ? HAL_OK : HAL_BUSY;
+}
+
+static void CDC_Upload_Arm(uint8_t *Buf)
+{
+  USBD_CDC_SetRxBuffer(&hUsbDeviceFS, Buf);
+  USBD_CDC_ReceivePacket(&hUsbDeviceFS);
+}
+
+/**
+  * @brief  Route OUT packets to the bitstream upload pipeline.
+  * @note   Runs in USB interrupt context.
+  * @retval true if the packet was consumed by the upload (endpoint handled)
+  */
+static bool CDC_Upload_Receive(uint8_t* Buf, uint32_t Len)
+{
+  cdc_upload_t *up = &cdc_upload;
+  uint8_t idx;
+
+  if (!up->active)
+  {
+    uint32_t total;
+    uint16_t crc;
+
+    if (Len < CDC_UPLOAD_HDR_SIZE || memcmp(Buf, CDC_UPLOAD_MAGIC, 4) != 0)
+    {
+      return false;
+    }
+    total = (uint32_t)Buf[4] | ((uint32_t)Buf[5] << 8) | ((uint32_t)Buf[6] << 16) | ((uint32_t)Buf[7] << 24);
+    crc = (uint16_t)(Buf[8] | (Buf[9] << 8));
+    if (total == 0 || total > MAX_BITSTREAM_SIZE)
+    {
+      return false;
+    }
+
+    /* The upload protocol owns the port until CDC_Upload_Complete() */
+    logging_sink_detach(&cdc_log_sink);
+
+    memset(up, 0, sizeof(*up));
+    up->buf[0] = UserRxBufferFS;
+    up->buf[1] = UserRxBufferFS2;
+    up->base.total = total;
+    /* Checked before the last chunk goes out, so a corrupt image is never activated */
+    up->base.has_crc = true;
+    up->base.crc16 = crc;
+    up->last_rx_tick = HAL_GetTick();
+    up->active = true;
+    up->requested = true;
+
+    /* Payload bytes sharing the header packet */
+    Len -= CDC_UPLOAD_HDR_SIZE;
+    if (Len > 0)
+    {
+      memmove(up->buf[0], &Buf[CDC_UPLOAD_HDR_SIZE], Len);
+    }
+  }
+
+  idx = up->rx_idx;
+  if (up->received + Len > up->base.total)
+  {
+    Len = up->base.total - up->received;
+  }
+  up->fill[idx] += Len;
+  up->received += Len;
+  up->last_rx_tick = HAL_GetTick();
+
+  if (up->received == up->base.total ||
+      up->fill[idx] + CDC_DATA_FS_OUT_PACKET_SIZE > APP_RX_DATA_SIZE)
+  {
+    /* Buffer complete, hand it over and continue in the other one */
+    up->ready[idx] = 1;
+    idx ^= 1;
+    up->rx_idx = idx;
+
+    if (up->received == up->base.total || up->ready[idx])
+    {
+      /* Image complete or pipeline full: NAK until a buffer is released */
+      up->stalled = true;
+      return true;
+    }
+  }
+
+  CDC_Upload_Arm(&up->buf[idx][up->fill[idx]]);
+  return true;
+}
+
+static int CDC_Upload_Acquire(fpga_source_t *src, const uint8_t **chunk)
+{
+  cdc_upload_t *up = (cdc_upload_t *)src;
+  uint8_t idx = up->acq_idx;
+
+  if (up->outstanding == 2 || !up->ready[idx])
+  {
+    /* Only a host that was free to send can time out, not one we are NAKing */
+    if (up->outstanding < 2 && !up->stalled && HAL_GetTick() - up->last_rx_tick > CDC_UPLOAD_TIMEOUT_MS)
+    {
+      return -1;
+    }
+    return 0;
+  }
+
+  *chunk = up->buf[idx];
+  up->acq_idx ^= 1;
+  up->outstanding++;
+  return (int)up->fill[idx];
+}
+
+static void CDC_Upload_Release(fpga_source_t *src)
+{
+  cdc_upload_t *up = (cdc_upload_t *)src;
+  uint8_t idx = up->rel_idx;
+
+  HAL_NVIC_DisableIRQ(OTG_FS_IRQn);
+  up->fill[idx] = 0;
+  up->ready[idx] = 0;
+  up->rel_idx ^= 1;
+  up->outstanding--;
+  if (up->stalled && up->received < up->base.total && up->rx_idx == idx)
+  {
+    /* Pipeline has room again: stop NAKing the host, its timeout starts now */
+    up->stalled = false;
+    up->last_rx_tick = HAL_GetTick();
+    CDC_Upload_Arm(up->buf[idx]);
+  }
+  HAL_NVIC_EnableIRQ(OTG_FS_IRQn);
+}
+
+/**
+  * @brief  Returns the upload source once the host started an upload.
+  * @note   Called from the main loop, which hands it to fpga_configure_start().
+  */
+fpga_source_t *CDC_Upload_Request(void)
+{
+  if (!cdc_upload.requested)
+  {
+    return NULL;
+  }
+  cdc_upload.requested = false;
+  cdc_upload.base.acquire = CDC_Upload_Acquire;
+  cdc_upload.base.release = CDC_Upload_Release;
+  return &cdc_upload.base;
+}
+
+/**
+  * @brief  Ends the upload, reports the result to the host and resumes
+  *         normal reception.
+  */
+void CDC_Upload_Complete(int status, uint32_t elapsed_ms)
+{
+  int len;
+
+  HAL_NVIC_DisableIRQ(OTG_FS_IRQn);
+  cdc_upload.active = false;
+  if (cdc_upload.stalled)
+  {
+    cdc_upload.stalled = false;
+    CDC_Upload_Arm(UserRxBufferFS);
+  }
+
+  len = snprintf(cdc_reply, sizeof(cdc_reply), "XLNK %s %lu bytes %lu ms\r\n", (status == 0) ? "OK" : "FAIL",
+                 (unsigned long)cdc_upload.received, (unsigned long)elapsed_ms);
+  /* IN endpoint busy: CDC_TransmitCplt_FS() sends it next */
+  cdc_reply_len = (CDC_Transmit_FS((uint8_t *)cdc_reply, (uint16_t)len) == USBD_OK) ? 0 : (uint16_t)len;
+  HAL_NVIC_EnableIRQ(OTG_FS_IRQn);
+
+  if (cdc_dtr)
+  {
+    logging_sink_attach(&cdc_log_sink);
+  }
+}
+
 /* USER CODE END PRIVATE_FUNCTIONS_IMPLEMENTATION */
 
 /**
@@ -109,6 +109,10 @@ void HAL_PCD_MspInit(PCD_HandleTypeDef* hpcd)
     __HAL_RCC_USB_OTG_FS_CLK_ENABLE();
     /* USER CODE BEGIN USB_OTG_FS_MspInit 1 */
 
+    /* USB_OTG_FS interrupt Init */
+    HAL_NVIC_SetPriority(OTG_FS_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(OTG_FS_IRQn);
+
     /* USER CODE END USB_OTG_FS_MspInit 1 */
 
   }